@@ -6,6 +6,7 @@
                 'src/addon.cc',
                 'src/wpi.cc',
                 'src/wiringPi.cc',
+                'src/wiringPiI2C.cc',
                 'src/wiringPiSPI.cc',
                 'src/wiringSerial.cc'
             ],
@@ -62,6 +62,63 @@ declare module 'wiringpi-sx' {
      */
     export function digitalRead (pin: number): number;
 
+    /**
+     * @description Read 8 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalRead8 (pin: number): number;
+
+    /**
+     * @description Read 16 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalRead16 (pin: number): number;
+
+    /**
+     * @description Read 32 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalRead32 (pin: number): number;
+
+    /**
+     * @description Set 8 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalWrite8 (pin: number, value: number): void;
+
+    /**
+     * @description Set 16 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalWrite16 (pin: number, value: number): void;
+
+    /**
+     * @description Set 32 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function digitalWrite32 (pin: number, value: number): void;
+
     /**
      * @description Set the freuency on a GPIO clock pin.
      *     Don't forget to set correct pin mode: pinMode(7, GPIO_CLOCK)
@@ -72,6 +129,147 @@ declare module 'wiringpi-sx' {
      */
     export function gpioClockSet (pin: number, frequency: number): void;
 
+    // *************************************************************************************************
+    // Hardware PWM
+    // *************************************************************************************************
+
+    /**
+     * @description Select the native balanced mode or the standard mark:space mode for both PWM channels.
+     * @param {number} mode use the constants PWM_MODE_BAL or PWM_MODE_MS
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function pwmSetMode (mode: number): void;
+
+    /**
+     * @description Set the range register of both PWM channels to the same value (default 1024).
+     * @param {number} range value greater than 0
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function pwmSetRange (range: number): void;
+
+    /**
+     * @description Set the divisor of the PWM clock (19.2MHz / divisor), shared by both channels.
+     * @param {number} divisor use values between 2 and 4095
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function pwmSetClock (divisor: number): void;
+
+    /**
+     * @description Write the value to the PWM register for the given pin, which must be in PWM_OUTPUT mode.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} value duty value between 0 and the range set for the channel
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    export function pwmWrite (pin: number, value: number): void;
+
+    /**
+     * @description Set the mode and polarity of one hardware PWM channel and enable it.
+     *     The other channel is not changed.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} mode use the constants PWM_MODE_BAL or PWM_MODE_MS
+     * @param {boolean} invert true to reverse the output polarity
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmChannelMode (channel: 0 | 1, mode: number, invert: boolean): void;
+
+    /**
+     * @description Set the range register of one hardware PWM channel.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} range value greater than 0
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmChannelRange (channel: 0 | 1, range: number): void;
+
+    /**
+     * @description Set the range of one hardware PWM channel and compute the PWM clock divisor for the given frequency.
+     *     Both channels share the PWM clock, so the frequency of the other channel changes too.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} frequency PWM frequency in Hz
+     * @param {number} range value greater than 0, the duty resolution of the channel
+     * @returns {number} the frequency in Hz actually achieved
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmChannelFrequency (channel: 0 | 1, frequency: number, range: number): number;
+
+    /**
+     * @description Set the duty value of one hardware PWM channel.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} value duty value between 0 and the range of the channel
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmChannelWrite (channel: 0 | 1, value: number): void;
+
+    /**
+     * @description Set the duty values of both hardware PWM channels with back-to-back register writes.
+     * @param {number} value0 duty value of channel 0
+     * @param {number} value1 duty value of channel 1
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmWriteChannels (value0: number, value1: number): void;
+
+    /**
+     * @description Feed one hardware PWM channel from the PWM FIFO (true) or from its data register (false).
+     *     The FIFO is cleared when enabled.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {boolean} enable true to use the FIFO
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmChannelFifo (channel: 0 | 1, enable: boolean): void;
+
+    /**
+     * @description Write as many 32-bit samples (native byte order) from the buffer into the PWM FIFO as fit.
+     *     This does not block, use the returned count to continue with the rest of the samples later.
+     * @param {Buffer} samples buffer with 32-bit sample values, length must be a multiple of 4
+     * @returns {number} number of samples written
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pwmFifoWrite (samples: Buffer): number;
+
+
+    // *************************************************************************************************
+    // Interrupts
+    // *************************************************************************************************
+
+    /**
+     * @description Start counting edges and measuring the periods of the signal on an input pin.
+     *     Counting runs natively on the interrupt thread of the pin, use wiringPiPulseRead to fetch the aggregates.
+     *     This function needs the gpio program to be installed (see wiringPiISR).
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} mode use INT_EDGE_RISING, INT_EDGE_FALLING or INT_EDGE_BOTH (needed for the duty cycle)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiPulseMeter (pin: number, mode: number): void;
+
+    /**
+     * @description Read the aggregates of the pulse meter started with wiringPiPulseMeter.
+     *     Times are in microseconds, frequency is in Hz and duty is a value between 0 and 1 (only with INT_EDGE_BOTH, otherwise 0).
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {boolean} reset true to restart the aggregation after reading
+     * @returns {object} { edges, periods, periodMin, periodMax, periodAvg, frequency, duty }
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiPulseRead (pin: number, reset: boolean): { edges: number, periods: number, periodMin: number, periodMax: number, periodAvg: number, frequency: number, duty: number };
+
+    /**
+     * @description Set the glitch filter and the debounce time applied to the edges of a pin before they are counted or dispatched.
+     *     Pulses shorter than glitchUs are dropped, and the line must be quiet for debounceUs before an edge is accepted.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} glitchUs minimum pulse width in microseconds (0 to 1000000, 0 disables the filter)
+     * @param {number} debounceUs quiet time in microseconds (0 to 1000000, 0 disables debouncing)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiISRFilter (pin: number, glitchUs: number, debounceUs: number): void;
+
+    /**
+     * @description Read how many edges of a pin were accepted, and how many were suppressed as bounces or glitches.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {boolean} reset true to clear the counters after reading
+     * @returns {object} { accepted, bounces, glitches }
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiISRFilterStats (pin: number, reset: boolean): { accepted: number, bounces: number, glitches: number };
+
+
     /**
      * @description Initialize the desired SPI channel with CPOL=0 and CPHA=0.
      * @param {number} channel use value 0 or 1 to select the SPI channel
@@ -109,6 +307,127 @@ declare module 'wiringpi-sx' {
      */
     export function wiringPiSPIDataRW (channel: 0 | 1, data: Buffer): number;
 
+    /**
+     * @description Run a list of segments as one SPI transaction, submitted with a single ioctl.
+     *     Chip-select stays asserted between the segments unless a segment sets csChange.
+     *     Without tx zeros are clocked out, without rx the received data is discarded,
+     *     len is only needed when neither buffer is given. tx and rx may be the same Buffer.
+     * @param {number} channel use value 0 or 1 to select the SPI channel
+     * @param {Array} segments array of up to 64 segment objects
+     * @returns {number} number of transferred bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPITransfer (channel: 0 | 1, segments: WiringPiSPISegment []): number;
+
+    export interface WiringPiSPISegment {
+        tx?: Buffer;
+        rx?: Buffer;
+        len?: number;
+        speed?: number;
+        delay?: number;
+        csChange?: boolean;
+        bits?: number;
+    }
+
+    /**
+     * @description Return the largest message the spidev driver accepts (module parameter bufsiz).
+     *     Larger transfers are split automatically, keeping chip-select asserted.
+     * @returns {number} size in bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIBufferSize (): number;
+
+    /**
+     * @description Open /dev/spidev<bus>.<cs> with 8 bits per word and no delay, use the returned handle
+     *     with the wiringPiSPIHandle... functions. Each handle keeps its own settings.
+     * @param {number} bus number of the SPI bus (0 for /dev/spidev0.x, 1 for /dev/spidev1.x, ...)
+     * @param {number} cs chip-select of the device on the bus
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} mode use 0, 1, 2 or 3. Bit 0 is CPOL, bit 1 is CPHA.
+     * @returns {number} handle of the SPI device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIOpen (bus: number, cs: number, speed: number, mode: 0 | 1 | 2 | 3): number;
+
+    /**
+     * @description Change the settings of an SPI handle.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} mode use 0, 1, 2 or 3. Bit 0 is CPOL, bit 1 is CPHA.
+     * @param {number} bpw bits per word, 1 to 32
+     * @param {number} delay delay in microseconds after each transfer, 0 to 65535
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIConfig (handle: number, speed: number, mode: 0 | 1 | 2 | 3, bpw: number, delay: number): void;
+
+    /**
+     * @description Write and Read a block of data on an SPI handle.
+     *     Note the data ia being read into the transmit buffer, so will overwrite it!
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {Buffer} data binary data stream to write and read data.
+     * @returns {number} number of transferred bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIHandleRW (handle: number, data: Buffer): number;
+
+    /**
+     * @description Run a list of segments as one SPI transaction on an SPI handle, see wiringPiSPITransfer.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {Array} segments array of up to 64 segment objects
+     * @returns {number} number of transferred bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIHandleTransfer (handle: number, segments: WiringPiSPISegment []): number;
+
+    /**
+     * @description Close the device of an SPI handle and release the handle.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiSPIHandleClose (handle: number): void;
+
+    /**
+     * @description Start continuous sampling of an MCP3004/3008 (10 bit) or MCP3204/3208 (12 bit) ADC
+     *     on a dedicated thread. Each block holds scans rounds over the channels in channelMask,
+     *     the conversions are submitted as multi-segment SPI transactions.
+     *     Fetch the blocks with mcp3004StreamRead.
+     * @param {number} channel use value 0 or 1 to select the SPI channel
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} bits 10 for MCP3004/3008, 12 for MCP3204/3208
+     * @param {number} channelMask bit n set samples ADC channel n (1 to 255)
+     * @param {number} scans number of rounds over the channels per block
+     * @returns {number} stream number
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp3004StreamStart (channel: 0 | 1, speed: number, bits: 10 | 12, channelMask: number, scans: number): number;
+
+    /**
+     * @description Wait for the next completed block of a stream, on a worker thread so the event loop
+     *     carries on meanwhile. The samples are returned as Buffer of 16 bit values (host byte order,
+     *     use a Uint16Array view), interleaved by channel.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @param {number} timeout maximum waiting time in milliseconds, -1 waits for ever
+     * @returns {Promise} resolves to { timestamp, duration, sequence, channels, scans, samples } or null on timeout
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp3004StreamRead (stream: number, timeout: number): Promise<{ timestamp: number, duration: number, sequence: number, channels: number, scans: number, samples: Buffer } | null>;
+
+    /**
+     * @description Number of blocks replaced before mcp3004StreamRead got to them.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @returns {number} number of lost blocks
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp3004StreamOverruns (stream: number): number;
+
+    /**
+     * @description Stop the sampling thread and release the stream. Pending reads are rejected,
+     *     the stream is released once the last of them has settled.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp3004StreamStop (stream: number): void;
+
     /**
      * @description This closes opened SPI file descriptor.
      * @param {number} fd file-descriptor returned either from wiringPiSPISetup or wiringPiSPISetupMode
@@ -116,6 +435,295 @@ declare module 'wiringpi-sx' {
      */
     export function wiringPiSPIClose (fd: number): void;
 
+    /**
+     * @description Set up a MCP23S17 GPIO expander on a SPI channel. Pins pinBase to pinBase + 15
+     *     are its I/O pins; digitalRead16/digitalWrite16 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} channel SPI channel (0 or 1)
+     * @param {number} devId hardware address of the device (0 to 7)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp23s17Setup (pinBase: number, channel: number, devId: number): void;
+
+    /**
+     * @description Set up a MCP23S08 GPIO expander on a SPI channel. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} channel SPI channel (0 or 1)
+     * @param {number} devId hardware address of the device (0 to 7)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp23s08Setup (pinBase: number, channel: number, devId: number): void;
+
+
+    // *************************************************************************************************
+    // I2C
+    // *************************************************************************************************
+
+    /**
+     * @description Open the I2C device of the Pi (/dev/i2c-0 or /dev/i2c-1 depending on the board) for the device with the given address.
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} file-descriptor of the I2C device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CSetup (devId: number): number;
+
+    /**
+     * @description Open the given I2C bus device for the device with the given address.
+     *     Example: wiringPiI2CSetupInterface('/dev/i2c-3', 0x48);
+     * @param {string} device name of the I2C bus device
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} file-descriptor of the I2C device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CSetupInterface (device: string, devId: number): number;
+
+    /**
+     * @description Simple device read, some devices present data when you read them without having to do any register transactions.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @returns {number} received byte
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CRead (fd: number): number;
+
+    /**
+     * @description Read an 8-bit value from the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @returns {number} register value
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CReadReg8 (fd: number, reg: number): number;
+
+    /**
+     * @description Read a 16-bit value (SMBus word, low byte first) from the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @returns {number} register value
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CReadReg16 (fd: number, reg: number): number;
+
+    /**
+     * @description Simple device write, some devices accept data this way without needing to access any internal registers.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} data byte to write (0 to 255)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CWrite (fd: number, data: number): void;
+
+    /**
+     * @description Write an 8-bit value to the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @param {number} data value to write (0 to 255)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CWriteReg8 (fd: number, reg: number, data: number): void;
+
+    /**
+     * @description Write a 16-bit value (SMBus word, low byte first) to the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @param {number} data value to write (0 to 65535)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CWriteReg16 (fd: number, reg: number, data: number): void;
+
+    /**
+     * @description Read a block of consecutive registers in one transaction (register write, repeated start, read).
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {number} reg first register number (0 to 255)
+     * @param {number} length number of bytes to read (1 to 8192)
+     * @returns {Buffer} received data
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CReadBlock (fd: number, reg: number, length: number): Buffer;
+
+    /**
+     * @description Write a block of consecutive registers in one transaction.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {number} reg first register number (0 to 255)
+     * @param {Buffer} data bytes to write (1 to 256)
+     * @returns {number} number of bytes written
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CWriteBlock (fd: number, reg: number, data: Buffer): number;
+
+    /**
+     * @description Run a list of messages as one combined I2C transaction (I2C_RDWR): one start condition,
+     *     a repeated start between the messages and one stop condition at the end.
+     *     Each message is an object { addr?: number, read?: boolean, nostart?: boolean, buf: Buffer }.
+     *     Without addr the message goes to the device of fd. Read messages fill their Buffer.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {Array} messages array of up to 42 message objects
+     * @returns {number} number of transferred messages
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CTransfer (fd: number, messages: WiringPiI2CMessage []): number;
+
+    /**
+     * @description Get a handle for the device with the given address on /dev/i2c-<bus>. All handles on a bus share
+     *     one file descriptor and a lock, the device address is sent with every transaction.
+     *     The handle can be used instead of a file-descriptor with all the wiringPiI2C functions.
+     * @param {number} bus number of the I2C bus, -1 for the default bus of the Pi
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} handle of the device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2COpen (bus: number, devId: number): number;
+
+    /**
+     * @description Release a handle returned from wiringPiI2COpen (the bus is closed with its last handle),
+     *     or close a file-descriptor returned from wiringPiI2CSetup.
+     * @param {number} fd handle or file-descriptor
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CClose (fd: number): void;
+
+    /**
+     * @description Queue a combined I2C transaction (see wiringPiI2CTransfer) on the worker thread of the bus
+     *     and return at once. Back-to-back transfers to the same device that both set join are sent in a
+     *     single I2C_RDWR, with a repeated START instead of the STOP between them.
+     *     The Buffers of the messages must not be touched until the Promise is settled.
+     * @param {number} fd handle returned from wiringPiI2COpen
+     * @param {Array} messages array of up to 42 message objects
+     * @param {boolean} join optional, true if the device doesn't need a STOP after this transfer
+     * @returns {Promise} resolves to the number of transferred messages
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CTransferAsync (fd: number, messages: WiringPiI2CMessage [], join?: boolean): Promise<number>;
+
+    /**
+     * @description Read the counters of the transfer queue of a bus.
+     * @param {number} bus number of the I2C bus
+     * @param {boolean} reset true to clear the counters after reading
+     * @returns {object} { submitted, completed, errors, ioctls, coalesced, depth, maxDepth, latency }
+     *     latency[n] counts the transfers done in less than (32 << n) microseconds, the last entry all slower ones
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wiringPiI2CQueueStats (bus: number, reset: boolean): { submitted: number, completed: number, errors: number, ioctls: number, coalesced: number, depth: number, maxDepth: number, latency: number [] };
+
+    /**
+     * @description Set up a BMP180 pressure sensor on the default I2C bus. Pin pinBase reads the temperature
+     *     in 1/10 degC, pinBase + 1 the pressure in 1/10 mBar.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function bmp180Setup (pinBase: number): void;
+
+    /**
+     * @description Set up a HTU21D humidity sensor on the default I2C bus. Pin pinBase reads the temperature
+     *     in 1/10 degC, pinBase + 1 the relative humidity in 1/10 %.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function htu21dSetup (pinBase: number): void;
+
+    /**
+     * @description Set up an ADS1115 ADC on the default I2C bus. Pins pinBase to pinBase + 3 read the single
+     *     ended inputs, pinBase + 4 to pinBase + 7 the differential pairs 0-1, 2-3, 0-3 and 1-3.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x48 to 0x4B)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function ads1115Setup (pinBase: number, devId: number): void;
+
+    /**
+     * @description Set up a MCP3422/3/4 ADC on the default I2C bus. Pins pinBase to pinBase + 3 read the channels.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x68 to 0x6F)
+     * @param {number} sampleRate 0 = 240 (12 bit), 1 = 60 (14 bit), 2 = 15 (16 bit), 3 = 3.75 (18 bit) samples per second
+     * @param {number} gain 0 to 3 for a gain of 1, 2, 4 or 8
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp3422Setup (pinBase: number, devId: number, sampleRate: 0 | 1 | 2 | 3, gain: 0 | 1 | 2 | 3): void;
+
+    /**
+     * @description Set up a MCP23017 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 15
+     *     are its I/O pins; digitalRead16/digitalWrite16 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp23017Setup (pinBase: number, devId: number): void;
+
+    /**
+     * @description Set up a MCP23008 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function mcp23008Setup (pinBase: number, devId: number): void;
+
+    /**
+     * @description Set up a PCF8574 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27, 0x38 to 0x3F for the PCF8574A)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function pcf8574Setup (pinBase: number, devId: number): void;
+
+    export interface WiringPiI2CMessage {
+        addr?: number;
+        read?: boolean;
+        nostart?: boolean;
+        buf: Buffer;
+    }
+
+
+    // *************************************************************************************************
+    // Polling
+    // *************************************************************************************************
+
+    /**
+     * @description Read an analog pin of a device set up before, e.g. with ads1115Setup.
+     * @param {number} pin virtual pin number of the device
+     * @returns {number} value read
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function analogRead (pin: number): number;
+
+    /**
+     * @description Read count pins from pin on, all on one device, every periodMs on a native thread.
+     *     Devices on the same I2C bus are polled by one thread which overlaps their conversions.
+     *     The latest values go into a slot of the snapshot table, see wpiPollRead and wpiPollBuffer.
+     * @param {number} pin first virtual pin to read
+     * @param {number} count number of pins to read (1 to 8)
+     * @param {number} periodMs period in milliseconds
+     * @returns {number} slot of the snapshot table
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wpiPollAdd (pin: number, count: number, periodMs: number): number;
+
+    /**
+     * @description Stop polling a slot.
+     * @param {number} slot slot returned from wpiPollAdd
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wpiPollRemove (slot: number): void;
+
+    /**
+     * @description Read the snapshot of a slot, without any bus access.
+     * @param {number} slot slot returned from wpiPollAdd
+     * @returns {object} { timestamp, status, reads, errors, overruns, values }
+     *     timestamp in microseconds of the last values, status 0 or -errno of the last read
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wpiPollRead (slot: number): { timestamp: number, status: number, reads: number, errors: number, overruns: number, values: number [] };
+
+    /**
+     * @description The snapshot table as an ArrayBuffer shared with the polling threads: 64 slots of 64 bytes.
+     *     As Int32Array words from slot * 16 on: 0 sequence (odd while being written), 1 reads, 2 errors,
+     *     3 overruns, 4 and 5 timestamp in microseconds (low, high), 6 status, 7 count, 8 to 15 values.
+     *     A copy is consistent if Atomics.load of the sequence gives the same even value before and after.
+     * @returns {ArrayBuffer} snapshot table
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    export function wpiPollBuffer (): ArrayBuffer;
+
 
     // *************************************************************************************************
     // Serial
@@ -204,6 +812,13 @@ declare module 'wiringpi-sx' {
     export const PUD_DOWN: number;
     export const PUD_UP: number;
 
+    export const PWM_MODE_MS: number;
+    export const PWM_MODE_BAL: number;
+
+    export const INT_EDGE_FALLING: number;
+    export const INT_EDGE_RISING: number;
+    export const INT_EDGE_BOTH: number;
+
     // Version of this node.js module
     export const VERSION: string;
 }
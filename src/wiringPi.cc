@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <wiringPi.h>
+#include <wpiPoll.h>
 
 #include <stdexcept>
 #include <string>
@@ -284,6 +285,273 @@ namespace wiringpi {
     }
     
 
+    /**
+     * @description Library function unsigned int digitalRead8 (int pin)
+     *     Read 8 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalRead8 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t pin;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            unsigned int res = ::digitalRead8(pin);
+            napi_value rv;
+            status = napi_create_uint32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalRead8", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function unsigned int digitalRead16 (int pin)
+     *     Read 16 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalRead16 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t pin;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            unsigned int res = ::digitalRead16(pin);
+            napi_value rv;
+            status = napi_create_uint32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalRead16", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function unsigned int digitalRead32 (int pin)
+     *     Read 32 pins from the given start pin in one go where the device allows it, e.g. both ports
+     *     of a MCP23017 in a single I2C transfer. The run of pins may span several devices; pins that
+     *     don't exist read as 0.
+     * @param {number} pin the first pin, it ends up in bit 0 of the result
+     * @returns {number} the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalRead32 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t pin;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            unsigned int res = ::digitalRead32(pin);
+            napi_value rv;
+            status = napi_create_uint32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalRead32", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void digitalWrite8 (int pin, int value)
+     *     Set 8 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalWrite8 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            uint32_t value;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value");
+            status = napi_get_value_uint32(env, args[1], &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            ::digitalWrite8(pin, value);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalWrite8", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void digitalWrite16 (int pin, int value)
+     *     Set 16 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalWrite16 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            uint32_t value;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value");
+            status = napi_get_value_uint32(env, args[1], &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            ::digitalWrite16(pin, value);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalWrite16", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void digitalWrite32 (int pin, int value)
+     *     Set 32 output pins from the given start pin in one go where the device allows it, e.g. both
+     *     ports of a MCP23017 in a single I2C transfer. The run of pins may span several devices.
+     * @param {number} pin the first pin, set from bit 0 of value
+     * @param {number} value the pin values, one bit per pin
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value digitalWrite32 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            uint32_t value;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value");
+            status = napi_get_value_uint32(env, args[1], &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            ::digitalWrite32(pin, value);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalWrite32", "?"); }
+        return nullptr;
+    }
+
     /**
      * @description Set the freuency on a GPIO clock pin.
      *     Don't forget to set correct pin mode: pinMode(7, GPIO_CLOCK)
@@ -291,12 +559,925 @@ namespace wiringpi {
      * @param {number} frequency value of frequency in Hz.
      * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
      */
-    napi_value gpioClockSet (napi_env env, napi_callback_info info) {
+    napi_value gpioClockSet (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            int32_t frequency;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for frequency");
+            status = napi_get_value_int32(env, args[1], &frequency);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            if (frequency <= 0) {
+                throw WpiLogicError(__LINE__, "invalid value for frequency");
+            }
+            ::gpioClockSet(pin, frequency);
+       }
+       catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+       catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+       catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalWrite", "?"); }
+       return nullptr;
+    }
+
+
+    /**
+     * @description Library function void pwmSetMode (int mode)
+     *     Select the native balanced mode or the standard mark:space mode for both PWM channels.
+     * @param {number} mode use the constants PWM_MODE_BAL or PWM_MODE_MS
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value pwmSetMode (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t mode;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for mode");
+            status = napi_get_value_int32(env, args[0], &mode);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (mode != PWM_MODE_MS && mode != PWM_MODE_BAL) { throw WpiLogicError(__LINE__, "invalid value for mode"); }
+            ::pwmSetMode(mode);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmSetMode", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void pwmSetRange (unsigned int range)
+     *     Set the range register of both PWM channels to the same value (default 1024).
+     * @param {number} range value greater than 0
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value pwmSetRange (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            uint32_t range;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for range");
+            status = napi_get_value_uint32(env, args[0], &range);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (range == 0) { throw WpiLogicError(__LINE__, "invalid value for range"); }
+            ::pwmSetRange(range);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmSetRange", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void pwmSetClock (int divisor)
+     *     Set the divisor of the PWM clock (19.2MHz / divisor), shared by both channels.
+     * @param {number} divisor use values between 2 and 4095
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value pwmSetClock (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t divisor;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for divisor");
+            status = napi_get_value_int32(env, args[0], &divisor);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (divisor < 2 || divisor > 4095) { throw WpiLogicError(__LINE__, "invalid value for divisor, use 2 to 4095"); }
+            ::pwmSetClock(divisor);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmSetClock", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function void pwmWrite (int pin, int value)
+     *     Write the value to the PWM register for the given pin, which must be in PWM_OUTPUT mode.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} value duty value between 0 and the range set for the channel
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR
+     */
+    napi_value pwmWrite (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            int32_t value;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value");
+            status = napi_get_value_int32(env, args[1], &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            if (value < 0) { throw WpiLogicError(__LINE__, "invalid value for value"); }
+            ::pwmWrite(pin, value);
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmWrite", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set the mode and polarity of one hardware PWM channel and enable it.
+     *     The other channel is not changed.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} mode use the constants PWM_MODE_BAL or PWM_MODE_MS
+     * @param {boolean} invert true to reverse the output polarity
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmChannelMode (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t channel;
+            int32_t mode;
+            bool invert;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for mode");
+            status = napi_get_value_int32(env, args[1], &mode);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for invert");
+            status = napi_get_value_bool(env, args[2], &invert);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (mode != PWM_MODE_MS && mode != PWM_MODE_BAL) { throw WpiLogicError(__LINE__, "invalid value for mode"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmChannelMode(channel, mode, invert ? 1 : 0);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmChannelMode fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmChannelMode", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set the range register of one hardware PWM channel.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} range value greater than 0
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmChannelRange (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t channel;
+            uint32_t range;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for range");
+            status = napi_get_value_uint32(env, args[1], &range);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (range == 0) { throw WpiLogicError(__LINE__, "invalid value for range"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmChannelRange(channel, range);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmChannelRange fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmChannelRange", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set the range of one hardware PWM channel and compute the PWM clock divisor for the given frequency.
+     *     Both channels share the PWM clock, so the frequency of the other channel changes too.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} frequency PWM frequency in Hz
+     * @param {number} range value greater than 0, the duty resolution of the channel
+     * @returns {number} the frequency in Hz actually achieved
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmChannelFrequency (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t channel;
+            uint32_t frequency;
+            uint32_t range;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for frequency");
+            status = napi_get_value_uint32(env, args[1], &frequency);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for range");
+            status = napi_get_value_uint32(env, args[2], &range);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (frequency == 0) { throw WpiLogicError(__LINE__, "invalid value for frequency"); }
+            if (range == 0) { throw WpiLogicError(__LINE__, "invalid value for range"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmChannelFrequency(channel, frequency, range);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmChannelFrequency fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmChannelFrequency", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set the duty value of one hardware PWM channel.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {number} value duty value between 0 and the range of the channel
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmChannelWrite (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t channel;
+            uint32_t value;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value");
+            status = napi_get_value_uint32(env, args[1], &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmChannelWrite(channel, value);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmChannelWrite fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmChannelWrite", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set the duty values of both hardware PWM channels with back-to-back register writes.
+     * @param {number} value0 duty value of channel 0
+     * @param {number} value1 duty value of channel 1
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmWriteChannels (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            uint32_t value0;
+            uint32_t value1;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value0");
+            status = napi_get_value_uint32(env, args[0], &value0);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for value1");
+            status = napi_get_value_uint32(env, args[1], &value1);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmWriteChannels(value0, value1);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmWriteChannels fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmWriteChannels", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Feed one hardware PWM channel from the PWM FIFO (true) or from its data register (false).
+     *     The FIFO is cleared when enabled.
+     * @param {number} channel use value 0 or 1 to select the PWM channel
+     * @param {boolean} enable true to use the FIFO
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmChannelFifo (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t channel;
+            bool enable;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for enable");
+            status = napi_get_value_bool(env, args[1], &enable);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmChannelFifo(channel, enable ? 1 : 0);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmChannelFifo fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmChannelFifo", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Write as many 32-bit samples (native byte order) from the buffer into the PWM FIFO as fit.
+     *     This does not block, use the returned count to continue with the rest of the samples later.
+     * @param {Buffer} samples buffer with 32-bit sample values, length must be a multiple of 4
+     * @returns {number} number of samples written
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pwmFifoWrite (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            void *samples;
+
+            napi_value _this;
+            napi_status status;
+            bool isBuffer;
+            size_t length;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_is_buffer(env, args[0], &isBuffer);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (!isBuffer) { throw WpiLogicError(__LINE__, "invalid type for samples"); }
+            status = napi_get_buffer_info(env, args[0], &samples, &length);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (length == 0 || (length % 4) != 0) { throw WpiLogicError(__LINE__, "invalid length of samples"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::pwmFifoWrite((const unsigned int *)samples, length / 4);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "pwmFifoWrite fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pwmFifoWrite", "?"); }
+        return nullptr;
+    }
+
+
+    /**
+     * @description Library function int wiringPiPulseMeter (int pin, int mode)
+     *     Start counting edges and measuring the periods of the signal on an input pin.
+     *     Counting runs natively on the interrupt thread of the pin, use wiringPiPulseRead to fetch the aggregates.
+     *     This function needs the gpio program to be installed (see wiringPiISR).
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} mode use INT_EDGE_RISING, INT_EDGE_FALLING or INT_EDGE_BOTH (needed for the duty cycle)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pulseMeter (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            int32_t mode;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for mode");
+            status = napi_get_value_int32(env, args[1], &mode);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            if (mode != INT_EDGE_RISING && mode != INT_EDGE_FALLING && mode != INT_EDGE_BOTH) {
+                throw WpiLogicError(__LINE__, "invalid value for mode");
+            }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiPulseMeter(pin, mode);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wiringPiPulseMeter fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiPulseMeter", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function int wiringPiPulseRead (int pin, struct wpiPulseStatsStruct *stats, int reset)
+     *     Read the aggregates of the pulse meter started with wiringPiPulseMeter.
+     *     Times are in microseconds, frequency is in Hz and duty is a value between 0 and 1 (only with INT_EDGE_BOTH, otherwise 0).
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {boolean} reset true to restart the aggregation after reading
+     * @returns {object} { edges, periods, periodMin, periodMax, periodAvg, frequency, duty }
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pulseRead (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            bool reset;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for reset");
+            status = napi_get_value_bool(env, args[1], &reset);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+
+            struct wpiPulseStatsStruct stats;
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiPulseRead(pin, &stats, reset ? 1 : 0);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wiringPiPulseRead fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+
+            double periodAvg = stats.periods > 0 ? (double)stats.periodTotal / stats.periods : 0.0;
+            double frequency = periodAvg > 0.0 ? 1000000.0 / periodAvg : 0.0;
+            double duty = stats.periodTotal > 0 ? (double)stats.highTotal / stats.periodTotal : 0.0;
+
+            napi_value rv;
+            napi_value value;
+            status = napi_create_object(env, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_double(env, (double)stats.edges, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "edges", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.periods, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "periods", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.periodMin, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "periodMin", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.periodMax, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "periodMax", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_double(env, periodAvg, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "periodAvg", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_double(env, frequency, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "frequency", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_double(env, duty, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "duty", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiPulseRead", "?"); }
+        return nullptr;
+    }
+
+
+    /**
+     * @description Library function int wiringPiISRFilter (int pin, unsigned int glitchUs, unsigned int debounceUs)
+     *     Set the glitch filter and the debounce time applied to the edges of a pin before they are counted or dispatched.
+     *     Pulses shorter than glitchUs are dropped, and the line must be quiet for debounceUs before an edge is accepted.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {number} glitchUs minimum pulse width in microseconds (0 to 1000000, 0 disables the filter)
+     * @param {number} debounceUs quiet time in microseconds (0 to 1000000, 0 disables debouncing)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value isrFilter (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t pin;
+            uint32_t glitchUs;
+            uint32_t debounceUs;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for glitchUs");
+            status = napi_get_value_uint32(env, args[1], &glitchUs);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for debounceUs");
+            status = napi_get_value_uint32(env, args[2], &debounceUs);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+            if (glitchUs > 1000000) { throw WpiLogicError(__LINE__, "invalid value for glitchUs"); }
+            if (debounceUs > 1000000) { throw WpiLogicError(__LINE__, "invalid value for debounceUs"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiISRFilter(pin, glitchUs, debounceUs);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wiringPiISRFilter fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiISRFilter", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Library function int wiringPiISRFilterStats (int pin, struct wpiISRFilterStatsStruct *stats, int reset)
+     *     Read how many edges of a pin were accepted, and how many were suppressed as bounces or glitches.
+     * @param {number} pin use the virtual pin number 0 to 63 (see http://wiringpi.com/pins/)
+     * @param {boolean} reset true to clear the counters after reading
+     * @returns {object} { accepted, bounces, glitches }
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value isrFilterStats (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pin;
+            bool reset;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for reset");
+            status = napi_get_value_bool(env, args[1], &reset);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
+
+            struct wpiISRFilterStatsStruct stats;
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiISRFilterStats(pin, &stats, reset ? 1 : 0);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wiringPiISRFilterStats fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+
+            napi_value rv;
+            napi_value value;
+            status = napi_create_object(env, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.accepted, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "accepted", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.bounces, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "bounces", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_uint32(env, stats.glitches, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "glitches", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiISRFilterStats", "?"); }
+        return nullptr;
+    }
+
+
+    /**
+     * @description Read an analog pin of a device set up before, e.g. with ads1115Setup.
+     * @param {number} pin virtual pin number of the device
+     * @returns {number} value read
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value analogRead (napi_env env, napi_callback_info info) {
         try {
-            size_t argc = 2;
-            napi_value args[2];
+            size_t argc = 1;
+            napi_value args[1];
             int32_t pin;
-            int32_t frequency;
 
             napi_value _this;
             napi_status status;
@@ -304,6 +1485,54 @@ namespace wiringpi {
 
             status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pin");
+            status = napi_get_value_int32(env, args[0], &pin);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 64) { throw WpiLogicError(__LINE__, "invalid pin value, use 64 or more"); }
+
+            int res = ::analogRead(pin);
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_analogRead", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read count pins from pin on, all on one device, every periodMs on a native thread.
+     *     Devices on the same I2C bus are polled by one thread which overlaps their conversions.
+     *     The latest values go into a slot of the snapshot table, see wpiPollRead and wpiPollBuffer.
+     * @param {number} pin first virtual pin to read
+     * @param {number} count number of pins to read (1 to 8)
+     * @param {number} periodMs period in milliseconds
+     * @returns {number} slot of the snapshot table
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pollAdd (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t pin;
+            int32_t count;
+            int32_t periodMs;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
 
             status = napi_typeof(env, args[0], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
@@ -313,23 +1542,191 @@ namespace wiringpi {
 
             status = napi_typeof(env, args[1], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for frequency");
-            status = napi_get_value_int32(env, args[1], &frequency);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for count");
+            status = napi_get_value_int32(env, args[1], &count);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
-            if (pin < 0 || pin > 63) { throw WpiLogicError(__LINE__, "invalid value for pin"); }
-            if (frequency <= 0) {
-                throw WpiLogicError(__LINE__, "invalid value for frequency");
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for periodMs");
+            status = napi_get_value_int32(env, args[2], &periodMs);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pin < 64) { throw WpiLogicError(__LINE__, "invalid pin value, use 64 or more"); }
+            if (count < 1 || count > WPI_POLL_MAX_VALUES) { throw WpiLogicError(__LINE__, "invalid count value, use 1 to 8"); }
+            if (periodMs < 1) { throw WpiLogicError(__LINE__, "invalid periodMs value"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wpiPollAdd(pin, count, periodMs);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wpiPollAdd fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
             }
-            ::gpioClockSet(pin, frequency);
-       }
-       catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
-       catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
-       catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
-       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_digitalWrite", "?"); }
-       return nullptr;
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wpiPollAdd", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Stop polling a slot.
+     * @param {number} slot slot returned from wpiPollAdd
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pollRemove (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t slot;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for slot");
+            status = napi_get_value_int32(env, args[0], &slot);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (slot < 0 || slot >= WPI_POLL_MAX_SLOTS) { throw WpiLogicError(__LINE__, "invalid slot value, use 0 to 63"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wpiPollRemove(slot);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "wpiPollRemove fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wpiPollRemove", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read the snapshot of a slot, without any bus access.
+     * @param {number} slot slot returned from wpiPollAdd
+     * @returns {object} { timestamp, status, reads, errors, overruns, values }
+     *     timestamp in microseconds of the last values, status 0 or -errno of the last read
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pollRead (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t slot;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for slot");
+            status = napi_get_value_int32(env, args[0], &slot);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (slot < 0 || slot >= WPI_POLL_MAX_SLOTS) { throw WpiLogicError(__LINE__, "invalid slot value, use 0 to 63"); }
+
+            struct wpiPollSnapshotStruct snapshot;
+            ::wpiPollRead(slot, &snapshot);
+
+            napi_value rv;
+            napi_value value;
+            status = napi_create_object(env, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_double(env, (double)snapshot.timestamp, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "timestamp", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_int32(env, snapshot.status, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, rv, "status", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            const char *names[] = { "reads", "errors", "overruns" };
+            const unsigned int counters[] = { snapshot.reads, snapshot.errors, snapshot.overruns };
+            for (int i = 0; i < 3; i++) {
+                status = napi_create_uint32(env, counters[i], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_set_named_property(env, rv, names[i], value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            }
+
+            napi_value values;
+            int count = snapshot.count < WPI_POLL_MAX_VALUES ? snapshot.count : WPI_POLL_MAX_VALUES;
+            status = napi_create_array_with_length(env, count, &values);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            for (int i = 0; i < count; i++) {
+                status = napi_create_int32(env, snapshot.values[i], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_set_element(env, values, i, value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            }
+            status = napi_set_named_property(env, rv, "values", values);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wpiPollRead", "?"); }
+        return nullptr;
     }
 
+    /**
+     * @description The snapshot table as an ArrayBuffer shared with the polling threads: 64 slots of 64 bytes.
+     *     As Int32Array words from slot * 16 on: 0 sequence (odd while being written), 1 reads, 2 errors,
+     *     3 overruns, 4 and 5 timestamp in microseconds (low, high), 6 status, 7 count, 8 to 15 values.
+     *     A copy is consistent if Atomics.load of the sequence gives the same even value before and after.
+     * @returns {ArrayBuffer} snapshot table
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pollBuffer (napi_env env, napi_callback_info info) {
+        try {
+            napi_status status;
+
+            napi_value rv;
+            status = napi_create_external_arraybuffer(env, ::wpiPollTable(),
+                                                      WPI_POLL_MAX_SLOTS * sizeof(struct wpiPollSnapshotStruct),
+                                                      nullptr, nullptr, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wpiPollBuffer", "?"); }
+        return nullptr;
+    }
 
     napi_value init (napi_env env, napi_value exports) {
         try {
@@ -367,11 +1764,141 @@ namespace wiringpi {
             status = napi_set_named_property(env, exports, "digitalRead", fn);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
+            status = napi_create_function(env, nullptr, 0, digitalRead8, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalRead8", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, digitalRead16, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalRead16", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, digitalRead32, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalRead32", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, digitalWrite8, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalWrite8", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, digitalWrite16, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalWrite16", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, digitalWrite32, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "digitalWrite32", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
             status = napi_create_function(env, nullptr, 0, gpioClockSet, nullptr, &fn);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
             status = napi_set_named_property(env, exports, "gpioClockSet", fn);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
+            status = napi_create_function(env, nullptr, 0, pwmSetMode, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmSetMode", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmSetRange, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmSetRange", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmSetClock, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmSetClock", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmWrite, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmWrite", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmChannelMode, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmChannelMode", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmChannelRange, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmChannelRange", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmChannelFrequency, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmChannelFrequency", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmChannelWrite, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmChannelWrite", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmWriteChannels, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmWriteChannels", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmChannelFifo, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmChannelFifo", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pwmFifoWrite, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pwmFifoWrite", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pulseMeter, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiPulseMeter", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pulseRead, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiPulseRead", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, isrFilter, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiISRFilter", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, isrFilterStats, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiISRFilterStats", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, analogRead, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "analogRead", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pollAdd, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wpiPollAdd", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pollRemove, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wpiPollRemove", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pollRead, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wpiPollRead", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pollBuffer, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wpiPollBuffer", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
             status = napi_create_int32(env, INPUT, &value);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
             status = napi_set_named_property(env, exports, "INPUT", value);
@@ -422,6 +1949,31 @@ namespace wiringpi {
             status = napi_set_named_property(env, exports, "PUD_UP", value);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
+            status = napi_create_int32(env, PWM_MODE_MS, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "PWM_MODE_MS", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_int32(env, PWM_MODE_BAL, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "PWM_MODE_BAL", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_int32(env, INT_EDGE_FALLING, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "INT_EDGE_FALLING", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_int32(env, INT_EDGE_RISING, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "INT_EDGE_RISING", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_int32(env, INT_EDGE_BOTH, &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "INT_EDGE_BOTH", value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
             return exports;
         }
         catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
@@ -0,0 +1,1552 @@
+#include <node_api.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "errno.h"
+#include <wiringPi.h>
+#include <wiringPiI2C.h>
+#include <wpiI2CQueue.h>
+#include <bmp180.h>
+#include <htu21d.h>
+#include <ads1115.h>
+#include <mcp3422.h>
+#include <mcp23017.h>
+#include <mcp23008.h>
+#include <pcf8574.h>
+#include "wiringPiI2C.h"
+
+#include <stdexcept>
+#include <sstream>
+#include "addon.h"
+
+namespace wiringpii2c {
+
+    /**
+     * Read an array of message objects into messages, returns the number of messages.
+     */
+    static uint32_t getMessages (napi_env env, napi_value array, struct wiringPiI2CMessage *messages) {
+        napi_status status;
+        napi_valuetype valuetype;
+        bool isArray;
+        uint32_t count;
+
+        status = napi_is_array(env, array, &isArray);
+        if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+        if (!isArray) throw WpiLogicError(__LINE__, "invalid type of argument messages");
+        status = napi_get_array_length(env, array, &count);
+        if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+        if (count < 1 || count > WPI_I2C_MAX_MESSAGES) {
+            throw WpiLogicError(__LINE__, "invalid number of messages, use 1 to 42");
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            napi_value message, value;
+            bool isBuffer, flag;
+            void *data;
+            size_t length;
+            int32_t addr;
+
+            status = napi_get_element(env, array, i, &message);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_typeof(env, message, &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_object) throw WpiLogicError(__LINE__, "invalid type of message");
+
+            status = napi_get_named_property(env, message, "buf", &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_is_buffer(env, value, &isBuffer);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (!isBuffer) throw WpiLogicError(__LINE__, "invalid type of message property buf");
+            status = napi_get_buffer_info(env, value, &data, &length);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (length > 8192) throw WpiLogicError(__LINE__, "invalid length of message, use up to 8192 bytes");
+            messages[i].buf = (unsigned char *)data;
+            messages[i].len = length;
+
+            messages[i].addr = -1;
+            status = napi_get_named_property(env, message, "addr", &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_typeof(env, value, &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_undefined) {
+                if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type of message property addr");
+                status = napi_get_value_int32(env, value, &addr);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (addr < 0 || addr > 127) throw WpiLogicError(__LINE__, "invalid addr value, use 0 to 127");
+                messages[i].addr = addr;
+            }
+
+            messages[i].flags = 0;
+            const char *flags[] = { "read", "nostart" };
+            const int bits[] = { WPI_I2C_READ, WPI_I2C_NOSTART };
+            for (int f = 0; f < 2; f++) {
+                status = napi_get_named_property(env, message, flags[f], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_typeof(env, value, &valuetype);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (valuetype == napi_undefined) continue;
+                if (valuetype != napi_boolean) {
+                    std::ostringstream os;
+                    os << "invalid type of message property " << flags[f];
+                    throw WpiLogicError(__LINE__, os.str().c_str());
+                }
+                status = napi_get_value_bool(env, value, &flag);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (flag) messages[i].flags |= bits[f];
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @description Open the I2C device of the Pi (/dev/i2c-0 or /dev/i2c-1 depending on the board) for the device with the given address.
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} file-descriptor of the I2C device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value setup (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[0], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (devId < 0 || devId > 127) { throw WpiLogicError(__LINE__, "invalid devId value, use 0 to 127"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiI2CSetup(devId);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot get file descriptor for i2c device";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CSetup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Simple device read, some devices present data when you read them without having to do any register transactions.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @returns {number} received byte
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value read (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t fd;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            int res = ::wiringPiI2CRead(fd);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CRead", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read an 8-bit value from the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @returns {number} register value
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value readReg8 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t fd;
+            int32_t reg;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            int res = ::wiringPiI2CReadReg8(fd, reg);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CReadReg8", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read a 16-bit value (SMBus word, low byte first) from the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @returns {number} register value
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value readReg16 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t fd;
+            int32_t reg;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            int res = ::wiringPiI2CReadReg16(fd, reg);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CReadReg16", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Simple device write, some devices accept data this way without needing to access any internal registers.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} data byte to write (0 to 255)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value write (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t fd;
+            int32_t data;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for data");
+            status = napi_get_value_int32(env, args[1], &data);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (data < 0 || data > 255) { throw WpiLogicError(__LINE__, "invalid data value, use 0 to 255"); }
+            int res = ::wiringPiI2CWrite(fd, data);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CWrite", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Write an 8-bit value to the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @param {number} data value to write (0 to 255)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value writeReg8 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t fd;
+            int32_t reg;
+            int32_t data;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for data");
+            status = napi_get_value_int32(env, args[2], &data);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            if (data < 0 || data > 255) { throw WpiLogicError(__LINE__, "invalid data value, use 0 to 255"); }
+            int res = ::wiringPiI2CWriteReg8(fd, reg, data);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CWriteReg8", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Write a 16-bit value (SMBus word, low byte first) to the given register of the device.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup
+     * @param {number} reg register number (0 to 255)
+     * @param {number} data value to write (0 to 65535)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value writeReg16 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t fd;
+            int32_t reg;
+            int32_t data;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for data");
+            status = napi_get_value_int32(env, args[2], &data);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            if (data < 0 || data > 65535) { throw WpiLogicError(__LINE__, "invalid data value, use 0 to 65535"); }
+            int res = ::wiringPiI2CWriteReg16(fd, reg, data);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CWriteReg16", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read a block of consecutive registers in one transaction (register write, repeated start, read).
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {number} reg first register number (0 to 255)
+     * @param {number} length number of bytes to read (1 to 8192)
+     * @returns {Buffer} received data
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value readBlock (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t fd;
+            int32_t reg;
+            int32_t length;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for length");
+            status = napi_get_value_int32(env, args[2], &length);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            if (length < 1 || length > 8192) { throw WpiLogicError(__LINE__, "invalid length value, use 1 to 8192"); }
+
+            void *data;
+            napi_value rv;
+            status = napi_create_buffer(env, length, &data, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            int res = ::wiringPiI2CReadBlock(fd, reg, (unsigned char *)data, length);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CReadBlock", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Write a block of consecutive registers in one transaction.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {number} reg first register number (0 to 255)
+     * @param {Buffer} data bytes to write (1 to 256)
+     * @returns {number} number of bytes written
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value writeBlock (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t fd;
+            int32_t reg;
+            void *data;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+            bool isBuffer;
+            size_t length;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for reg");
+            status = napi_get_value_int32(env, args[1], &reg);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_is_buffer(env, args[2], &isBuffer);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (!isBuffer) { throw WpiLogicError(__LINE__, "invalid type for data"); }
+            status = napi_get_buffer_info(env, args[2], &data, &length);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            if (reg < 0 || reg > 255) { throw WpiLogicError(__LINE__, "invalid reg value, use 0 to 255"); }
+            if (length < 1 || length > WPI_I2C_BLOCK_MAX) { throw WpiLogicError(__LINE__, "invalid length of data, use 1 to 256 bytes"); }
+            int res = ::wiringPiI2CWriteBlock(fd, reg, (const unsigned char *)data, length);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CWriteBlock", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Open the given I2C bus device for the device with the given address.
+     *     Example: wiringPiI2CSetupInterface('/dev/i2c-3', 0x48);
+     * @param {string} device name of the I2C bus device
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} file-descriptor of the I2C device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value setupInterface (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            char device[128];
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+            size_t written;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_string) throw WpiLogicError(__LINE__, "invalid type of argument device");
+            status = napi_get_value_string_utf8(env, args[0], device, sizeof(device) - 1, &written);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            device[written] = 0;
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (device[0] == 0) { throw WpiLogicError(__LINE__, "invalid device value"); }
+            if (devId < 0 || devId > 127) { throw WpiLogicError(__LINE__, "invalid devId value, use 0 to 127"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiI2CSetupInterface(device, devId);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot get file descriptor for i2c device";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CSetupInterface", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Run a list of messages as one combined I2C transaction (I2C_RDWR): one start condition,
+     *     a repeated start between the messages and one stop condition at the end.
+     *     Each message is an object { addr?: number, read?: boolean, nostart?: boolean, buf: Buffer }.
+     *     Without addr the message goes to the device of fd. Read messages fill their Buffer.
+     * @param {number} fd file-descriptor returned from wiringPiI2CSetup or wiringPiI2CSetupInterface
+     * @param {Array} messages array of up to 42 message objects
+     * @returns {number} number of transferred messages
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value transfer (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t fd;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+            uint32_t count;
+            struct wiringPiI2CMessage messages[WPI_I2C_MAX_MESSAGES];
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+            count = getMessages(env, args[1], messages);
+
+            int res = ::wiringPiI2CTransfer(fd, messages, count);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CTransfer", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Get a handle for the device with the given address on /dev/i2c-<bus>. All handles on a bus share
+     *     one file descriptor and a lock, the device address is sent with every transaction.
+     *     The handle can be used instead of a file-descriptor with all the wiringPiI2C functions.
+     * @param {number} bus number of the I2C bus, -1 for the default bus of the Pi
+     * @param {number} devId I2C address of the device (0 to 127)
+     * @returns {number} handle of the device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value open (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t bus;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for bus");
+            status = napi_get_value_int32(env, args[0], &bus);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (bus < -1) { throw WpiLogicError(__LINE__, "invalid bus value"); }
+            if (devId < 0 || devId > 127) { throw WpiLogicError(__LINE__, "invalid devId value, use 0 to 127"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiI2COpen(bus, devId);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot open i2c bus";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2COpen", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Release a handle returned from wiringPiI2COpen (the bus is closed with its last handle),
+     *     or close a file-descriptor returned from wiringPiI2CSetup.
+     * @param {number} fd handle or file-descriptor
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value close (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t fd;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd < 0) { throw WpiLogicError(__LINE__, "invalid fd value"); }
+
+            int res = ::wiringPiI2CClose(fd);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CClose", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a BMP180 pressure sensor on the default I2C bus. Pin pinBase reads the temperature
+     *     in 1/10 degC, pinBase + 1 the pressure in 1/10 mBar.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value bmp180 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t pinBase;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::bmp180Setup(pinBase);
+            if (!res) {
+                std::ostringstream os;
+                os << "bmp180Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_bmp180Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a HTU21D humidity sensor on the default I2C bus. Pin pinBase reads the temperature
+     *     in 1/10 degC, pinBase + 1 the relative humidity in 1/10 %.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value htu21d (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t pinBase;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::htu21dSetup(pinBase);
+            if (!res) {
+                std::ostringstream os;
+                os << "htu21dSetup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_htu21dSetup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up an ADS1115 ADC on the default I2C bus. Pins pinBase to pinBase + 3 read the single
+     *     ended inputs, pinBase + 4 to pinBase + 7 the differential pairs 0-1, 2-3, 0-3 and 1-3.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x48 to 0x4B)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value ads1115 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pinBase;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (devId < 0x48 || devId > 0x4B) { throw WpiLogicError(__LINE__, "invalid devId value, use 0x48 to 0x4B"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::ads1115Setup(pinBase, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "ads1115Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_ads1115Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a MCP3422/3/4 ADC on the default I2C bus. Pins pinBase to pinBase + 3 read the channels.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x68 to 0x6F)
+     * @param {number} sampleRate 0 = 240 (12 bit), 1 = 60 (14 bit), 2 = 15 (16 bit), 3 = 3.75 (18 bit) samples per second
+     * @param {number} gain 0 to 3 for a gain of 1, 2, 4 or 8
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value mcp3422 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 4;
+            napi_value args[4];
+            int32_t pinBase;
+            int32_t devId;
+            int32_t sampleRate;
+            int32_t gain;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 4) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for sampleRate");
+            status = napi_get_value_int32(env, args[2], &sampleRate);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[3], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for gain");
+            status = napi_get_value_int32(env, args[3], &gain);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (devId < 0x68 || devId > 0x6F) { throw WpiLogicError(__LINE__, "invalid devId value, use 0x68 to 0x6F"); }
+            if (sampleRate < 0 || sampleRate > 3) { throw WpiLogicError(__LINE__, "invalid sampleRate value, use 0 to 3"); }
+            if (gain < 0 || gain > 3) { throw WpiLogicError(__LINE__, "invalid gain value, use 0 to 3"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp3422Setup(pinBase, devId, sampleRate, gain);
+            if (!res) {
+                std::ostringstream os;
+                os << "mcp3422Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp3422Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a MCP23017 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 15
+     *     are its I/O pins; digitalRead16/digitalWrite16 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value mcp23017 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pinBase;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (devId < 0x20 || devId > 0x27) { throw WpiLogicError(__LINE__, "invalid devId value, use 0x20 to 0x27"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp23017Setup(pinBase, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "mcp23017Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp23017Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a MCP23008 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value mcp23008 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pinBase;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (devId < 0x20 || devId > 0x27) { throw WpiLogicError(__LINE__, "invalid devId value, use 0x20 to 0x27"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp23008Setup(pinBase, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "mcp23008Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp23008Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a PCF8574 GPIO expander on the default I2C bus. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} devId I2C address of the device (0x20 to 0x27, 0x38 to 0x3F for the PCF8574A)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value pcf8574 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t pinBase;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[1], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if ((devId < 0x20 || devId > 0x27) && (devId < 0x38 || devId > 0x3F)) {
+                throw WpiLogicError(__LINE__, "invalid devId value, use 0x20 to 0x27 or 0x38 to 0x3F");
+            }
+
+            ::wiringPiClearFailureString();
+            int res = ::pcf8574Setup(pinBase, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "pcf8574Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_pcf8574Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * State of a wiringPiI2CTransferAsync call, from submission until its Promise is settled.
+     */
+    struct AsyncTransfer {
+        struct wpiI2CRequestStruct request;
+        struct wiringPiI2CMessage messages[WPI_I2C_MAX_MESSAGES];
+        napi_deferred deferred;
+        napi_ref array;
+    };
+
+    static napi_threadsafe_function asyncDone = nullptr;
+    static uint32_t asyncPending = 0;
+
+    /**
+     * Called on the bus worker thread, passes the finished transfer on to the event loop.
+     */
+    static void asyncCallback (struct wpiI2CRequestStruct *request) {
+        napi_call_threadsafe_function(asyncDone, request->userdata, napi_tsfn_nonblocking);
+    }
+
+    /**
+     * Called on the event loop, settles the Promise of a finished transfer.
+     */
+    static void asyncComplete (napi_env env, napi_value js_cb, void *context, void *data) {
+        AsyncTransfer *transfer = (AsyncTransfer *)data;
+
+        if (env != nullptr) {
+            napi_value value;
+            if (transfer->request.result >= 0) {
+                napi_create_int32(env, transfer->request.result, &value);
+                napi_resolve_deferred(env, transfer->deferred, value);
+            } else {
+                std::ostringstream os;
+                napi_value code, msg;
+                os << "execution error (" << __FILE__ << ":" << __LINE__ << ", IOError "
+                   << transfer->request.error << " (" << strerror(transfer->request.error) << "))";
+                napi_create_string_utf8(env, "ERR_WPI_EXECUTIONERROR", NAPI_AUTO_LENGTH, &code);
+                napi_create_string_utf8(env, os.str().c_str(), NAPI_AUTO_LENGTH, &msg);
+                napi_create_error(env, code, msg, &value);
+                napi_reject_deferred(env, transfer->deferred, value);
+            }
+            napi_delete_reference(env, transfer->array);
+            if (--asyncPending == 0) {
+                napi_unref_threadsafe_function(env, asyncDone);
+            }
+        }
+        delete transfer;
+    }
+
+    /**
+     * @description Queue a combined I2C transaction (see wiringPiI2CTransfer) on the worker thread of the bus
+     *     and return at once. Back-to-back transfers to the same device that both set join are sent in a
+     *     single I2C_RDWR, with a repeated START instead of the STOP between them.
+     *     The Buffers of the messages must not be touched until the Promise is settled.
+     * @param {number} fd handle returned from wiringPiI2COpen
+     * @param {Array} messages array of up to 42 message objects
+     * @param {boolean} join optional, true if the device doesn't need a STOP after this transfer
+     * @returns {Promise} resolves to the number of transferred messages
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value transferAsync (napi_env env, napi_callback_info info) {
+        AsyncTransfer *transfer = nullptr;
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t fd;
+            bool join = false;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2 && argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (argc == 3) {
+                status = napi_typeof(env, args[2], &valuetype);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for join");
+                status = napi_get_value_bool(env, args[2], &join);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            }
+
+            if (fd < WPI_I2C_HANDLE_BASE) { throw WpiLogicError(__LINE__, "invalid fd value, use a handle from wiringPiI2COpen"); }
+
+            transfer = new AsyncTransfer();
+            transfer->request.fd = fd;
+            transfer->request.flags = join ? WPI_I2C_REQUEST_JOIN : 0;
+            transfer->request.messages = transfer->messages;
+            transfer->request.count = getMessages(env, args[1], transfer->messages);
+            transfer->request.callback = asyncCallback;
+            transfer->request.eventFd = -1;
+            transfer->request.userdata = transfer;
+
+            napi_value promise;
+            status = napi_create_promise(env, &transfer->deferred, &promise);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_create_reference(env, args[1], 1, &transfer->array);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (::wpiI2CSubmit(&transfer->request) < 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                napi_delete_reference(env, transfer->array);
+                napi_value value;       // release the unused deferred
+                napi_get_undefined(env, &value);
+                napi_resolve_deferred(env, transfer->deferred, value);
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            if (asyncPending++ == 0) {
+                napi_ref_threadsafe_function(env, asyncDone);
+            }
+            return promise;
+        }
+        catch (const WpiRuntimeError& re)   { delete transfer; throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { delete transfer; throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { delete transfer; throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { delete transfer; napi_throw_error(env, "ERR_WPI_wiringPiI2CTransferAsync", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Read the counters of the transfer queue of a bus.
+     * @param {number} bus number of the I2C bus
+     * @param {boolean} reset true to clear the counters after reading
+     * @returns {object} { submitted, completed, errors, ioctls, coalesced, depth, maxDepth, latency }
+     *     latency[n] counts the transfers done in less than (32 << n) microseconds, the last entry all slower ones
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value queueStats (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t bus;
+            bool reset;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for bus");
+            status = napi_get_value_int32(env, args[0], &bus);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type for reset");
+            status = napi_get_value_bool(env, args[1], &reset);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (bus < 0) { throw WpiLogicError(__LINE__, "invalid bus value"); }
+
+            struct wpiI2CQueueStatsStruct stats;
+            ::wpiI2CQueueStats(bus, &stats, reset ? 1 : 0);
+
+            napi_value rv;
+            napi_value value;
+            status = napi_create_object(env, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            const char *names[] = { "submitted", "completed", "errors", "ioctls", "coalesced", "depth", "maxDepth" };
+            const unsigned int counters[] = { stats.submitted, stats.completed, stats.errors, stats.ioctls,
+                                              stats.coalesced, stats.depth, stats.maxDepth };
+            for (int i = 0; i < 7; i++) {
+                status = napi_create_uint32(env, counters[i], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_set_named_property(env, rv, names[i], value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            }
+
+            napi_value latency;
+            status = napi_create_array_with_length(env, WPI_I2C_LATENCY_BUCKETS, &latency);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            for (uint32_t i = 0; i < WPI_I2C_LATENCY_BUCKETS; i++) {
+                status = napi_create_uint32(env, stats.latency[i], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_set_element(env, latency, i, value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            }
+            status = napi_set_named_property(env, rv, "latency", latency);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CQueueStats", "?"); }
+        return nullptr;
+    }
+
+    napi_value init (napi_env env, napi_value exports) {
+        try {
+            napi_status status;
+            napi_value fn;
+            napi_value name;
+
+            status = napi_create_string_utf8(env, "wiringPiI2CTransferAsync", NAPI_AUTO_LENGTH, &name);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr,
+                                                     asyncComplete, &asyncDone);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_unref_threadsafe_function(env, asyncDone);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, setup, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CSetup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, read, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CRead", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, readReg8, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CReadReg8", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, readReg16, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CReadReg16", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, write, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CWrite", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, writeReg8, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CWriteReg8", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, writeReg16, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CWriteReg16", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, readBlock, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CReadBlock", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, writeBlock, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CWriteBlock", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, setupInterface, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CSetupInterface", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, transfer, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CTransfer", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, open, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2COpen", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, close, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CClose", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, transferAsync, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CTransferAsync", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, queueStats, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiI2CQueueStats", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, bmp180, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "bmp180Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, htu21d, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "htu21dSetup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, ads1115, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "ads1115Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, mcp3422, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp3422Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, mcp23017, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp23017Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, mcp23008, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp23008Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, pcf8574, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "pcf8574Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            return exports;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiI2CInit", "?"); }
+        return nullptr;
+    }
+
+}  // namespace wiringpii2c
@@ -0,0 +1,31 @@
+#ifndef _WPI_WIRING_PI_I2C_H_
+#define _WPI_WIRING_PI_I2C_H_
+
+#include <node_api.h>
+
+namespace wiringpii2c {
+
+    napi_value init           (napi_env env, napi_value exports);
+    napi_value setup          (napi_env env, napi_callback_info info);
+    napi_value setupInterface (napi_env env, napi_callback_info info);
+    napi_value read           (napi_env env, napi_callback_info info);
+    napi_value readReg8       (napi_env env, napi_callback_info info);
+    napi_value readReg16      (napi_env env, napi_callback_info info);
+    napi_value write          (napi_env env, napi_callback_info info);
+    napi_value writeReg8      (napi_env env, napi_callback_info info);
+    napi_value writeReg16     (napi_env env, napi_callback_info info);
+    napi_value readBlock      (napi_env env, napi_callback_info info);
+    napi_value writeBlock     (napi_env env, napi_callback_info info);
+    napi_value transfer       (napi_env env, napi_callback_info info);
+    napi_value open           (napi_env env, napi_callback_info info);
+    napi_value close          (napi_env env, napi_callback_info info);
+    napi_value transferAsync  (napi_env env, napi_callback_info info);
+    napi_value queueStats     (napi_env env, napi_callback_info info);
+    napi_value bmp180         (napi_env env, napi_callback_info info);
+    napi_value htu21d         (napi_env env, napi_callback_info info);
+    napi_value ads1115        (napi_env env, napi_callback_info info);
+    napi_value mcp3422        (napi_env env, napi_callback_info info);
+
+} // namespace wiringpii2c
+
+#endif // _WPI_WIRING_PI_I2C_H_
\ No newline at end of file
@@ -5,14 +5,131 @@
 #include "errno.h"
 #include <wiringPi.h>
 #include <wiringPiSPI.h>
+#include <mcp3004.h>
+#include <mcp23s17.h>
+#include <mcp23s08.h>
 #include "wiringPiSPI.h"
 
 #include <stdexcept>
 #include <sstream>
+#include <vector>
+#include <atomic>
 #include "addon.h"
 
 namespace wiringpispi {
-    
+
+    /**
+     * Read an array of segment objects into segments, returns the number of segments.
+     */
+    static uint32_t getSegments (napi_env env, napi_value array, struct wiringPiSPISegment *segments) {
+        napi_status status;
+        napi_valuetype valuetype;
+        bool isArray;
+        uint32_t count;
+
+        status = napi_is_array(env, array, &isArray);
+        if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+        if (!isArray) throw WpiLogicError(__LINE__, "invalid type of argument segments");
+        status = napi_get_array_length(env, array, &count);
+        if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+        if (count < 1 || count > WPI_SPI_MAX_SEGMENTS) {
+            throw WpiLogicError(__LINE__, "invalid number of segments, use 1 to 64");
+        }
+
+        memset(segments, 0, sizeof(struct wiringPiSPISegment) * count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            napi_value segment, value;
+            bool hasProperty, isBuffer;
+            void *data;
+            size_t length;
+            uint32_t number;
+            size_t len = 0;
+
+            status = napi_get_element(env, array, i, &segment);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_typeof(env, segment, &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_object) throw WpiLogicError(__LINE__, "invalid type of segment");
+
+            const char *buffers[] = { "tx", "rx" };
+            for (int b = 0; b < 2; b++) {
+                status = napi_get_named_property(env, segment, buffers[b], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_typeof(env, value, &valuetype);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (valuetype == napi_undefined) continue;
+                status = napi_is_buffer(env, value, &isBuffer);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (!isBuffer) {
+                    std::ostringstream os;
+                    os << "invalid type of segment property " << buffers[b];
+                    throw WpiLogicError(__LINE__, os.str().c_str());
+                }
+                status = napi_get_buffer_info(env, value, &data, &length);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (len > 0 && length != len) throw WpiLogicError(__LINE__, "tx and rx of segment differ in length");
+                len = length;
+                if (b == 0) segments[i].tx = (unsigned char *)data; else segments[i].rx = (unsigned char *)data;
+            }
+
+            const char *numbers[] = { "len", "speed", "delay", "bits" };
+            for (int n = 0; n < 4; n++) {
+                status = napi_has_named_property(env, segment, numbers[n], &hasProperty);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (!hasProperty) continue;
+                status = napi_get_named_property(env, segment, numbers[n], &value);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                status = napi_typeof(env, value, &valuetype);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                if (valuetype != napi_number) {
+                    std::ostringstream os;
+                    os << "invalid type of segment property " << numbers[n];
+                    throw WpiLogicError(__LINE__, os.str().c_str());
+                }
+                status = napi_get_value_uint32(env, value, &number);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                switch (n) {
+                    case 0:
+                        if (len > 0 && number != len) throw WpiLogicError(__LINE__, "len of segment differs from buffer length");
+                        len = number;
+                        break;
+                    case 1:
+                        if (number < 500000 || number > 32000000) {
+                            throw WpiLogicError(__LINE__, "invalid speed value, use a value between 500000 and 32000000");
+                        }
+                        segments[i].speed = number;
+                        break;
+                    case 2:
+                        if (number > 65535) throw WpiLogicError(__LINE__, "invalid delay value, use 0 to 65535");
+                        segments[i].delayUs = number;
+                        break;
+                    case 3:
+                        if (number < 1 || number > 32) throw WpiLogicError(__LINE__, "invalid bits value, use 1 to 32");
+                        segments[i].bits = number;
+                        break;
+                }
+            }
+
+            status = napi_get_named_property(env, segment, "csChange", &value);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_typeof(env, value, &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_undefined) {
+                bool csChange;
+                if (valuetype != napi_boolean) throw WpiLogicError(__LINE__, "invalid type of segment property csChange");
+                status = napi_get_value_bool(env, value, &csChange);
+                if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+                segments[i].csChange = csChange ? 1 : 0;
+            }
+
+            if (len <= 0) { throw WpiLogicError(__LINE__, "invalid length of segment"); }
+            segments[i].len = len;
+        }
+
+        return count;
+    }
+
     /**
      * @description Initialize the desired SPI channel with CPOL=0 and CPHA=0.
      * @param {number} channel use value 0 or 1 to select the SPI channel
@@ -248,74 +365,1037 @@ namespace wiringpispi {
     }
 
     /**
-     * @description This closes opened SPI file descriptor.
-     * @param {number} fd file-descriptor returned either from wiringPiSPISetup or wiringPiSPISetupMode
+     * @description Run a list of segments as one SPI transaction, submitted with a single ioctl.
+     *     Chip-select stays asserted between the segments unless a segment sets csChange.
+     *     Each segment is an object { tx?: Buffer, rx?: Buffer, len?: number, speed?: number,
+     *     delay?: number, csChange?: boolean, bits?: number }. Without tx zeros are clocked out,
+     *     without rx the received data is discarded, len is only needed when neither buffer is given.
+     *     tx and rx may be the same Buffer.
+     * @param {number} channel use value 0 or 1 to select the SPI channel
+     * @param {Array} segments array of up to 64 segment objects
+     * @returns {number} number of transferred bytes
      * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
      */
-    napi_value close (napi_env env, napi_callback_info info) {
+    napi_value transfer (napi_env env, napi_callback_info info) {
         try {
-            size_t argc = 1;
-            napi_value args[1];
-            int32_t fd;
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t channel;
 
             napi_value _this;
             napi_status status;
             napi_valuetype valuetype;
+            uint32_t count;
+            struct wiringPiSPISegment segments[WPI_SPI_MAX_SEGMENTS];
 
             status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
 
             status = napi_typeof(env, args[0], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type of argument fd");
-            status = napi_get_value_int32(env, args[0], &fd);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type of argument channel");
+            status = napi_get_value_int32(env, args[0], &channel);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
-            if (fd <= 0) { throw WpiLogicError(__LINE__, "invalid value for fd"); }
-            int res = ::close(fd);
-            if (res != 0) {
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            count = getSegments(env, args[1], segments);
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPITransfer(channel, segments, count);
+            if (res == -1) {
                 std::ostringstream os;
                 os << "IOError " << errno << " (" << strerror(errno) << ")";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
                 throw WpiExecutionError(__LINE__, os.str().c_str());
             }
-            return nullptr;
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
        }
        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); } 
        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); } 
-       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIClose", "?"); }
+       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPITransfer", "?"); }
        return nullptr;
     }
 
-    napi_value init (napi_env env, napi_value exports) {
+    /**
+     * @description Return the largest message the spidev driver accepts (module parameter bufsiz).
+     *     Larger transfers are split automatically, keeping chip-select asserted.
+     * @returns {number} size in bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value bufferSize (napi_env env, napi_callback_info info) {
         try {
             napi_status status;
-            napi_value fn;
 
-            status = napi_create_function(env, nullptr, 0, setup, nullptr, &fn);
+            int res = ::wiringPiSPIBufferSize();
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            status = napi_set_named_property(env, exports, "wiringPiSPISetup", fn);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIBufferSize", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Open /dev/spidev<bus>.<cs> with 8 bits per word and no delay, use the returned handle
+     *     with the wiringPiSPIHandle... functions. Each handle keeps its own settings.
+     * @param {number} bus number of the SPI bus (0 for /dev/spidev0.x, 1 for /dev/spidev1.x, ...)
+     * @param {number} cs chip-select of the device on the bus
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} mode use 0, 1, 2 or 3. Bit 0 is CPOL, bit 1 is CPHA.
+     * @returns {number} handle of the SPI device
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value open (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 4;
+            napi_value args[4];
+            int32_t bus;
+            int32_t cs;
+            int32_t speed;
+            int32_t mode;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 4) throw WpiLogicError(__LINE__, "invalid number of arguments");
 
-            status = napi_create_function(env, nullptr, 0, setupMode, nullptr, &fn);
+            status = napi_typeof(env, args[0], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            status = napi_set_named_property(env, exports, "wiringPiSPISetupMode", fn);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for bus");
+            status = napi_get_value_int32(env, args[0], &bus);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
-            status = napi_create_function(env, nullptr, 0, getFd, nullptr, &fn);
+            status = napi_typeof(env, args[1], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            status = napi_set_named_property(env, exports, "wiringPiSPIGetFd", fn);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for cs");
+            status = napi_get_value_int32(env, args[1], &cs);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
-            status = napi_create_function(env, nullptr, 0, dataRW, nullptr, &fn);
+            status = napi_typeof(env, args[2], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            status = napi_set_named_property(env, exports, "wiringPiSPIDataRW", fn);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for speed");
+            status = napi_get_value_int32(env, args[2], &speed);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
-            status = napi_create_function(env, nullptr, 0, close, nullptr, &fn);
+            status = napi_typeof(env, args[3], &valuetype);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
-            status = napi_set_named_property(env, exports, "wiringPiSPIClose", fn);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for mode");
+            status = napi_get_value_int32(env, args[3], &mode);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (bus < 0) { throw WpiLogicError(__LINE__, "invalid bus value"); }
+            if (cs < 0) { throw WpiLogicError(__LINE__, "invalid cs value"); }
+            if (speed < 500000 || speed > 32000000) {
+                throw WpiLogicError(__LINE__, "invalid speed value, use a value between 500000 and 32000000");
+            }
+            if (mode < 0 || mode > 3) { throw WpiLogicError(__LINE__, "invalid mode value, use 0, 1, 2 or 3"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPIOpen(bus, cs, speed, mode);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot open spi device";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIOpen", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Change the settings of an SPI handle.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} mode use 0, 1, 2 or 3. Bit 0 is CPOL, bit 1 is CPHA.
+     * @param {number} bpw bits per word, 1 to 32
+     * @param {number} delay delay in microseconds after each transfer, 0 to 65535
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value config (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 5;
+            napi_value args[5];
+            int32_t handle;
+            int32_t speed;
+            int32_t mode;
+            int32_t bpw;
+            int32_t delay;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 5) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for handle");
+            status = napi_get_value_int32(env, args[0], &handle);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for speed");
+            status = napi_get_value_int32(env, args[1], &speed);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for mode");
+            status = napi_get_value_int32(env, args[2], &mode);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[3], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for bpw");
+            status = napi_get_value_int32(env, args[3], &bpw);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[4], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for delay");
+            status = napi_get_value_int32(env, args[4], &delay);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (speed < 500000 || speed > 32000000) {
+                throw WpiLogicError(__LINE__, "invalid speed value, use a value between 500000 and 32000000");
+            }
+            if (mode < 0 || mode > 3) { throw WpiLogicError(__LINE__, "invalid mode value, use 0, 1, 2 or 3"); }
+            if (bpw < 1 || bpw > 32) { throw WpiLogicError(__LINE__, "invalid bpw value, use 1 to 32"); }
+            if (delay < 0 || delay > 65535) { throw WpiLogicError(__LINE__, "invalid delay value, use 0 to 65535"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPIConfig(handle, speed, mode, bpw, delay);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot configure spi device";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIConfig", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Write and Read a block of data on an SPI handle.
+     *     Note the data ia being read into the transmit buffer, so will overwrite it!
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {Buffer} data binary data stream to write and read data.
+     * @returns {number} number of transferred bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value handleRW (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t handle;
+            void *data;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+            bool isBuffer;
+            size_t length;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for handle");
+            status = napi_get_value_int32(env, args[0], &handle);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_is_buffer(env, args[1], &isBuffer);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (!isBuffer) { throw WpiLogicError(__LINE__, "invalid type for data"); }
+            status = napi_get_buffer_info(env, args[1], &data, &length);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (length <= 0) { throw WpiLogicError(__LINE__, "invalid length of data"); }
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPIHandleRW(handle, (unsigned char*)data, length);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot transfer data";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIHandleRW", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Run a list of segments as one SPI transaction on an SPI handle, see wiringPiSPITransfer.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @param {Array} segments array of up to 64 segment objects
+     * @returns {number} number of transferred bytes
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value handleTransfer (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t handle;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+            uint32_t count;
+            struct wiringPiSPISegment segments[WPI_SPI_MAX_SEGMENTS];
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type of argument handle");
+            status = napi_get_value_int32(env, args[0], &handle);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            count = getSegments(env, args[1], segments);
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPIHandleTransfer(handle, segments, count);
+            if (res == -1) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+       }
+       catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+       catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); } 
+       catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); } 
+       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIHandleTransfer", "?"); }
+       return nullptr;
+    }
+
+    /**
+     * @description Close the device of an SPI handle and release the handle.
+     * @param {number} handle handle returned from wiringPiSPIOpen
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value handleClose (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t handle;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for handle");
+            status = napi_get_value_int32(env, args[0], &handle);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            ::wiringPiClearFailureString();
+            int res = ::wiringPiSPIHandleClose(handle);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "Cannot close spi handle";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIHandleClose", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * Samples per block of each stream started here, 0 when not in use or stopping.
+     * Reads not yet settled per stream, a stop waits for them (both on the event loop).
+     */
+    static int streamSamples[MCP3004_MAX_STREAMS];
+    static int streamReads[MCP3004_MAX_STREAMS];
+    static std::atomic<bool> streamStopping[MCP3004_MAX_STREAMS];
+
+    /**
+     * Reads wait in slices of this many milliseconds, so a stop doesn't wait on them for long.
+     */
+    #define STREAM_READ_SLICE 100
+
+    /**
+     * Stop a stream in the library and free its number.
+     */
+    static int streamStop (int stream) {
+        int res = ::mcp3004StreamStop(stream);
+        streamSamples[stream] = 0;
+        streamStopping[stream] = false;
+        return res;
+    }
+
+    /**
+     * @description Start continuous sampling of an MCP3004/3008 (10 bit) or MCP3204/3208 (12 bit) ADC
+     *     on a dedicated thread. Each block holds scans rounds over the channels in channelMask,
+     *     the conversions are submitted as multi-segment SPI transactions.
+     *     Fetch the blocks with mcp3004StreamRead.
+     * @param {number} channel use value 0 or 1 to select the SPI channel
+     * @param {number} speed use values between 500000 and 32000000 for the SPI clock frequency in Hz
+     * @param {number} bits 10 for MCP3004/3008, 12 for MCP3204/3208
+     * @param {number} channelMask bit n set samples ADC channel n (1 to 255)
+     * @param {number} scans number of rounds over the channels per block
+     * @returns {number} stream number
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value adcStreamStart (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 5;
+            napi_value args[5];
+            int32_t channel;
+            int32_t speed;
+            int32_t bits;
+            int32_t channelMask;
+            int32_t scans;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 5) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[0], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for speed");
+            status = napi_get_value_int32(env, args[1], &speed);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for bits");
+            status = napi_get_value_int32(env, args[2], &bits);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[3], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channelMask");
+            status = napi_get_value_int32(env, args[3], &channelMask);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[4], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for scans");
+            status = napi_get_value_int32(env, args[4], &scans);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (channel != 0 && channel != 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (speed < 500000 || speed > 32000000) {
+                throw WpiLogicError(__LINE__, "invalid speed value, use a value between 500000 and 32000000");
+            }
+            if (bits != 10 && bits != 12) { throw WpiLogicError(__LINE__, "invalid bits value, use 10 or 12"); }
+            if (channelMask < 1 || channelMask > 255) { throw WpiLogicError(__LINE__, "invalid channelMask value, use 1 to 255"); }
+            if (scans < 1) { throw WpiLogicError(__LINE__, "invalid scans value"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp3004StreamStart(channel, speed, bits, channelMask, scans, nullptr, nullptr);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "mcp3004StreamStart fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            streamSamples[res] = __builtin_popcount(channelMask) * scans;
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp3004StreamStart", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * State of a mcp3004StreamRead call, from the call until its Promise is settled.
+     */
+    struct AsyncStreamRead {
+        napi_async_work work;
+        napi_deferred deferred;
+        int32_t stream;
+        int32_t timeout;
+        std::vector<unsigned short> samples;
+        struct mcp3004StreamBlockStruct block;
+        int result;
+        int error;
+    };
+
+    /**
+     * Called on a worker thread of the event loop, waits for the block, giving up once the stream is
+     * being stopped.
+     */
+    static void streamReadExecute (napi_env env, void *data) {
+        AsyncStreamRead *read = (AsyncStreamRead *)data;
+        int left = read->timeout;
+        int slice;
+
+        for (;;) {
+            if (streamStopping[read->stream]) {
+                read->result = -1;
+                read->error = EPIPE;
+                return;
+            }
+            slice = (left < 0 || left > STREAM_READ_SLICE) ? STREAM_READ_SLICE : left;
+            read->result = ::mcp3004StreamRead(read->stream, read->samples.data(), read->samples.size(), &read->block, slice);
+            read->error = (read->result < 0) ? errno : 0;
+            if (read->result != 0 || left == slice) {
+                return;
+            }
+            if (left > 0) {
+                left -= slice;
+            }
+        }
+    }
+
+    /**
+     * Called on the event loop, settles the Promise of a finished read.
+     */
+    static void streamReadComplete (napi_env env, napi_status status, void *data) {
+        AsyncStreamRead *read = (AsyncStreamRead *)data;
+        napi_value rv, value;
+
+        if (read->result < 0) {
+            std::ostringstream os;
+            napi_value code, msg;
+            os << "execution error (" << __FILE__ << ":" << __LINE__ << ", mcp3004StreamRead fails ("
+               << read->error << " (" << strerror(read->error) << ")))";
+            napi_create_string_utf8(env, "ERR_WPI_EXECUTIONERROR", NAPI_AUTO_LENGTH, &code);
+            napi_create_string_utf8(env, os.str().c_str(), NAPI_AUTO_LENGTH, &msg);
+            napi_create_error(env, code, msg, &value);
+            napi_reject_deferred(env, read->deferred, value);
+        } else if (read->result == 0) {
+            napi_get_null(env, &rv);
+            napi_resolve_deferred(env, read->deferred, rv);
+        } else {
+            napi_create_object(env, &rv);
+            napi_create_double(env, (double)read->block.timestamp, &value);
+            napi_set_named_property(env, rv, "timestamp", value);
+            napi_create_uint32(env, read->block.duration, &value);
+            napi_set_named_property(env, rv, "duration", value);
+            napi_create_uint32(env, read->block.sequence, &value);
+            napi_set_named_property(env, rv, "sequence", value);
+            napi_create_int32(env, read->block.channels, &value);
+            napi_set_named_property(env, rv, "channels", value);
+            napi_create_int32(env, read->block.scans, &value);
+            napi_set_named_property(env, rv, "scans", value);
+            napi_create_buffer_copy(env, read->result * sizeof(unsigned short), read->samples.data(), nullptr, &value);
+            napi_set_named_property(env, rv, "samples", value);
+            napi_resolve_deferred(env, read->deferred, rv);
+        }
+
+        if (--streamReads[read->stream] == 0 && streamStopping[read->stream]) {
+            streamStop(read->stream);
+        }
+
+        napi_delete_async_work(env, read->work);
+        delete read;
+    }
+
+    /**
+     * @description Wait for the next completed block of a stream, on a worker thread so the event loop
+     *     carries on meanwhile. The samples are returned as Buffer of 16 bit values (host byte order,
+     *     use a Uint16Array view), interleaved by channel.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @param {number} timeout maximum waiting time in milliseconds, -1 waits for ever
+     * @returns {Promise} resolves to { timestamp, duration, sequence, channels, scans, samples } or null on timeout
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value adcStreamRead (napi_env env, napi_callback_info info) {
+        AsyncStreamRead *read = nullptr;
+        try {
+            size_t argc = 2;
+            napi_value args[2];
+            int32_t stream;
+            int32_t timeout;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 2) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for stream");
+            status = napi_get_value_int32(env, args[0], &stream);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for timeout");
+            status = napi_get_value_int32(env, args[1], &timeout);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (stream < 0 || stream >= MCP3004_MAX_STREAMS || streamSamples[stream] == 0) {
+                throw WpiLogicError(__LINE__, "invalid stream");
+            }
+            if (timeout < -1) { throw WpiLogicError(__LINE__, "invalid timeout value, use -1 or more"); }
+
+            read = new AsyncStreamRead();
+            read->stream = stream;
+            read->timeout = timeout;
+            read->samples.resize(streamSamples[stream]);
+
+            napi_value name, promise;
+            status = napi_create_string_utf8(env, "mcp3004StreamRead", NAPI_AUTO_LENGTH, &name);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_create_async_work(env, nullptr, name, streamReadExecute, streamReadComplete, read, &read->work);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_create_promise(env, &read->deferred, &promise);
+            if (status != napi_ok) {
+                napi_delete_async_work(env, read->work);
+                throw WpiRuntimeError(__LINE__);
+            }
+            status = napi_queue_async_work(env, read->work);
+            if (status != napi_ok) {
+                napi_delete_async_work(env, read->work);
+                throw WpiRuntimeError(__LINE__);
+            }
+            ++streamReads[stream];
+            return promise;
+        }
+        catch (const WpiRuntimeError& re)   { delete read; throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { delete read; throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { delete read; throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { delete read; napi_throw_error(env, "ERR_WPI_mcp3004StreamRead", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Number of blocks replaced before mcp3004StreamRead got to them.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @returns {number} number of lost blocks
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value adcStreamOverruns (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t stream;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for stream");
+            status = napi_get_value_int32(env, args[0], &stream);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            int res = ::mcp3004StreamOverruns(stream);
+            if (res < 0) { throw WpiLogicError(__LINE__, "invalid stream"); }
+            napi_value rv;
+            status = napi_create_int32(env, res, &rv);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            return rv;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp3004StreamOverruns", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Stop the sampling thread and release the stream. Pending reads are rejected,
+     *     the stream is released once the last of them has settled.
+     * @param {number} stream stream number returned from mcp3004StreamStart
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value adcStreamStop (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t stream;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for stream");
+            status = napi_get_value_int32(env, args[0], &stream);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (stream < 0 || stream >= MCP3004_MAX_STREAMS || streamSamples[stream] == 0) {
+                throw WpiLogicError(__LINE__, "invalid stream");
+            }
+            if (streamReads[stream] > 0) {
+                streamSamples[stream] = 0;
+                streamStopping[stream] = true;
+                return nullptr;
+            }
+
+            ::wiringPiClearFailureString();
+            int res = streamStop(stream);
+            if (res < 0) {
+                std::ostringstream os;
+                os << "mcp3004StreamStop fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp3004StreamStop", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description This closes opened SPI file descriptor.
+     * @param {number} fd file-descriptor returned either from wiringPiSPISetup or wiringPiSPISetupMode
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value close (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 1;
+            napi_value args[1];
+            int32_t fd;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 1) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type of argument fd");
+            status = napi_get_value_int32(env, args[0], &fd);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (fd <= 0) { throw WpiLogicError(__LINE__, "invalid value for fd"); }
+            int res = ::close(fd);
+            if (res != 0) {
+                std::ostringstream os;
+                os << "IOError " << errno << " (" << strerror(errno) << ")";
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+       }
+       catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+       catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); } 
+       catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); } 
+       catch ( ... )                       { napi_throw_error(env, "ERR_WPI_wiringPiSPIClose", "?"); }
+       return nullptr;
+    }
+
+    /**
+     * @description Set up a MCP23S17 GPIO expander on a SPI channel. Pins pinBase to pinBase + 15
+     *     are its I/O pins; digitalRead16/digitalWrite16 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} channel SPI channel (0 or 1)
+     * @param {number} devId hardware address of the device (0 to 7)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value mcp23s17 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t pinBase;
+            int32_t channel;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[1], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[2], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (channel < 0 || channel > 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (devId < 0 || devId > 7) { throw WpiLogicError(__LINE__, "invalid devId value, use 0 to 7"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp23s17Setup(pinBase, channel, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "mcp23s17Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp23s17Setup", "?"); }
+        return nullptr;
+    }
+
+    /**
+     * @description Set up a MCP23S08 GPIO expander on a SPI channel. Pins pinBase to pinBase + 7
+     *     are its I/O pins; digitalRead8/digitalWrite8 on pinBase access all of them in one transfer.
+     * @param {number} pinBase first virtual pin of the device (64 or more)
+     * @param {number} channel SPI channel (0 or 1)
+     * @param {number} devId hardware address of the device (0 to 7)
+     * @throws ERR_WPI_RUNTIME, ERR_WPI_LOGICERROR, ERR_WPI_EXECUTIONERROR
+     */
+    napi_value mcp23s08 (napi_env env, napi_callback_info info) {
+        try {
+            size_t argc = 3;
+            napi_value args[3];
+            int32_t pinBase;
+            int32_t channel;
+            int32_t devId;
+
+            napi_value _this;
+            napi_status status;
+            napi_valuetype valuetype;
+
+            status = napi_get_cb_info(env, info, &argc, args, &_this, nullptr);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (argc != 3) throw WpiLogicError(__LINE__, "invalid number of arguments");
+
+            status = napi_typeof(env, args[0], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for pinBase");
+            status = napi_get_value_int32(env, args[0], &pinBase);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[1], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for channel");
+            status = napi_get_value_int32(env, args[1], &channel);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_typeof(env, args[2], &valuetype);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            if (valuetype != napi_number) throw WpiLogicError(__LINE__, "invalid type for devId");
+            status = napi_get_value_int32(env, args[2], &devId);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            if (pinBase < 64) { throw WpiLogicError(__LINE__, "invalid pinBase value, use 64 or more"); }
+            if (channel < 0 || channel > 1) { throw WpiLogicError(__LINE__, "invalid channel value, use 0 or 1"); }
+            if (devId < 0 || devId > 7) { throw WpiLogicError(__LINE__, "invalid devId value, use 0 to 7"); }
+
+            ::wiringPiClearFailureString();
+            int res = ::mcp23s08Setup(pinBase, channel, devId);
+            if (!res) {
+                std::ostringstream os;
+                os << "mcp23s08Setup fails";
+                if (::wiringPiGetLastFailureString()[0] != 0) {
+                    os << " (" << ::wiringPiGetLastFailureString() << ")";
+                }
+                throw WpiExecutionError(__LINE__, os.str().c_str());
+            }
+            return nullptr;
+        }
+        catch (const WpiRuntimeError& re)   { throwWpiRuntimeError(env, __FILE__, re); }
+        catch (const WpiLogicError& ex)     { throwWpiLogicError(env, __FILE__, ex); }
+        catch (const WpiExecutionError& ex) { throwWpiExecutionError(env, __FILE__, ex); }
+        catch ( ... )                       { napi_throw_error(env, "ERR_WPI_mcp23s08Setup", "?"); }
+        return nullptr;
+    }
+
+    napi_value init (napi_env env, napi_value exports) {
+        try {
+            napi_status status;
+            napi_value fn;
+
+            status = napi_create_function(env, nullptr, 0, setup, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPISetup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, setupMode, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPISetupMode", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, getFd, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIGetFd", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, dataRW, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIDataRW", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, transfer, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPITransfer", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, bufferSize, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIBufferSize", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, open, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIOpen", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, config, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIConfig", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, handleRW, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIHandleRW", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, handleTransfer, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIHandleTransfer", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, handleClose, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIHandleClose", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, adcStreamStart, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp3004StreamStart", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, adcStreamRead, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp3004StreamRead", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, adcStreamOverruns, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp3004StreamOverruns", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, adcStreamStop, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp3004StreamStop", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, close, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "wiringPiSPIClose", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, mcp23s17, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp23s17Setup", fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+
+            status = napi_create_function(env, nullptr, 0, mcp23s08, nullptr, &fn);
+            if (status != napi_ok) throw WpiRuntimeError(__LINE__);
+            status = napi_set_named_property(env, exports, "mcp23s08Setup", fn);
             if (status != napi_ok) throw WpiRuntimeError(__LINE__);
 
             return exports;
@@ -5,12 +5,23 @@
 
 namespace wiringpispi {
 
-    napi_value init      (napi_env env, napi_value exports);
-    napi_value setup     (napi_env env, napi_callback_info info);
-    napi_value setupMode (napi_env env, napi_callback_info info);
-    napi_value getFd     (napi_env env, napi_callback_info info);
-    napi_value dataRW    (napi_env env, napi_callback_info info);
-    napi_value close     (napi_env env, napi_callback_info info);
+    napi_value init              (napi_env env, napi_value exports);
+    napi_value setup             (napi_env env, napi_callback_info info);
+    napi_value setupMode         (napi_env env, napi_callback_info info);
+    napi_value getFd             (napi_env env, napi_callback_info info);
+    napi_value dataRW            (napi_env env, napi_callback_info info);
+    napi_value transfer          (napi_env env, napi_callback_info info);
+    napi_value bufferSize        (napi_env env, napi_callback_info info);
+    napi_value open              (napi_env env, napi_callback_info info);
+    napi_value config            (napi_env env, napi_callback_info info);
+    napi_value handleRW          (napi_env env, napi_callback_info info);
+    napi_value handleTransfer    (napi_env env, napi_callback_info info);
+    napi_value handleClose       (napi_env env, napi_callback_info info);
+    napi_value adcStreamStart    (napi_env env, napi_callback_info info);
+    napi_value adcStreamRead     (napi_env env, napi_callback_info info);
+    napi_value adcStreamOverruns (napi_env env, napi_callback_info info);
+    napi_value adcStreamStop     (napi_env env, napi_callback_info info);
+    napi_value close             (napi_env env, napi_callback_info info);
 
 } // namespace wiringpispi
 
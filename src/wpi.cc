@@ -2,6 +2,7 @@
 #include "addon.h"
 #include <wiringPi.h>
 #include "wiringPi.h"
+#include "wiringPiI2C.h"
 #include "wiringPiSPI.h"
 #include "wiringSerial.h"
 
@@ -9,6 +10,7 @@ namespace nodemodule {
 
     napi_value init (napi_env env, napi_value exports) {
         if (wiringpi::init(env, exports) == nullptr)    { return nullptr; }
+        if (wiringpii2c::init(env, exports) == nullptr) { return nullptr; }
         if (wiringpispi::init(env, exports) == nullptr) { return nullptr; }
         if (wiringserial::init(env, exports) == nullptr) { return nullptr; }
         return exports;            
@@ -50,6 +50,9 @@
 #define	SPI_A2D		      0
 #define	SPI_D2A		      1
 
+static int adcHandle = -1 ;
+static int dacHandle = -1 ;
+
 
 /*
  * gertboardAnalogWrite:
@@ -74,7 +77,7 @@ void gertboardAnalogWrite (const int chan, const int value)
   spiData [0] = chanBits ;
   spiData [1] = dataBits ;
 
-  wiringPiSPIDataRW (SPI_D2A, spiData, 2) ;
+  wiringPiSPIHandleRW (dacHandle, spiData, 2) ;
 }
 
 
@@ -99,7 +102,7 @@ int gertboardAnalogRead (const int chan)
   spiData [0] = chanBits ;
   spiData [1] = 0 ;
 
-  wiringPiSPIDataRW (SPI_A2D, spiData, 2) ;
+  wiringPiSPIHandleRW (adcHandle, spiData, 2) ;
 
   return ((spiData [0] << 8) | (spiData [1] >> 1)) & 0x3FF ;
 }
@@ -113,10 +116,10 @@ int gertboardAnalogRead (const int chan)
 
 int gertboardSPISetup (void)
 {
-  if (wiringPiSPISetup (SPI_A2D, SPI_ADC_SPEED) < 0)
+  if ((adcHandle < 0) && ((adcHandle = wiringPiSPIOpen (0, SPI_A2D, SPI_ADC_SPEED, 0)) < 0))
     return -1 ;
 
-  if (wiringPiSPISetup (SPI_D2A, SPI_DAC_SPEED) < 0)
+  if ((dacHandle < 0) && ((dacHandle = wiringPiSPIOpen (0, SPI_D2A, SPI_DAC_SPEED, 0)) < 0))
     return -1 ;
 
   return 0 ;
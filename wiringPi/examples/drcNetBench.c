@@ -0,0 +1,142 @@
+/*
+ * drcNetBench.c:
+ *	Measure how many operations a second go over a DRC network link to
+ *	wiringPiD - e.g. on the loopback with the daemon started as:
+ *		wiringpid -z <password>
+ *	then
+ *		drcNetBench 127.0.0.1 6124 <password>
+ *	Runs with the pipelined protocol first, then again waiting for a
+ *	reply to every command as protocol 1 did.
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <wiringPi.h>
+#include <drcNet.h>
+
+#define	PIN_BASE	100
+
+static int count = 20000 ;
+
+
+/*
+ * report:
+ *	Print the operations per second for a test
+ *********************************************************************************
+ */
+
+static void report (const char *name, unsigned int start, int ops)
+{
+  unsigned int us = micros () - start ;
+
+  if (us == 0)
+    us = 1 ;
+
+  printf ("  %-24s %10.0f ops/sec\n", name, (double)ops * 1000000.0 / us) ;
+}
+
+
+/*
+ * runTests:
+ *********************************************************************************
+ */
+
+static void runTests (void)
+{
+  unsigned long long bits ;
+  unsigned int start ;
+  int i ;
+
+  start = micros () ;
+  for (i = 0 ; i < count ; ++i)
+    digitalWrite (PIN_BASE + (i & 7), i & 1) ;
+  drcNetFlush (PIN_BASE) ;
+  report ("digitalWrite", start, count) ;
+
+  drcNetBatch (PIN_BASE, 1000) ;
+  start = micros () ;
+  for (i = 0 ; i < count ; ++i)
+    digitalWrite (PIN_BASE + (i & 7), i & 1) ;
+  drcNetFlush (PIN_BASE) ;
+  report ("digitalWrite, 1mS batch", start, count) ;
+  drcNetBatch (PIN_BASE, 0) ;
+
+  start = micros () ;
+  for (i = 0 ; i < count ; ++i)
+    (void)digitalRead (PIN_BASE + (i & 7)) ;
+  report ("digitalRead", start, count) ;
+
+  start = micros () ;
+  for (i = 0 ; i < count ; ++i)
+  {
+    digitalWrite (PIN_BASE + (i & 7), i & 1) ;
+    (void)digitalRead (PIN_BASE + 8) ;
+  }
+  report ("digitalWrite + Read", start, count * 2) ;
+
+  start = micros () ;
+  for (i = 0 ; i < count / 32 ; ++i)
+    (void)digitalRead32 (PIN_BASE) ;
+  report ("digitalRead32 (per pin)", start, (count / 32) * 32) ;
+
+  start = micros () ;
+  for (i = 0 ; i < count / 64 ; ++i)
+    (void)drcNetDigitalReadAll (PIN_BASE, 64, &bits) ;
+  report ("ReadAll 64 (per pin)", start, (count / 64) * 64) ;
+
+  start = micros () ;
+  for (i = 0 ; i < count / 64 ; ++i)
+    (void)drcNetDigitalWriteMasked (PIN_BASE, ~0ULL, i & 1 ? ~0ULL : 0) ;
+  drcNetFlush (PIN_BASE) ;
+  report ("WriteMasked 64 (per pin)", start, (count / 64) * 64) ;
+}
+
+
+int main (int argc, char *argv [])
+{
+  int protocol ;
+
+  if (argc < 4)
+  {
+    fprintf (stderr, "Usage: %s host port password [count]\n", argv [0]) ;
+    return 1 ;
+  }
+
+  if (argc > 4)
+    count = atoi (argv [4]) ;
+
+  if (!drcSetupNet (PIN_BASE, 64, argv [1], argv [2], argv [3]))
+  {
+    fprintf (stderr, "%s: Unable to connect to %s:%s\n", argv [0], argv [1], argv [2]) ;
+    return 1 ;
+  }
+
+  for (protocol = drcNetProtocol (PIN_BASE, 0) ; protocol >= 1 ; --protocol)
+  {
+    if (drcNetProtocol (PIN_BASE, protocol) != protocol)
+      break ;
+    printf ("Protocol %d:\n", protocol) ;
+    runTests () ;
+  }
+
+  return 0 ;
+}
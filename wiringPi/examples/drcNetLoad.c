@@ -0,0 +1,128 @@
+/*
+ * drcNetLoad.c:
+ *	Load test for wiringPiD: a number of clients, each with its own
+ *	connection and thread, all hammering the daemon at once for a few
+ *	seconds. e.g. on the loopback with the daemon started as:
+ *		wiringpid -z <password>
+ *	then
+ *		drcNetLoad 127.0.0.1 6124 <password> 50
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <wiringPi.h>
+#include <drcNet.h>
+
+#define	MAX_CLIENTS	200
+#define	RUN_TIME	5000	// mS
+
+// Each client gets 64 pins from here
+
+#define	PIN_BASE	100
+
+static volatile int running = TRUE ;
+
+static int ops [MAX_CLIENTS] ;
+
+
+/*
+ * client:
+ *	Write a pin then read one, over and over
+ *********************************************************************************
+ */
+
+static void *client (void *arg)
+{
+  int me      = (int)(long)arg ;
+  int pinBase = PIN_BASE + me * 64 ;
+  int i ;
+
+  for (i = 0 ; running ; ++i)
+  {
+    digitalWrite (pinBase + (i & 7), i & 1) ;
+    (void)digitalRead (pinBase + 8) ;
+    ops [me] += 2 ;
+  }
+
+  return NULL ;
+}
+
+
+int main (int argc, char *argv [])
+{
+  pthread_t threads [MAX_CLIENTS] ;
+  int numClients = 50 ;
+  int i, total, min, max ;
+
+  if (argc < 4)
+  {
+    fprintf (stderr, "Usage: %s host port password [clients]\n", argv [0]) ;
+    return 1 ;
+  }
+
+  if (argc > 4)
+    numClients = atoi (argv [4]) ;
+
+  if ((numClients < 1) || (numClients > MAX_CLIENTS))
+  {
+    fprintf (stderr, "%s: clients must be 1-%d\n", argv [0], MAX_CLIENTS) ;
+    return 1 ;
+  }
+
+// A connection each, not all sharing the one
+
+  drcNetShare (FALSE) ;
+
+  for (i = 0 ; i < numClients ; ++i)
+    if (!drcSetupNet (PIN_BASE + i * 64, 64, argv [1], argv [2], argv [3]))
+    {
+      fprintf (stderr, "%s: Client %d unable to connect to %s:%s\n", argv [0], i, argv [1], argv [2]) ;
+      return 1 ;
+    }
+
+  printf ("%d clients connected, running for %d mS ...\n", numClients, RUN_TIME) ;
+
+  for (i = 0 ; i < numClients ; ++i)
+    pthread_create (&threads [i], NULL, client, (void *)(long)i) ;
+
+  delay (RUN_TIME) ;
+  running = FALSE ;
+
+  for (i = 0 ; i < numClients ; ++i)
+    pthread_join (threads [i], NULL) ;
+
+  total = max = 0 ;
+  min   = ops [0] ;
+  for (i = 0 ; i < numClients ; ++i)
+  {
+    total += ops [i] ;
+    if (ops [i] < min) min = ops [i] ;
+    if (ops [i] > max) max = ops [i] ;
+  }
+
+  printf ("  Total:      %10.0f ops/sec\n", total * 1000.0 / RUN_TIME) ;
+  printf ("  Per client: %10.0f ops/sec (min %.0f, max %.0f)\n",
+	total * 1000.0 / RUN_TIME / numClients, min * 1000.0 / RUN_TIME, max * 1000.0 / RUN_TIME) ;
+
+  return 0 ;
+}
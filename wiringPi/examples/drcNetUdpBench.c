@@ -0,0 +1,269 @@
+/*
+ * drcNetUdpBench.c:
+ *	Compare writes to wiringPiD over TCP and UDP, and see how the UDP
+ *	state broadcasts stand up to loss. The UDP goes through a relay in
+ *	here which drops loss% of the datagrams each way and holds some
+ *	back to arrive after newer ones. e.g. on the loopback with the
+ *	daemon started as:
+ *		wiringpid -z <password>
+ *	then
+ *		drcNetUdpBench 127.0.0.1 6124 <password> 10
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <wiringPi.h>
+#include <drcNet.h>
+
+#define	PIN_BASE	100
+#define	COUNT		20000
+#define	STATE_TIME	2000	// mS
+
+// Percent of datagrams dropped, and held back to go after the next
+
+static int loss    = 0 ;
+static int reorder = 5 ;
+
+static int front, back ;
+static struct sockaddr_storage clientAddr ;
+static socklen_t clientAddrLen = 0 ;
+
+
+/*
+ * relaySend:
+ *	Pass a datagram on, or not. held [] keeps one back to send after
+ *	the next.
+ *********************************************************************************
+ */
+
+static void relaySend (int fd, struct sockaddr *to, socklen_t toLen, char *buf, int len, char *held, int *heldLen)
+{
+  if (rand () % 100 < loss)
+    return ;
+
+  if ((*heldLen == 0) && (rand () % 100 < reorder))
+  {
+    memcpy (held, buf, len) ;
+    *heldLen = len ;
+    return ;
+  }
+
+  (void)sendto (fd, buf, len, 0, to, toLen) ;
+
+  if (*heldLen != 0)
+  {
+    (void)sendto (fd, held, *heldLen, 0, to, toLen) ;
+    *heldLen = 0 ;
+  }
+}
+
+
+/*
+ * relay:
+ *	Thread passing datagrams between us (front) and the server (back)
+ *********************************************************************************
+ */
+
+static void *relay (void *arg)
+{
+  struct pollfd polls [2] ;
+  char buf [2048], heldOut [2048], heldIn [2048] ;
+  int len, heldOutLen = 0, heldInLen = 0 ;
+
+  (void)arg ;
+
+  polls [0].fd = front ; polls [0].events = POLLIN ;
+  polls [1].fd = back  ; polls [1].events = POLLIN ;
+
+  for (;;)
+  {
+    if (poll (polls, 2, -1) <= 0)
+      continue ;
+
+    if ((polls [0].revents & POLLIN) != 0)
+    {
+      clientAddrLen = sizeof (clientAddr) ;
+      if ((len = recvfrom (front, buf, sizeof (buf), 0, (struct sockaddr *)&clientAddr, &clientAddrLen)) > 0)
+	relaySend (back, NULL, 0, buf, len, heldOut, &heldOutLen) ;
+    }
+
+    if ((polls [1].revents & POLLIN) != 0)
+    {
+      if (((len = recv (back, buf, sizeof (buf), 0)) > 0) && (clientAddrLen != 0))
+	relaySend (front, (struct sockaddr *)&clientAddr, clientAddrLen, buf, len, heldIn, &heldInLen) ;
+    }
+  }
+
+  return NULL ;
+}
+
+
+/*
+ * startRelay:
+ *	Returns the local port it's on, or -1
+ *********************************************************************************
+ */
+
+static int startRelay (const char *host, const char *port)
+{
+  struct addrinfo hints, *result ;
+  struct sockaddr_in addr ;
+  socklen_t addrLen = sizeof (addr) ;
+  pthread_t thread ;
+
+  memset (&hints, 0, sizeof (hints)) ;
+  hints.ai_family   = AF_UNSPEC ;
+  hints.ai_socktype = SOCK_DGRAM ;
+
+  if (getaddrinfo (host, port, &hints, &result) != 0)
+    return -1 ;
+
+  back = socket (result->ai_family, SOCK_DGRAM, 0) ;
+  if ((back < 0) || (connect (back, result->ai_addr, result->ai_addrlen) < 0))
+    return -1 ;
+  freeaddrinfo (result) ;
+
+  memset (&addr, 0, sizeof (addr)) ;
+  addr.sin_family      = AF_INET ;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK) ;
+
+  front = socket (AF_INET, SOCK_DGRAM, 0) ;
+  if ((front < 0) || (bind (front, (struct sockaddr *)&addr, sizeof (addr)) < 0))
+    return -1 ;
+  if (getsockname (front, (struct sockaddr *)&addr, &addrLen) < 0)
+    return -1 ;
+
+  if (pthread_create (&thread, NULL, relay, NULL) != 0)
+    return -1 ;
+
+  return ntohs (addr.sin_port) ;
+}
+
+
+/*
+ * report:
+ *	Print the operations per second for a test
+ *********************************************************************************
+ */
+
+static void report (const char *name, unsigned int start, int ops)
+{
+  unsigned int us = micros () - start ;
+
+  if (us == 0)
+    us = 1 ;
+
+  printf ("  %-24s %10.0f ops/sec\n", name, (double)ops * 1000000.0 / us) ;
+}
+
+
+/*
+ * writes:
+ *********************************************************************************
+ */
+
+static void writes (const char *name)
+{
+  unsigned int start ;
+  int i ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT ; ++i)
+    digitalWrite (PIN_BASE + (i & 7), i & 1) ;
+  drcNetFlush (PIN_BASE) ;
+  report (name, start, COUNT) ;
+}
+
+
+int main (int argc, char *argv [])
+{
+  unsigned long long bits ;
+  unsigned int states, stale, start ;
+  char relayPort [16] ;
+  int port, age, maxAge = 0, totalAge = 0, samples = 0 ;
+
+  if (argc < 4)
+  {
+    fprintf (stderr, "Usage: %s host port password [loss%%]\n", argv [0]) ;
+    return 1 ;
+  }
+
+  if (argc > 4)
+    loss = atoi (argv [4]) ;
+
+  if ((port = startRelay (argv [1], argv [2])) < 0)
+  {
+    fprintf (stderr, "%s: Unable to start the relay\n", argv [0]) ;
+    return 1 ;
+  }
+  sprintf (relayPort, "%d", port) ;
+
+  if (!drcSetupNet (PIN_BASE, 64, argv [1], argv [2], argv [3]))
+  {
+    fprintf (stderr, "%s: Unable to connect to %s:%s\n", argv [0], argv [1], argv [2]) ;
+    return 1 ;
+  }
+
+  if (drcNetUdp (PIN_BASE, relayPort, FALSE) < 0)
+    return 1 ;
+
+  printf ("%d%% loss, %d%% reordered:\n", loss, reorder) ;
+
+  writes ("digitalWrite, TCP") ;
+
+  drcNetUdp (PIN_BASE, relayPort, TRUE) ;
+  writes ("digitalWrite, UDP") ;
+
+  drcNetBatch (PIN_BASE, 1000) ;
+  writes ("digitalWrite, UDP 1mS") ;
+  drcNetBatch (PIN_BASE, 0) ;
+
+// State broadcasts every mS
+
+  if (drcNetUdpState (PIN_BASE, 64, 1) < 0)
+    return 1 ;
+
+  for (start = millis () ; millis () - start < STATE_TIME ; delay (1))
+  {
+    if ((age = drcNetUdpStateRead (PIN_BASE, &bits)) < 0)
+      continue ;
+    if (age > maxAge)
+      maxAge = age ;
+    totalAge += age ;
+    ++samples ;
+  }
+
+  drcNetUdpState (PIN_BASE, 0, 1) ;
+  drcNetUdpStats (PIN_BASE, &states, &stale) ;
+
+  printf ("  State every 1mS for %d mS: %u taken, %u stale dropped, age %.1f mS average, %d mS worst\n",
+	STATE_TIME, states, stale, samples ? (double)totalAge / samples : 0.0, maxAge) ;
+
+  return 0 ;
+}
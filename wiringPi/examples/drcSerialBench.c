@@ -0,0 +1,210 @@
+/*
+ * drcSerialBench.c:
+ *	Time the DRC serial protocol against a stand-in for the device on
+ *	a pty, one pin at a time and with the multi-pin calls. Give it a
+ *	baud rate and the stand-in takes as long as a real line would to
+ *	get the bytes over, otherwise it's the overhead at our end only.
+ *		drcSerialBench [baud]
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#define	_XOPEN_SOURCE	600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <wiringPi.h>
+#include <drcSerial.h>
+
+#define	PIN_BASE	100
+#define	PINS		32
+#define	COUNT		2000
+
+static int master ;
+static int baud = 0 ;
+static int levels [PINS] ;
+
+
+/*
+ * lineTime:
+ *	Hold on for as long as len bytes take over the line: 10 bits each
+ *********************************************************************************
+ */
+
+static void lineTime (int len)
+{
+  if (baud != 0)
+    delayMicroseconds ((unsigned int)((long long)len * 10 * 1000000 / baud)) ;
+}
+
+
+/*
+ * device:
+ *	Thread playing the part of the DRC device (e.g. an Arduino running
+ *	the DRC sketch) on the master side of the pty.
+ *********************************************************************************
+ */
+
+static void *device (void *arg)
+{
+  unsigned char in [256], out [512] ;
+  int len, pos = 0, have = 0, outLen, need, pin ;
+
+  (void)arg ;
+
+  for (;;)
+  {
+    if ((len = read (master, in + have, sizeof (in) - have)) <= 0)
+      return NULL ;
+    lineTime (len) ;
+    have += len ;
+
+    outLen = 0 ;
+    for (pos = 0 ; pos < have ; pos += need)
+    {
+      need = (in [pos] == 'v') ? 3 : (in [pos] == '@') ? 1 : 2 ;
+      if (pos + need > have)
+	break ;
+
+      pin = in [pos + 1] % PINS ;
+      switch (in [pos])
+      {
+	case '@': out [outLen++] = '@' ;			break ;
+	case '0': levels [pin] = 0 ;				break ;
+	case '1': levels [pin] = 1 ;				break ;
+	case 'r': out [outLen++] = levels [pin] ? '1' : '0' ;	break ;
+	case 'a':
+	  out [outLen++] = (pin * 10) >> 8 ;
+	  out [outLen++] = (pin * 10) & 0xFF ;
+	  break ;
+	default:						break ;
+      }
+    }
+
+    memmove (in, in + pos, have - pos) ;
+    have -= pos ;
+
+    if (outLen != 0)
+    {
+      lineTime (outLen) ;
+      (void)write (master, out, outLen) ;
+    }
+  }
+}
+
+
+/*
+ * report:
+ *	Print the time each operation took
+ *********************************************************************************
+ */
+
+static void report (const char *name, unsigned int start, int ops)
+{
+  printf ("  %-40s %8.1f uS\n", name, (double)(micros () - start) / ops) ;
+}
+
+
+int main (int argc, char *argv [])
+{
+  pthread_t thread ;
+  unsigned int start, bits = 0 ;
+  int pins [8], values [8] ;
+  int i, j ;
+
+  if (argc > 1)
+    baud = atoi (argv [1]) ;
+
+  if (((master = posix_openpt (O_RDWR | O_NOCTTY)) < 0) || (grantpt (master) < 0) || (unlockpt (master) < 0))
+  {
+    fprintf (stderr, "%s: Unable to open a pty\n", argv [0]) ;
+    return 1 ;
+  }
+
+  if (pthread_create (&thread, NULL, device, NULL) != 0)
+    return 1 ;
+
+  if (!drcSetupSerial (PIN_BASE, PINS, ptsname (master), 115200))
+  {
+    fprintf (stderr, "%s: No answer from the stand-in device\n", argv [0]) ;
+    return 1 ;
+  }
+
+  if (baud != 0)
+    printf ("%d baud:\n", baud) ;
+  else
+    printf ("No line time:\n") ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT ; ++i)
+    digitalWrite (PIN_BASE + (i & 7), i & 1) ;
+  (void)digitalRead (PIN_BASE) ;		// They're not done until the device has them
+  report ("digitalWrite", start, COUNT) ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT ; ++i)
+    (void)digitalRead (PIN_BASE + (i & 7)) ;
+  report ("digitalRead", start, COUNT) ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT / 32 ; ++i)
+    for (j = 0 ; j < 32 ; ++j)
+      bits |= digitalRead (PIN_BASE + j) << j ;
+  report ("32 pins, digitalRead each", start, COUNT / 32) ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT / 32 ; ++i)
+    bits ^= digitalRead32 (PIN_BASE) ;
+  report ("32 pins, digitalRead32", start, COUNT / 32) ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT / 32 ; ++i)
+    digitalWrite32 (PIN_BASE, i & 1 ? 0xAAAAAAAA : 0x55555555) ;
+  (void)digitalRead (PIN_BASE) ;
+  report ("32 pins, digitalWrite32", start, COUNT / 32) ;
+
+  for (i = 0 ; i < 8 ; ++i)
+    pins [i] = PIN_BASE + i * 3 ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT / 8 ; ++i)
+    for (j = 0 ; j < 8 ; ++j)
+      values [j] = analogRead (pins [j]) ;
+  report ("8 analog pins, analogRead each", start, COUNT / 8) ;
+
+  start = micros () ;
+  for (i = 0 ; i < COUNT / 8 ; ++i)
+    drcSerialAnalogReadList (pins, 8, values) ;
+  report ("8 analog pins, drcSerialAnalogReadList", start, COUNT / 8) ;
+
+  for (i = 0 ; i < 8 ; ++i)
+    if (values [i] != (pins [i] - PIN_BASE) * 10)
+      printf ("  Bad analog value: pin %d gave %d\n", pins [i], values [i]) ;
+
+  digitalWrite32 (PIN_BASE, 0x12345678) ;
+  if ((bits = digitalRead32 (PIN_BASE)) != 0x12345678)
+    printf ("  Bad digitalRead32: %08X\n", bits) ;
+
+  return 0 ;
+}
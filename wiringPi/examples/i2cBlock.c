@@ -0,0 +1,86 @@
+/*
+ * i2cBlock.c:
+ *	Read the BMP180 calibration table (22 bytes from register 0xAA) one
+ *	register at a time, as bmp180Setup used to, and as one combined
+ *	I2C_RDWR transaction. Prints the bus transactions and time taken.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <wiringPi.h>
+#include <wiringPiI2C.h>
+
+#define	BMP180_ADDRESS		0x77
+#define	CAL_REG			0xAA
+#define	CAL_SIZE		22
+#define	NUM_TIMES		100
+
+
+int main (void)
+{
+  unsigned char single [CAL_SIZE], block [CAL_SIZE] ;
+  unsigned int start, tSingle, tBlock ;
+  int fd, times, i, value ;
+
+  wiringPiSetup () ;
+
+  if ((fd = wiringPiI2CSetup (BMP180_ADDRESS)) < 0)
+  {
+    fprintf (stderr, "Can't open the I2C device: %s\n", strerror (errno)) ;
+    exit (EXIT_FAILURE) ;
+  }
+
+  start = micros () ;
+  for (times = 0 ; times < NUM_TIMES ; ++times)
+    for (i = 0 ; i < CAL_SIZE ; ++i)
+    {
+      if ((value = wiringPiI2CReadReg8 (fd, CAL_REG + i)) < 0)
+      {
+	fprintf (stderr, "I2C failure: %s\n", strerror (errno)) ;
+	exit (EXIT_FAILURE) ;
+      }
+      single [i] = value ;
+    }
+  tSingle = micros () - start ;
+
+  start = micros () ;
+  for (times = 0 ; times < NUM_TIMES ; ++times)
+    if (wiringPiI2CReadBlock (fd, CAL_REG, block, CAL_SIZE) < 0)
+    {
+      fprintf (stderr, "I2C failure: %s\n", strerror (errno)) ;
+      exit (EXIT_FAILURE) ;
+    }
+  tBlock = micros () - start ;
+
+  printf ("+----------------+--------------+--------------+\n") ;
+  printf ("|                | Transactions |    uS / read |\n") ;
+  printf ("+----------------+--------------+--------------+\n") ;
+  printf ("| Per register   | %12d | %12.1f |\n", CAL_SIZE, (double)tSingle / NUM_TIMES) ;
+  printf ("| Combined block | %12d | %12.1f |\n", 1,        (double)tBlock  / NUM_TIMES) ;
+  printf ("+----------------+--------------+--------------+\n") ;
+
+  printf ("Data %s\n", memcmp (single, block, CAL_SIZE) == 0 ? "identical" : "DIFFERS") ;
+
+  return 0 ;
+}
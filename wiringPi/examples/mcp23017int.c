@@ -0,0 +1,74 @@
+/*
+ * mcp23017int.c:
+ *	Edge callbacks on the pins of an MCP23017 with its INTA line wired
+ *	to a Pi GPIO pin: prints every change on the 16 expander inputs.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <wiringPi.h>
+#include <mcp23017.h>
+
+#define	PIN_BASE	100
+#define	MCP_ADDRESS	0x20
+#define	INT_PIN		0	// wiringPi pin the INTA line goes to
+
+
+static void pinChange (int pin, int level, unsigned long long timestamp, UNU void *userdata)
+{
+  printf ("%llu: pin %d (GP%c%d) went %s\n", timestamp, pin,
+	(pin - PIN_BASE) < 8 ? 'A' : 'B', (pin - PIN_BASE) & 7, level == HIGH ? "high" : "low") ;
+}
+
+
+int main (void)
+{
+  int pin ;
+
+  wiringPiSetup () ;
+
+  if (!mcp23017Setup (PIN_BASE, MCP_ADDRESS))
+  {
+    fprintf (stderr, "Can't set up the MCP23017\n") ;
+    exit (EXIT_FAILURE) ;
+  }
+
+  if (!mcp23017ISRSetup (PIN_BASE, INT_PIN))
+  {
+    fprintf (stderr, "Can't wire the MCP23017 interrupt to pin %d\n", INT_PIN) ;
+    exit (EXIT_FAILURE) ;
+  }
+
+  for (pin = PIN_BASE ; pin < PIN_BASE + 16 ; ++pin)
+  {
+    pinMode         (pin, INPUT) ;
+    pullUpDnControl (pin, PUD_UP) ;
+    wiringPiISRArg  (pin, INT_EDGE_BOTH, pinChange, NULL) ;
+  }
+
+  printf ("Waiting for changes on pins %d to %d\n", PIN_BASE, PIN_BASE + 15) ;
+
+  for (;;)
+    delay (1000) ;
+
+  return 0 ;
+}
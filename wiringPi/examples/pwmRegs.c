@@ -0,0 +1,117 @@
+/*
+ * pwmRegs.c:
+ *	Point the PWM registers at a plain block of memory with
+ *	pwmSetRegisters and check what pwmSetMode, pwmSetRange, pwmSetClock
+ *	and pwmWrite put in them. No hardware needed.
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <wiringPi.h>
+
+// The BCM2835 registers we look at: word offsets into the PWM and
+//	clock manager blocks
+
+#define	PWM_CONTROL	0
+#define	PWM0_RANGE	4
+#define	PWM0_DATA	5
+#define	PWM1_RANGE	8
+#define	PWM1_DATA	9
+
+#define	PWMCLK_CNTL	40
+#define	PWMCLK_DIV	41
+
+#define	PWM0_ENABLE	0x0001
+#define	PWM0_MS_MODE	0x0080
+#define	PWM1_ENABLE	0x0100
+#define	PWM1_MS_MODE	0x8000
+
+#define	BCM_PASSWORD	0x5A000000
+
+static volatile unsigned int pwmRegs [64] ;
+static volatile unsigned int clkRegs [64] ;
+static int failures = 0 ;
+
+
+/*
+ * check:
+ *	Compare a register with what we expect
+ *********************************************************************************
+ */
+
+static void check (const char *what, unsigned int got, unsigned int want)
+{
+  int ok = (got == want) ;
+
+  printf ("%-36s 0x%08X  %s\n", what, got, ok ? "OK" : "FAIL") ;
+  if (!ok)
+  {
+    printf ("%-36s 0x%08X\n", "  wanted", want) ;
+    ++failures ;
+  }
+}
+
+
+int main (void)
+{
+  pwmSetRegisters (pwmRegs, clkRegs) ;
+
+// Mode: both channels enabled, mark:space or balanced
+
+  pwmSetMode (PWM_MODE_MS) ;
+  check ("pwmSetMode (MS): CONTROL", pwmRegs [PWM_CONTROL], PWM0_ENABLE | PWM1_ENABLE | PWM0_MS_MODE | PWM1_MS_MODE) ;
+
+  pwmSetMode (PWM_MODE_BAL) ;
+  check ("pwmSetMode (BAL): CONTROL", pwmRegs [PWM_CONTROL], PWM0_ENABLE | PWM1_ENABLE) ;
+
+  pwmSetMode (PWM_MODE_MS) ;
+
+// Range: the same in both channels
+
+  pwmSetRange (1024) ;
+  check ("pwmSetRange (1024): RNG1", pwmRegs [PWM0_RANGE], 1024) ;
+  check ("pwmSetRange (1024): RNG2", pwmRegs [PWM1_RANGE], 1024) ;
+
+// Clock: divisor in DIVI, started again from the oscillator, and the
+//	PWM stopped over the change is running again after it
+
+  pwmSetClock (192) ;
+  check ("pwmSetClock (192): DIV",   clkRegs [PWMCLK_DIV],  BCM_PASSWORD | (192 << 12)) ;
+  check ("pwmSetClock (192): CNTL",  clkRegs [PWMCLK_CNTL], BCM_PASSWORD | 0x11) ;
+  check ("pwmSetClock (192): CONTROL", pwmRegs [PWM_CONTROL], PWM0_ENABLE | PWM1_ENABLE | PWM0_MS_MODE | PWM1_MS_MODE) ;
+
+  pwmSetClock (4096 + 32) ;		// Only 12 bits of divisor
+  check ("pwmSetClock (4128): DIV",  clkRegs [PWMCLK_DIV],  BCM_PASSWORD | (32 << 12)) ;
+
+// Duty: BCM pin numbers as wiringPiSetupGpio, each pin to its channel
+
+  pwmWrite (18, 300) ;
+  check ("pwmWrite (18, 300): DAT1", pwmRegs [PWM0_DATA], 300) ;
+
+  pwmWrite (19, 700) ;
+  check ("pwmWrite (19, 700): DAT2", pwmRegs [PWM1_DATA], 700) ;
+
+  pwmWrite (12, 100) ;
+  check ("pwmWrite (12, 100): DAT1", pwmRegs [PWM0_DATA], 100) ;
+  check ("pwmWrite (12, 100): DAT2", pwmRegs [PWM1_DATA], 700) ;
+
+  return (failures == 0) ? 0 : 1 ;
+}
@@ -0,0 +1,163 @@
+/*
+ * regCache.c:
+ *	Run the register cache against a stand-in for an MCP23017 that
+ *	counts the bus transactions it sees. Shows that once a register is
+ *	known, reading it again and updates that don't change it cost
+ *	nothing, while the volatile registers (GPIO, INTF, INTCAP) go to
+ *	the bus every time. No hardware needed.
+ *
+ * Copyright (c) 2012-2017 Gordon Henderson. <projects@drogon.net>
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <wiringPi.h>
+#include <wpiRegCache.h>
+#include <mcp23x0817.h>
+
+#define	COUNT	1000
+
+// The same volatile set as the mcp23017 driver
+
+#define	VOLATILE_REGS	(WPI_REGCACHE_REG (MCP23x17_GPIOA)   | WPI_REGCACHE_REG (MCP23x17_GPIOB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTFA)   | WPI_REGCACHE_REG (MCP23x17_INTFB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTCAPA) | WPI_REGCACHE_REG (MCP23x17_INTCAPB))
+
+static unsigned char regs [WPI_REGCACHE_MAX] ;
+static unsigned int  reads, writes ;
+static int failures = 0 ;
+
+
+/*
+ * busRead: busWrite:
+ *	The stand-in device
+ *********************************************************************************
+ */
+
+static int busRead (UNU struct wiringPiNodeStruct *node, int reg)
+{
+  ++reads ;
+  return regs [reg] ;
+}
+
+static int busWrite (UNU struct wiringPiNodeStruct *node, int reg, int value)
+{
+  ++writes ;
+  regs [reg] = value ;
+  return 0 ;
+}
+
+
+/*
+ * check:
+ *	Compare the transactions since the last check with what we expect
+ *********************************************************************************
+ */
+
+static void check (const char *what, unsigned int wantReads, unsigned int wantWrites)
+{
+  int ok = (reads == wantReads) && (writes == wantWrites) ;
+
+  printf ("%-44s %5u reads %5u writes  %s\n", what, reads, writes, ok ? "OK" : "FAIL") ;
+  if (!ok)
+    ++failures ;
+
+  reads = writes = 0 ;
+}
+
+
+int main (void)
+{
+  struct wpiRegCacheStruct *cache ;
+  int i, value ;
+
+  regs [MCP23x17_IODIRA] = regs [MCP23x17_IODIRB] = 0xFF ;
+
+  if ((cache = wpiRegCacheNew (NULL, busRead, busWrite, VOLATILE_REGS)) == NULL)
+    return 1 ;
+
+// The first read of each register has to go to the device
+
+  (void)wpiRegCacheRead (cache, MCP23x17_IODIRA) ;
+  (void)wpiRegCacheRead (cache, MCP23x17_OLATA) ;
+  check ("First reads of IODIRA, OLATA", 2, 0) ;
+
+  for (i = 0 ; i < COUNT ; ++i)
+  {
+    (void)wpiRegCacheRead (cache, MCP23x17_IODIRA) ;
+    (void)wpiRegCacheRead (cache, MCP23x17_OLATA) ;
+  }
+  check ("Cached reads of IODIRA, OLATA", 0, 0) ;
+
+// pinMode and digitalWrite: the first change is written, the rest
+//	already hold
+
+  (void)wpiRegCacheUpdate (cache, MCP23x17_IODIRA, 0x01, 0x00) ;
+  (void)wpiRegCacheUpdate (cache, MCP23x17_OLATA,  0x01, 0x01) ;
+  check ("Updates changing IODIRA, OLATA", 0, 2) ;
+
+  for (i = 0 ; i < COUNT ; ++i)
+  {
+    (void)wpiRegCacheUpdate (cache, MCP23x17_IODIRA, 0x01, 0x00) ;
+    (void)wpiRegCacheUpdate (cache, MCP23x17_OLATA,  0x01, 0x01) ;
+  }
+  check ("Unchanged updates of IODIRA, OLATA", 0, 0) ;
+
+  if ((regs [MCP23x17_IODIRA] != 0xFE) || (regs [MCP23x17_OLATA] != 0x01))
+  {
+    printf ("Device holds IODIRA %02X, OLATA %02X\n", regs [MCP23x17_IODIRA], regs [MCP23x17_OLATA]) ;
+    ++failures ;
+  }
+
+// The pins change under us, so GPIO is read every time and writes to
+//	it always go out
+
+  for (i = 0 ; i < COUNT ; ++i)
+  {
+    regs [MCP23x17_GPIOA] = i & 0xFF ;
+    if ((value = wpiRegCacheRead (cache, MCP23x17_GPIOA)) != (i & 0xFF))
+    {
+      printf ("GPIOA read %02X, device has %02X\n", value, i & 0xFF) ;
+      ++failures ;
+      break ;
+    }
+  }
+  check ("Reads of GPIOA", COUNT, 0) ;
+
+  for (i = 0 ; i < COUNT ; ++i)
+    (void)wpiRegCacheWrite (cache, MCP23x17_GPIOA, 0x55) ;
+  check ("Same value written to GPIOA", 0, COUNT) ;
+
+  for (i = 0 ; i < COUNT ; ++i)
+    (void)wpiRegCacheUpdate (cache, MCP23x17_INTCAPA, 0x01, 0x00) ;
+  check ("Unchanged updates of INTCAPA", COUNT, COUNT) ;
+
+// After a device reset nothing is known
+
+  wpiRegCacheInvalidate (cache) ;
+  (void)wpiRegCacheRead (cache, MCP23x17_IODIRA) ;
+  check ("Read of IODIRA after invalidate", 1, 0) ;
+
+  printf ("Cache counted %u reads, %u writes\n", cache->busReads, cache->busWrites) ;
+
+  free (cache) ;
+
+  return (failures == 0) ? 0 : 1 ;
+}
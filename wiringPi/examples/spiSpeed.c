@@ -58,7 +58,7 @@ void spiSetup (int speed)
 
 int main (void)
 {
-  int speed, times, size ;
+  int speed, times, size, bufsiz ;
   unsigned int start, end ;
   int spiFail ;
   unsigned char *myData ;
@@ -72,17 +72,22 @@ int main (void)
 
   wiringPiSetup () ;
 
+// Transfers above the spidev buffer size are split by the library
+
+  bufsiz = wiringPiSPIBufferSize () ;
+  printf ("spidev buffer size: %d bytes\n\n", bufsiz) ;
+
   for (speed = 1 ; speed <= 32 ; speed *= 2)
   {
-    printf ("+-------+--------+----------+----------+-----------+------------+\n") ;
-    printf ("|   MHz |   Size | mS/Trans |      TpS |    Mb/Sec | Latency mS |\n") ;
-    printf ("+-------+--------+----------+----------+-----------+------------+\n") ;
+    printf ("+-------+--------+--------+----------+----------+-----------+------------+\n") ;
+    printf ("|   MHz |   Size | Ioctls | mS/Trans |      TpS |    Mb/Sec | Latency mS |\n") ;
+    printf ("+-------+--------+--------+----------+----------+-----------+------------+\n") ;
 
     spiFail = FALSE ;
     spiSetup (speed * 1000000) ;
     for (size = 1 ; size <= MAX_SIZE ; size *= 2)
     {
-      printf ("| %5d | %6d ", speed, size) ;
+      printf ("| %5d | %6d | %6d ", speed, size, (size + bufsiz - 1) / bufsiz) ;
 
       start = millis () ;
       for (times = 0 ; times < NUM_TIMES ; ++times)
@@ -110,7 +115,7 @@ int main (void)
     }
 
     close (myFd) ;
-    printf ("+-------+--------+----------+----------+-----------+------------+\n") ;
+    printf ("+-------+--------+--------+----------+----------+-----------+------------+\n") ;
     printf ("\n") ;
   }
 
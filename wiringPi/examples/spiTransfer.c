@@ -0,0 +1,103 @@
+/*
+ * spiTransfer.c:
+ *	Compare SPI transactions built from one ioctl per segment with the
+ *	same transactions handed to the kernel as a single multi-segment
+ *	ioctl. Prints the number of ioctl system calls and the time taken.
+ *	Run under "strace -c -e trace=ioctl" to confirm the counts.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+
+#define	SPI_CHAN		0
+#define	SPI_SPEED		4000000
+#define	NUM_TIMES		1000
+#define	SEG_SIZE		3
+
+static unsigned char myData [WPI_SPI_MAX_SEGMENTS][SEG_SIZE] ;
+
+
+int main (void)
+{
+  struct wiringPiSPISegment segments [WPI_SPI_MAX_SEGMENTS] ;
+  int fd, count, times, i ;
+  unsigned int start, single, multi ;
+
+  wiringPiSetup () ;
+
+  if ((fd = wiringPiSPISetup (SPI_CHAN, SPI_SPEED)) < 0)
+  {
+    fprintf (stderr, "Can't open the SPI bus: %s\n", strerror (errno)) ;
+    exit (EXIT_FAILURE) ;
+  }
+
+  for (i = 0 ; i < WPI_SPI_MAX_SEGMENTS ; ++i)
+  {
+    segments [i].tx       = myData [i] ;
+    segments [i].rx       = myData [i] ;
+    segments [i].len      = SEG_SIZE ;
+    segments [i].speed    = 0 ;
+    segments [i].delayUs  = 0 ;
+    segments [i].bits     = 0 ;
+    segments [i].csChange = 1 ;		// Each segment is a separate device transaction
+  }
+
+  printf ("+----------+-------------+-------------+------------+------------+\n") ;
+  printf ("| Segments | ioctl/1-seg | ioctl/n-seg | uS/Trans 1 | uS/Trans n |\n") ;
+  printf ("+----------+-------------+-------------+------------+------------+\n") ;
+
+  for (count = 1 ; count <= WPI_SPI_MAX_SEGMENTS ; count *= 2)
+  {
+    start = micros () ;
+    for (times = 0 ; times < NUM_TIMES ; ++times)
+      for (i = 0 ; i < count ; ++i)
+	if (wiringPiSPIDataRW (SPI_CHAN, myData [i], SEG_SIZE) < 0)
+	{
+	  printf ("SPI failure: %s\n", strerror (errno)) ;
+	  exit (EXIT_FAILURE) ;
+	}
+    single = micros () - start ;
+
+    start = micros () ;
+    for (times = 0 ; times < NUM_TIMES ; ++times)
+      if (wiringPiSPITransfer (SPI_CHAN, segments, count) < 0)
+      {
+	printf ("SPI failure: %s\n", strerror (errno)) ;
+	exit (EXIT_FAILURE) ;
+      }
+    multi = micros () - start ;
+
+    printf ("| %8d | %11d | %11d | %10.1f | %10.1f |\n", count,
+	count * NUM_TIMES, NUM_TIMES,
+	(double)single / NUM_TIMES, (double)multi / NUM_TIMES) ;
+  }
+
+  printf ("+----------+-------------+-------------+------------+------------+\n") ;
+
+  close (fd) ;
+  return 0 ;
+}
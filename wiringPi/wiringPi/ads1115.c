@@ -129,21 +129,17 @@ static const uint16_t gains [6] =
 
 
 /*
- * analogRead:
- *	Pin is the channel to sample on the device.
- *	Channels 0-3 are single ended inputs,
- *	channels 4-7 are the various differential combinations.
+ * ads1115Config:
+ *	Build the configuration register to start a single conversion of
+ *	a channel. Channels 0-3 are single ended inputs, channels 4-7 are
+ *	the various differential combinations.
  *********************************************************************************
  */
 
-static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+static uint16_t ads1115Config (struct wiringPiNodeStruct *node, int chan)
 {
-  int chan = pin - node->pinBase ;
-  int16_t  result ;
   uint16_t config = CONFIG_DEFAULT ;
 
-  chan &= 7 ;
-
 // Setup the configuration register
 
 //	Set PGA/voltage range
@@ -160,7 +156,7 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 
   config &= ~CONFIG_MUX_MASK ;
 
-  switch (chan)
+  switch (chan & 7)
   {
     case 0: config |= CONFIG_MUX_SINGLE_0 ; break ;
     case 1: config |= CONFIG_MUX_SINGLE_1 ; break ;
@@ -176,8 +172,45 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 //	Start a single conversion
 
   config |= CONFIG_OS_SINGLE ;
-  config = __bswap_16 (config) ;
-  wiringPiI2CWriteReg16 (node->fd, 1, config) ;
+  return __bswap_16 (config) ;
+}
+
+
+/*
+ * ads1115Result:
+ *	Read the conversion register
+ *********************************************************************************
+ */
+
+static int ads1115Result (struct wiringPiNodeStruct *node, int chan)
+{
+  int16_t result ;
+
+  result =  wiringPiI2CReadReg16 (node->fd, 0) ;
+  result = __bswap_16 (result) ;
+
+// Sometimes with a 0v input on a single-ended channel the internal 0v reference
+//	can be higher than the input, so you get a negative result...
+
+  if ( ((chan & 7) < 4) && (result < 0) ) 
+    return 0 ;
+  else
+    return (int)result ;
+}
+
+
+/*
+ * analogRead:
+ *	Pin is the channel to sample on the device.
+ *********************************************************************************
+ */
+
+static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+{
+  int chan = pin - node->pinBase ;
+  int16_t  result ;
+
+  wiringPiI2CWriteReg16 (node->fd, 1, ads1115Config (node, chan)) ;
 
 // Wait for the conversion to complete
 
@@ -190,16 +223,39 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
     delayMicroseconds (100) ;
   }
 
-  result =  wiringPiI2CReadReg16 (node->fd, 0) ;
-  result = __bswap_16 (result) ;
+  return ads1115Result (node, chan) ;
+}
 
-// Sometimes with a 0v input on a single-ended channel the internal 0v reference
-//	can be higher than the input, so you get a negative result...
 
-  if ( (chan < 4) && (result < 0) ) 
-    return 0 ;
-  else
-    return (int)result ;
+/*
+ * myPollStart: myPollFetch:
+ *	Split reads for wpiPoll: start the conversion and come back after
+ *	one sample period at the data rate in use.
+ *********************************************************************************
+ */
+
+static const int samplesPerSecond [8] = { 8, 16, 32, 64, 128, 250, 475, 860 } ;
+
+static int myPollStart (struct wiringPiNodeStruct *node, int pin)
+{
+  if (wiringPiI2CWriteReg16 (node->fd, 1, ads1115Config (node, pin - node->pinBase)) < 0)
+    return -1 ;
+
+  return 1000000 / samplesPerSecond [(node->data1 & CONFIG_DR_MASK) >> 5] + 100 ;
+}
+
+static int myPollFetch (struct wiringPiNodeStruct *node, int pin, int *value)
+{
+  int config ;
+
+  if ((config = wiringPiI2CReadReg16 (node->fd, 1)) < 0)
+    return -1 ;
+
+  if ((__bswap_16 (config) & CONFIG_OS_MASK) == 0)	// Not done yet
+    return 100 ;
+
+  *value = ads1115Result (node, pin - node->pinBase) ;
+  return 0 ;
 }
 
 
@@ -277,7 +333,7 @@ int ads1115Setup (const int pinBase, int i2cAddr)
   struct wiringPiNodeStruct *node ;
   int fd ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddr)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddr)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 8) ;
@@ -288,6 +344,8 @@ int ads1115Setup (const int pinBase, int i2cAddr)
   node->analogRead   = myAnalogRead ;
   node->analogWrite  = myAnalogWrite ;
   node->digitalWrite = myDigitalWrite ;
+  node->pollStart    = myPollStart ;
+  node->pollFetch    = myPollFetch ;
 
   return TRUE ;
 }
@@ -59,47 +59,32 @@ static double c5, c6, mc, md, x0, x1, x2, yy0, yy1, yy2, p0, p1, p2 ;
 // Pressure & Temp variables
 
 uint32_t cPress, cTemp ;
+static double fTemp ;		// Needed to calculate the pressure
 
 static int altitude ;
 
 /*
- * read16:
- *	Quick hack to read the 16-bit data with the correct endian
+ * get16:
+ *	Pick a big-endian 16-bit value out of a block read
  *********************************************************************************
  */
 
-uint16_t read16 (int fd, int reg)
+static uint16_t get16 (const uint8_t *data, int index)
 {
-  return (wiringPiI2CReadReg8 (fd, reg) <<  8) | wiringPiI2CReadReg8 (fd, reg + 1) ;
-
+  return (data [index * 2] << 8) | data [index * 2 + 1] ;
 }
 
 
 /*
- * bmp180ReadTempPress:
- *	Does the hard work of reading the sensor
+ * bmp180CalcTemp: bmp180CalcPress:
+ *	Calculate the temperature and pressure from the raw data. The
+ *	pressure needs the temperature, so read that first.
  *********************************************************************************
  */
 
-static void bmp180ReadTempPress (int fd)
+static void bmp180CalcTemp (const uint8_t *data)
 {
-  double fTemp, fPress ;
   double tu, a ;
-  double pu, s, x, y, z ;
-
-  uint8_t data [4] ;
-
-// Start a temperature sensor reading
-
-  wiringPiI2CWriteReg8 (fd, 0xF4, 0x2E) ;
-  delay (5) ;
-
-// Read the raw data
-
-  data [0] = wiringPiI2CReadReg8 (fd, 0xF6) ;
-  data [1] = wiringPiI2CReadReg8 (fd, 0xF7) ;
-
-// And calculate...
 
   tu = (data [0] * 256.0) + data [1] ;
 
@@ -110,19 +95,12 @@ static void bmp180ReadTempPress (int fd)
 #ifdef	DEBUG
   printf ("fTemp: %f, cTemp: %6d\n", fTemp, cTemp) ;
 #endif
+}
 
-// Start a pressure snsor reading
-
-  wiringPiI2CWriteReg8 (fd, 0xF4, 0x34 | (BMP180_OSS << 6)) ;
-  delay (5) ;
-
-// Read the raw data
-
-  data [0] = wiringPiI2CReadReg8 (fd, 0xF6) ;
-  data [1] = wiringPiI2CReadReg8 (fd, 0xF7) ;
-  data [2] = wiringPiI2CReadReg8 (fd, 0xF8) ;
-
-// And calculate...
+static void bmp180CalcPress (const uint8_t *data)
+{
+  double fPress ;
+  double pu, s, x, y, z ;
 
   pu = ((double)data [0] * 256.0) + (double)data [1] + ((double)data [2] / 256.0) ;
   s = fTemp - 25.0 ;
@@ -138,6 +116,57 @@ static void bmp180ReadTempPress (int fd)
 }
 
 
+/*
+ * bmp180ReadTempPress:
+ *	Does the hard work of reading the sensor
+ *********************************************************************************
+ */
+
+static void bmp180ReadTempPress (int fd)
+{
+  uint8_t data [4] ;
+
+// Start a temperature sensor reading
+
+  wiringPiI2CWriteReg8 (fd, 0xF4, 0x2E) ;
+  delay (5) ;
+
+// Read the raw data and calculate
+
+  wiringPiI2CReadBlock (fd, 0xF6, data, 2) ;
+  bmp180CalcTemp (data) ;
+
+// Start a pressure snsor reading
+
+  wiringPiI2CWriteReg8 (fd, 0xF4, 0x34 | (BMP180_OSS << 6)) ;
+  delay (5) ;
+
+// Read the raw data and calculate
+
+  wiringPiI2CReadBlock (fd, 0xF6, data, 3) ;
+  bmp180CalcPress (data) ;
+}
+
+
+/*
+ * bmp180Value:
+ *	The value of a channel from the last reading
+ *********************************************************************************
+ */
+
+static int bmp180Value (int chan)
+{
+  /**/ if (chan == 0)	// Read Temperature
+    return cTemp ;
+  else if (chan == 1)	// Pressure
+    return cPress ;
+  else if (chan == 2)	// Pressure in mB
+    return cPress / pow (1 - ((double)altitude / 44330.0), 5.255) ;
+  else
+    return -9999 ;
+}
+
+
 /*
  * myAnalogWrite:
  *	Write to a fake register to represent the height above sea level
@@ -160,19 +189,62 @@ static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
 
 static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 {
-  int chan = pin - node->pinBase ;
-
   bmp180ReadTempPress (node->fd) ;
 
-  /**/ if (chan == 0)	// Read Temperature
-    return cTemp ;
-  else if (chan == 1)	// Pressure
-    return cPress ;
-  else if (chan == 2)	// Pressure in mB
-    return cPress / pow (1 - ((double)altitude / 44330.0), 5.255) ;
-  else
-    return -9999 ;
+  return bmp180Value (pin - node->pinBase) ;
+}
+
+
+/*
+ * myPollStart: myPollFetch:
+ *	Split reads for wpiPoll: the conversion runs while the bus does
+ *	other work. Every channel starts with a temperature conversion as
+ *	the pressure needs a current temperature; the pressure channels
+ *	then fetch it and go on to convert the pressure.
+ *********************************************************************************
+ */
+
+static int pressPending ;
+
+static int myPollStart (struct wiringPiNodeStruct *node, UNU int pin)
+{
+  pressPending = FALSE ;
 
+  if (wiringPiI2CWriteReg8 (node->fd, 0xF4, 0x2E) < 0)
+    return -1 ;
+
+  return 5000 ;
+}
+
+static int myPollFetch (struct wiringPiNodeStruct *node, int pin, int *value)
+{
+  int chan = pin - node->pinBase ;
+  uint8_t data [4] ;
+
+  if (!pressPending)
+  {
+    if (wiringPiI2CReadBlock (node->fd, 0xF6, data, 2) < 0)
+      return -1 ;
+    bmp180CalcTemp (data) ;
+
+    if (chan != 0)
+    {
+      if (wiringPiI2CWriteReg8 (node->fd, 0xF4, 0x34 | (BMP180_OSS << 6)) < 0)
+	return -1 ;
+      pressPending = TRUE ;
+      return 5000 ;
+    }
+  }
+  else
+  {
+    if (wiringPiI2CReadBlock (node->fd, 0xF6, data, 3) < 0)
+      return -1 ;
+    bmp180CalcPress (data) ;
+    pressPending = FALSE ;
+  }
+
+  *value = bmp180Value (chan) ;
+  return 0 ;
 }
 
 
@@ -188,31 +260,40 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 int bmp180Setup (const int pinBase)
 {
   double c3, c4, b1 ;
+  uint8_t cal [22] ;
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (I2C_ADDRESS)) < 0)
+  if ((fd = wiringPiI2COpen (-1, I2C_ADDRESS)) < 0)
+    return FALSE ;
+
+// Read calibration data: 11 big-endian words from 0xAA in one transaction
+
+  if (wiringPiI2CReadBlock (fd, 0xAA, cal, sizeof (cal)) < 0)
+  {
+    wiringPiI2CClose (fd) ;
     return FALSE ;
+  }
 
   node = wiringPiNewNode (pinBase, 4) ;
 
   node->fd          = fd ;
   node->analogRead  = myAnalogRead ;
   node->analogWrite = myAnalogWrite ;
-
-// Read calibration data
-
-  AC1 = read16 (fd, 0xAA) ;
-  AC2 = read16 (fd, 0xAC) ;
-  AC3 = read16 (fd, 0xAE) ;
-  AC4 = read16 (fd, 0xB0) ;
-  AC5 = read16 (fd, 0xB2) ;
-  AC6 = read16 (fd, 0xB4) ;
-  VB1 = read16 (fd, 0xB6) ;
-  VB2 = read16 (fd, 0xB8) ;
-   MB = read16 (fd, 0xBA) ;
-   MC = read16 (fd, 0xBC) ;
-   MD = read16 (fd, 0xBE) ;
+  node->pollStart   = myPollStart ;
+  node->pollFetch   = myPollFetch ;
+
+  AC1 = get16 (cal,  0) ;
+  AC2 = get16 (cal,  1) ;
+  AC3 = get16 (cal,  2) ;
+  AC4 = get16 (cal,  3) ;
+  AC5 = get16 (cal,  4) ;
+  AC6 = get16 (cal,  5) ;
+  VB1 = get16 (cal,  6) ;
+  VB2 = get16 (cal,  7) ;
+   MB = get16 (cal,  8) ;
+   MC = get16 (cal,  9) ;
+   MD = get16 (cal, 10) ;
 
 // Calculate coefficients
 
@@ -23,10 +23,17 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <string.h>
@@ -38,32 +45,49 @@
 #include "drcNet.h"
 #include "../wiringPiD/drcNetCmd.h"
 
+// mS to wait for a server to answer, and between reconnect attempts
+
+#define	CONNECT_TIMEOUT	2000
+#define	RECONNECT_MIN	100
+#define	RECONNECT_MAX	5000
+
 
 /*
  * remoteReadline:
  *	Read in a line of data from the remote server, ending with a newline
  *	character which is not stored. Returns the length or < 0 on
  *	any sort of failure.
+ *	We look at what's arrived without taking it, then take up to and
+ *	including the newline - two calls a line rather than one a byte,
+ *	and nothing of what comes after the line is lost.
  *********************************************************************************
  */
 
 static int remoteReadline (int fd, char *buf, int max)
 {
-  int  len = 0 ;
-  char c ;
+  char *nl ;
+  int  len = 0, got, take ;
 
-  for (;;)
+  while (len < max)
   {
-    if (read (fd, &c, 1) < 1)
+    if ((got = recv (fd, buf + len, max - len, MSG_PEEK)) < 1)
+      return -1 ;
+
+    if ((nl = memchr (buf + len, '\n', got)) != NULL)
+      take = nl - (buf + len) + 1 ;
+    else
+      take = got ;
+
+    if (recv (fd, buf + len, take, 0) != take)
       return -1 ;
 
-    if (c == '\n')
-      return len ;
+    if (nl != NULL)
+      return len + take - 1 ;
 
-    *buf++ = c ;
-    if (++len == max)
-      return len ;
+    len += take ;
   }
+
+  return len ;
 }
 
 
@@ -71,20 +95,26 @@ static int remoteReadline (int fd, char *buf, int max)
  * getChallenge:
  *	Read in lines from the remote site until we get one identified
  *	as the challenge. This line contains the password salt.
+ *	Servers newer than protocol 1 say which protocol they talk on the way.
  *********************************************************************************
  */
 
-static char *getChallenge (int fd)
+static char *getChallenge (int fd, int *protocol)
 {
   static char buf [1024] ;
   int num ;
 
+  *protocol = 1 ;
+
   for (;;)
   {
     if ((num = remoteReadline (fd, buf, 1023)) < 0)
       return NULL ;
     buf [num] = 0 ;
 
+    if (strncmp (buf, "200 Protocol ", 13) == 0)
+      *protocol = atoi (&buf [13]) ;
+
     if (strncmp (buf, "Challenge ", 10) == 0)
       return &buf [10] ;
   }
@@ -97,18 +127,29 @@ static char *getChallenge (int fd)
  *	and send it back to the server. Wait for a reply back from the server
  *	to say that we're good to go.
  *	The server will simply disconnect on a bad response. No 3 chances here.
+ *	A session token from an earlier connection, if we have one and the
+ *	server takes them, goes back instead - it's a lot quicker than crypt.
  *********************************************************************************
  */
 
-static int authenticate (int fd, const char *pass)
+static int authenticate (int fd, const char *pass, const uint32_t *session, int *protocol)
 {
   char *challenge ;
   char *encrypted ;
   char salted [1024] ;
+  char response [87] ;
 
-  if ((challenge = getChallenge (fd)) == NULL)
+  if ((challenge = getChallenge (fd, protocol)) == NULL)
     return -1 ;
 
+  if ((session != NULL) && ((session [0] | session [1] | session [2] | session [3]) != 0) && (*protocol >= 5))
+  {
+    memset (response, DRCN_RESUME, 86) ;
+    sprintf (response + 1, "%08x%08x%08x%08x", session [0], session [1], session [2], session [3]) ;
+    response [33] = DRCN_RESUME ;
+    return (write (fd, response, 86) == 86) ? 0 : -1 ;
+  }
+
   sprintf (salted, "$6$%s$", challenge) ;
   encrypted = crypt (pass, salted) ;
   
@@ -132,17 +173,119 @@ static int authenticate (int fd, const char *pass)
 
 
 /*
- * _drcSetupNet:
+ * getSession:
+ *	Ask for a session token to get back in with next time. Its reply is
+ *	also the first sign the server took our password.
+ *********************************************************************************
+ */
+
+static int getSession (int fd, uint32_t *session)
+{
+  struct drcNetComStruct frame ;
+
+  frame.pin  = 0 ;
+  frame.cmd  = DRCN_SESSION ;
+  frame.data = 0 ;
+
+  if ((send (fd, &frame, sizeof (frame), MSG_NOSIGNAL) != sizeof (frame)) ||
+      (recv (fd, &frame, sizeof (frame), MSG_WAITALL) != sizeof (frame))  ||
+      (recv (fd, session, 16, MSG_WAITALL) != 16))
+    return -1 ;
+
+  if (frame.data != 0)		// Server couldn't make one
+    memset (session, 0, 16) ;
+
+  return 0 ;
+}
+
+
+/*
+ * connectTimeout:
+ *	connect, but give up after ms rather than whenever TCP does.
+ *********************************************************************************
+ */
+
+static int connectTimeout (int fd, const struct sockaddr *addr, socklen_t addrLen, int ms)
+{
+  struct pollfd polls ;
+  socklen_t errLen = sizeof (int) ;
+  int flags = fcntl (fd, F_GETFL), err = 0 ;
+
+  (void)fcntl (fd, F_SETFL, flags | O_NONBLOCK) ;
+
+  if (connect (fd, addr, addrLen) < 0)
+  {
+    if (errno != EINPROGRESS)
+      return -1 ;
+
+    polls.fd     = fd ;
+    polls.events = POLLOUT ;
+
+    if (poll (&polls, 1, ms) != 1)
+    {
+      errno = ETIMEDOUT ;
+      return -1 ;
+    }
+
+    if ((getsockopt (fd, SOL_SOCKET, SO_ERROR, &err, &errLen) < 0) || (err != 0))
+    {
+      errno = err ;
+      return -1 ;
+    }
+  }
+
+  return fcntl (fd, F_SETFL, flags) ;
+}
+
+
+/*
+ * setOptions:
+ *	Socket options for a connection in use. Writes go out without
+ *	waiting for a reply, so don't let Nagle hold the next send back
+ *	until the server gets round to acknowledging them, and find out in
+ *	seconds, not minutes, when the server has gone away.
+ *********************************************************************************
+ */
+
+static int setOptions (int fd)
+{
+  struct timeval tv = { 0, 0 } ;
+  int len   = sizeof (struct drcNetComStruct) ;
+  int on    = 1 ;
+  int idle  = 5, interval = 1, count = 3 ;
+  int userTimeout = 5000 ;
+
+  if ((setsockopt (fd, SOL_SOCKET,  SO_RCVTIMEO,      &tv,          sizeof (tv))          < 0) ||
+      (setsockopt (fd, SOL_SOCKET,  SO_RCVLOWAT,      &len,         sizeof (len))         < 0) ||
+      (setsockopt (fd, IPPROTO_TCP, TCP_NODELAY,      &on,          sizeof (on))          < 0) ||
+      (setsockopt (fd, SOL_SOCKET,  SO_KEEPALIVE,     &on,          sizeof (on))          < 0))
+    return -1 ;
+
+  (void)setsockopt (fd, IPPROTO_TCP, TCP_KEEPIDLE,     &idle,        sizeof (idle)) ;
+  (void)setsockopt (fd, IPPROTO_TCP, TCP_KEEPINTVL,    &interval,    sizeof (interval)) ;
+  (void)setsockopt (fd, IPPROTO_TCP, TCP_KEEPCNT,      &count,       sizeof (count)) ;
+  (void)setsockopt (fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &userTimeout, sizeof (userTimeout)) ;
+
+  return 0 ;
+}
+
+
+/*
+ * netConnect:
  *	Do the hard work of establishing a network connection and authenticating
- *	the password.
+ *	the password, or the session token if session [] has one. With a
+ *	protocol 5 server, session [] comes back with a new token, or zeros.
+ *	Returns the socket, or -1 with errno EACCES if the server turned us
+ *	away, or something else if we couldn't get to it.
  *********************************************************************************
  */
 
-int _drcSetupNet (const char *ipAddress, const char *port, const char *password)
+static int netConnect (const char *ipAddress, const char *port, const char *password, uint32_t *session, int *protocol)
 {
   struct addrinfo hints;
   struct addrinfo *result, *rp ;
   struct in6_addr serveraddr ;
+  struct timeval tv ;
   int remoteFd ;
 
 // Start by seeing if we've been given a (textual) numeric IP address
@@ -180,225 +323,1655 @@ int _drcSetupNet (const char *ipAddress, const char *port, const char *password)
     if ((remoteFd = socket (rp->ai_family, rp->ai_socktype, rp->ai_protocol)) < 0)
       continue ;
 
-    if (connect (remoteFd, rp->ai_addr, rp->ai_addrlen) < 0)
+    if (connectTimeout (remoteFd, rp->ai_addr, rp->ai_addrlen, CONNECT_TIMEOUT) < 0)
+    {
+      close (remoteFd) ;
       continue ;
+    }
 
-    if (authenticate (remoteFd, password) < 0)
+    freeaddrinfo (result) ;
+
+// Don't wait forever on a server that takes the connection but says nothing
+
+    tv.tv_sec  = CONNECT_TIMEOUT / 1000 ;
+    tv.tv_usec = (CONNECT_TIMEOUT % 1000) * 1000 ;
+    (void)setsockopt (remoteFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof (tv)) ;
+
+    if ((authenticate (remoteFd, password, session, protocol) < 0) ||
+	((session != NULL) && (*protocol >= 5) && (getSession (remoteFd, session) < 0)))
     {
       close (remoteFd) ;
       errno = EACCES ;		// Permission denied
       return -1 ;
     }
-    else
-      return remoteFd ;
+
+    if ((session != NULL) && (*protocol < 5))
+      memset (session, 0, 16) ;
+
+    if (setOptions (remoteFd) < 0)
+    {
+      close (remoteFd) ;
+      return -1 ;
+    }
+
+    return remoteFd ;
   }
 
+  freeaddrinfo (result) ;
+
   errno = EHOSTUNREACH ;	// Host unreachable - may not be right, but good enough
   return -1 ; // Nothing connected
 }
 
 
 /*
- * myPinMode:
- *	Change the pin mode on the remote DRC device
+ * _drcSetupNet:
+ *	Connect and authenticate, returning the socket
  *********************************************************************************
  */
 
-static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
+int _drcSetupNet (const char *ipAddress, const char *port, const char *password, int *protocol)
+{
+  return netConnect (ipAddress, port, password, NULL, protocol) ;
+}
+
+
+/*
+ * Per-connection state, hung off node->priv.
+ *	With a protocol 2 server, writes are sent without asking for a reply
+ *	and collect in batch [] until a read needs a round trip, the batch
+ *	fills, or the flush timer goes off - at once if there's no timer.
+ *	Reads go out behind them in the same send, carrying a sequence
+ *	number so their replies can be checked off.
+ *	Once anything is subscribed to, events can turn up at any time, so
+ *	a reader thread takes in everything from the server, handing the
+ *	replies to the waiting read and the events to a thread which runs
+ *	the callbacks - where they're free to use the node themselves.
+ *	With an older server every command waits for its reply, as before.
+ *	Nodes on the same server, port and password share a connection.
+ *	When it's lost, everything done on it fails straight away - counted
+ *	for drcNetStatus - while a thread reconnects in the background,
+ *	with the session token if the server gave us one.
+ *********************************************************************************
+ */
+
+#define	MAX_BATCH	64
+#define	MAX_WORDS	(MAX_BATCH * 3)	// As 32-bit words, payloads and all
+#define	MAX_SUBS	64
+#define	EVENT_RING	256		// Power of 2
+
+struct drcNetConnStruct
+{
+  int          fd ;
+  int          protocol ;
+  int          serverProtocol ;		// What the server offered, protocol may be less
+  unsigned int seq ;
+  unsigned int batchUs ;		// 0: No timer, writes go straight out
+  int          pending ;		// Words in batch []
+  int          flusher ;		// Flush timer thread started
+  struct timespec deadline ;		// When the oldest pending write has to go
+  pthread_mutex_t lock ;
+  pthread_cond_t  wake ;
+  uint32_t     batch [MAX_WORDS] ;
+
+// Reader and event threads, started by the first subscription
+
+  int          reader ;
+  int          readerRunning ;		// Until it sees the connection go
+  int          reading ;		// A read is waiting on its replies
+  int          numReplies ;		// Words in replies []
+  unsigned int eventHead, eventTail, eventsLost ;
+  pthread_cond_t replied ;
+  pthread_cond_t events ;
+  uint32_t     replies [MAX_WORDS] ;
+  struct drcNetComStruct eventRing [EVENT_RING] ;
+
+  int numSubs ;
+  struct
+  {
+    int   pin ;				// On the server
+    int   clientPin ;
+    int   mode ;
+    void (*function)(int pin, int level, unsigned long long timestamp, void *userdata) ;
+    void *userdata ;
+  } subs [MAX_SUBS] ;
+
+// UDP, once opened: the datagram being put together, and the last
+//	state broadcast taken in
+
+  int          udpFd ;
+  int          udpWrites ;		// Writes DRCN_UDP_OK allows go by UDP
+  uint32_t     udpToken, udpSeq ;
+  int          udpLen ;			// Bytes in udpBuf []
+  char         udpBuf [DRCN_UDP_MAX] ;
+
+  int          haveState ;
+  uint32_t     statePin, stateSeq ;
+  int          stateCount ;
+  unsigned int statePeriod ;
+  unsigned long long stateBits ;
+  struct timespec stateWhen ;
+  unsigned int states, statesStale ;
+
+// Who we're connected to, to get back to them, and for other nodes
+//	to share the connection. node is the first node on it.
+
+  char        *host, *port, *password ;
+  uint32_t     session [4] ;
+  int          down ;			// Lost, reconnecting
+  int          reconnecting ;		// Reconnect thread running
+  unsigned int failures ;		// Commands failed since drcNetStatus last asked
+  struct wiringPiNodeStruct *node ;
+  struct drcNetConnStruct   *next ;
+} ;
+
+static struct drcNetConnStruct *conns = NULL ;
+static pthread_mutex_t connsLock = PTHREAD_MUTEX_INITIALIZER ;
+static int shareConns = TRUE ;
+
+static void *reconnect (void *arg) ;
+
+
+/*
+ * connLost:
+ *	Something done on the connection failed. Make it fail anything else
+ *	tried on it straight away, wake the reader and any read waiting on
+ *	it, and start reconnecting. Called with the lock held.
+ *********************************************************************************
+ */
+
+static void connLost (struct drcNetConnStruct *conn)
 {
-  struct drcNetComStruct cmd ;
+  pthread_t thread ;
+
+  ++conn->failures ;
+
+  if (conn->down)
+    return ;
+
+  conn->down    = TRUE ;
+  conn->pending = 0 ;
+  conn->udpLen  = 0 ;
+
+  (void)shutdown (conn->fd, SHUT_RDWR) ;
+  pthread_cond_broadcast (&conn->replied) ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_PIN_MODE ;
-  cmd.data = mode ;
+  (void)wiringPiFailure (WPI_ALMOST, "drcNet: Lost the connection to %s:%s - reconnecting\n", conn->host, conn->port) ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  if (!conn->reconnecting && (pthread_create (&thread, NULL, reconnect, conn) == 0))
+  {
+    pthread_detach (thread) ;
+    conn->reconnecting = TRUE ;
+  }
 }
 
 
 /*
- * myPullUpDnControl:
+ * udpSend:
+ *	Send the datagram put together in udpBuf [], giving it the next
+ *	sequence number. Nothing comes back to say if it got there.
+ *	Called with the lock held.
  *********************************************************************************
  */
 
-static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
+static int udpSend (struct drcNetConnStruct *conn)
 {
-  struct drcNetComStruct cmd ;
+  struct drcNetUdpStruct header ;
+  int len = conn->udpLen ;
+
+  conn->udpLen = 0 ;
+
+  if (len == 0)
+    return 0 ;
+
+  header.token = conn->udpToken ;
+  header.seq   = ++conn->udpSeq ;
+  memcpy (conn->udpBuf, &header, sizeof (header)) ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_PULL_UP_DN ;
-  cmd.data = mode ;
+  if (send (conn->udpFd, conn->udpBuf, len, MSG_NOSIGNAL) != len)
+  {
+    ++conn->failures ;
+    return -1 ;
+  }
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  return 0 ;
 }
 
 
 /*
- * myDigitalWrite:
+ * udpQueue:
+ *	Add a write to the datagram being put together. Called with the
+ *	lock held.
  *********************************************************************************
  */
 
-static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
+static void udpQueue (struct drcNetConnStruct *conn, int pin, int cmd, int data, const uint32_t *payload, int words)
+{
+  uint32_t frame [3] ;
+
+  if (conn->udpLen + DRCN_FRAME_LEN + words * 4 > DRCN_UDP_MAX)
+    (void)udpSend (conn) ;
+
+  if (conn->udpLen == 0)
+    conn->udpLen = sizeof (struct drcNetUdpStruct) ;
+
+  frame [0] = pin ;
+  frame [1] = cmd | DRCN_NO_REPLY ;
+  frame [2] = data ;
+
+  memcpy (conn->udpBuf + conn->udpLen, frame, DRCN_FRAME_LEN) ;
+  memcpy (conn->udpBuf + conn->udpLen + DRCN_FRAME_LEN, payload, words * 4) ;
+  conn->udpLen += DRCN_FRAME_LEN + words * 4 ;
+}
+
+
+/*
+ * sendBatch:
+ *	Send everything in the batch, and any datagram put together.
+ *	Called with the lock held.
+ *********************************************************************************
+ */
+
+static int sendBatch (struct drcNetConnStruct *conn)
 {
-  struct drcNetComStruct cmd ;
+  int len = conn->pending * 4 ;
+
+  if (conn->udpLen > 0)
+    (void)udpSend (conn) ;
+
+  conn->pending = 0 ;
+
+  if (len == 0)
+    return 0 ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_DIGITAL_WRITE ;
-  cmd.data = value ;
+  if (conn->down || (send (conn->fd, conn->batch, len, MSG_NOSIGNAL) != len))
+  {
+    connLost (conn) ;
+    return -1 ;
+  }
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  return 0 ;
 }
 
 
 /*
- * myDigitalWrite8:
+ * queueCmd:
+ *	Add a command and any payload words to the batch, giving it the next
+ *	sequence number. Called with the lock held.
  *********************************************************************************
+ */
 
-static void myDigitalWrite8 (struct wiringPiNodeStruct *node, int pin, int value)
+static void queueCmd (struct drcNetConnStruct *conn, int pin, int cmd, int data, int noReply, const uint32_t *payload, int words)
 {
-  struct drcNetComStruct cmd ;
+  uint32_t *frame ;
+
+  if (conn->pending + 3 + words > MAX_WORDS)
+    (void)sendBatch (conn) ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_DIGITAL_WRITE8 ;
-  cmd.data = value ;
+  frame = &conn->batch [conn->pending] ;
+  frame [0] = pin ;
+  frame [1] = cmd | ((conn->seq++ & 0xFFFF) << DRCN_SEQ_SHIFT) | (noReply ? DRCN_NO_REPLY : 0) ;
+  frame [2] = data ;
+  memcpy (&frame [3], payload, words * 4) ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  conn->pending += 3 + words ;
 }
+
+
+/*
+ * flushTimer:
+ *	Thread sending writes which have been waiting batchUs with no read
+ *	coming along to take them.
+ *********************************************************************************
  */
 
+static void *flushTimer (void *arg)
+{
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)arg ;
+
+  pthread_mutex_lock (&conn->lock) ;
+  for (;;)
+  {
+    while (((conn->pending == 0) && (conn->udpLen == 0)) || (conn->batchUs == 0))
+      pthread_cond_wait (&conn->wake, &conn->lock) ;
+
+    if (pthread_cond_timedwait (&conn->wake, &conn->lock, &conn->deadline) == ETIMEDOUT)
+      (void)sendBatch (conn) ;
+  }
+
+  return NULL ;
+}
+
 
 /*
- * myAnalogWrite:
+ * queueWrite: drcWrite:
+ *	Send a command we don't need anything back from. queueWrite is
+ *	called with the lock held and leaves the batch for the caller to
+ *	send when there is no flush timer. Payloads are for protocol 3 only.
+ *	Once asked to, the writes that can go by UDP do.
  *********************************************************************************
  */
 
-static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
+static void queueWrite (struct wiringPiNodeStruct *node, int pin, int cmd, int data, const uint32_t *payload, int words)
 {
-  struct drcNetComStruct cmd ;
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)node->priv ;
+  struct drcNetComStruct frame ;
+
+  if (conn->down)
+  {
+    ++conn->failures ;
+    return ;
+  }
+
+  if (conn->protocol < 2)
+  {
+    frame.pin  = pin - node->pinBase ;
+    frame.cmd  = cmd ;
+    frame.data = data ;
+
+    if (send (conn->fd, &frame, sizeof (frame), MSG_NOSIGNAL) != sizeof (frame))
+      connLost (conn) ;
+    else if (((cmd != DRCN_PULL_UP_DN) || (conn->serverProtocol >= 2)) &&	// Protocol 1 servers never reply to this
+	     (recv (conn->fd, &frame, sizeof (frame), MSG_WAITALL) != sizeof (frame)))
+      connLost (conn) ;
+    return ;
+  }
+
+  if ((conn->pending == 0) && (conn->udpLen == 0) && (conn->batchUs != 0))
+  {
+    clock_gettime (CLOCK_REALTIME, &conn->deadline) ;
+    conn->deadline.tv_nsec += conn->batchUs * 1000L ;
+    conn->deadline.tv_sec  += conn->deadline.tv_nsec / 1000000000L ;
+    conn->deadline.tv_nsec %= 1000000000L ;
+    pthread_cond_signal (&conn->wake) ;
+  }
+
+  frame.cmd = cmd ;
+  if (conn->udpWrites && DRCN_UDP_OK (&frame))
+    udpQueue (conn, pin - node->pinBase, cmd, data, payload, words) ;
+  else
+    queueCmd (conn, pin - node->pinBase, cmd, data, TRUE, payload, words) ;
+}
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_ANALOG_WRITE ;
-  cmd.data = value ;
+static void drcWrite (struct wiringPiNodeStruct *node, int pin, int cmd, int data)
+{
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)node->priv ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  pthread_mutex_lock (&conn->lock) ;
+    queueWrite (node, pin, cmd, data, NULL, 0) ;
+    if (conn->batchUs == 0)
+      (void)sendBatch (conn) ;
+  pthread_mutex_unlock (&conn->lock) ;
 }
 
 
 /*
- * myPwmWrite:
+ * netReader:
+ *	Thread taking in everything the server sends once we have subscribed
+ *	to events, until the connection goes. It's started again on the new
+ *	one.
  *********************************************************************************
  */
 
-static void myPwmWrite (struct wiringPiNodeStruct *node, int pin, int value)
+static void *netReader (void *arg)
 {
-  struct drcNetComStruct cmd ;
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)arg ;
+  struct drcNetComStruct frame ;
+  uint32_t payload [DRCN_MAX_LIST] ;
+  int words = 0 ;
+
+  for (;;)
+  {
+    if (recv (conn->fd, &frame, sizeof (frame), MSG_WAITALL) == sizeof (frame))
+    {
+      words = DRCN_REPLY_WORDS (&frame) ;
+      if ((words < 0) || (words > DRCN_MAX_LIST))
+	words = -1 ;
+      else if ((words > 0) && (recv (conn->fd, payload, words * 4, MSG_WAITALL) != words * 4))
+	words = -1 ;
+    }
+    else
+      words = -1 ;
+
+    if (words < 0)
+    {
+      pthread_mutex_lock (&conn->lock) ;
+	connLost (conn) ;
+	conn->readerRunning = FALSE ;
+	pthread_cond_broadcast (&conn->replied) ;
+      pthread_mutex_unlock (&conn->lock) ;
+      return NULL ;
+    }
+
+    pthread_mutex_lock (&conn->lock) ;
+
+    if ((frame.cmd & DRCN_CMD_MASK) == DRCN_EVENT)
+    {
+      if ((conn->eventHead - conn->eventTail) < EVENT_RING)
+      {
+	conn->eventRing [conn->eventHead++ & (EVENT_RING - 1)] = frame ;
+	pthread_cond_signal (&conn->events) ;
+      }
+      else
+	++conn->eventsLost ;
+    }
+    else if (conn->reading && (conn->numReplies + 3 + words <= MAX_WORDS))
+    {
+      memcpy (&conn->replies [conn->numReplies],     &frame,  DRCN_FRAME_LEN) ;
+      memcpy (&conn->replies [conn->numReplies + 3], payload, words * 4) ;
+      conn->numReplies += 3 + words ;
+      pthread_cond_broadcast (&conn->replied) ;
+    }
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_PWM_WRITE ;
-  cmd.data = value ;
+    pthread_mutex_unlock (&conn->lock) ;
+  }
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  return NULL ;
 }
 
 
 /*
- * myAnalogRead:
+ * startReader:
+ *	Called with the lock held
  *********************************************************************************
  */
 
-static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+static int startReader (struct drcNetConnStruct *conn)
 {
-  struct drcNetComStruct cmd ;
+  pthread_t thread ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_ANALOG_READ ;
-  cmd.data = 0 ;
+  if (pthread_create (&thread, NULL, netReader, conn) != 0)
+    return -1 ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+  pthread_detach (thread) ;
+  conn->readerRunning = TRUE ;
 
-  return cmd.data ;
+  return 0 ;
 }
 
 
 /*
- * myDigitalRead:
+ * netEvents:
+ *	Thread running the callbacks for the events the reader takes in.
  *********************************************************************************
  */
 
-static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
+static void *netEvents (void *arg)
 {
-  struct drcNetComStruct cmd ;
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)arg ;
+  struct drcNetComStruct event ;
+  void (*function)(int pin, int level, unsigned long long timestamp, void *userdata) ;
+  void *userdata = NULL ;
+  unsigned long long timestamp ;
+  int i, pin = 0 ;
+
+  pthread_mutex_lock (&conn->lock) ;
+
+  for (;;)
+  {
+    while (conn->eventHead == conn->eventTail)
+      pthread_cond_wait (&conn->events, &conn->lock) ;
+
+    event = conn->eventRing [conn->eventTail++ & (EVENT_RING - 1)] ;
+
+    function = NULL ;
+    for (i = 0 ; i < conn->numSubs ; ++i)
+      if (conn->subs [i].pin == (int)event.pin)
+      {
+	function = conn->subs [i].function ;
+	userdata = conn->subs [i].userdata ;
+	pin      = conn->subs [i].clientPin ;
+	break ;
+      }
+
+    if (function == NULL)
+      continue ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_DIGITAL_READ ;
-  cmd.data = 0 ;
+    timestamp = ((unsigned long long)(event.cmd >> DRCN_SEQ_SHIFT) << 32) | event.data ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+    pthread_mutex_unlock (&conn->lock) ;
+      function (pin, (event.cmd & DRCN_EVENT_HIGH) ? HIGH : LOW, timestamp, userdata) ;
+    pthread_mutex_lock (&conn->lock) ;
+  }
 
-  return cmd.data ;
+  return NULL ;
 }
 
 
 /*
- * myDigitalRead8:
+ * udpReader:
+ *	Thread taking in the state broadcasts once UDP is opened, keeping
+ *	the newest.
  *********************************************************************************
+ */
 
-static unsigned int myDigitalRead8 (struct wiringPiNodeStruct *node, int pin)
+static void *udpReader (void *arg)
 {
-  struct drcNetComStruct cmd ;
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)arg ;
+  struct drcNetUdpStruct header ;
+  struct drcNetComStruct frame ;
+  uint32_t bits [2] ;
+  char buf [DRCN_UDP_MAX] ;
+  int len ;
+
+  for (;;)
+  {
+    if ((len = recv (conn->udpFd, buf, sizeof (buf), 0)) < 0)
+    {
+      if ((errno == EINTR) || (errno == ECONNREFUSED))	// The latter from an earlier send
+	continue ;
+      return NULL ;
+    }
+
+    if (len != (int)sizeof (header) + DRCN_FRAME_LEN + 8)
+      continue ;
+
+    memcpy (&header, buf, sizeof (header)) ;
+    memcpy (&frame,  buf + sizeof (header), DRCN_FRAME_LEN) ;
+    memcpy (bits,    buf + sizeof (header) + DRCN_FRAME_LEN, 8) ;
+
+    if ((frame.cmd & DRCN_CMD_MASK) != DRCN_READ_ALL)
+      continue ;
 
-  cmd.pin  = pin - node->pinBase ;
-  cmd.cmd  = DRCN_DIGITAL_READ8 ;
-  cmd.data = 0 ;
+    pthread_mutex_lock (&conn->lock) ;
 
-  (void)send (node->fd, &cmd, sizeof (cmd), 0) ;
-  (void)recv (node->fd, &cmd, sizeof (cmd), 0) ;
+    if ((header.token != conn->udpToken) || (frame.pin != conn->statePin))
+      ;
+    else if (conn->haveState && ((int32_t)(header.seq - conn->stateSeq) <= 0))
+      ++conn->statesStale ;
+    else
+    {
+      conn->haveState = TRUE ;
+      conn->stateSeq  = header.seq ;
+      conn->stateBits = bits [0] | ((unsigned long long)bits [1] << 32) ;
+      clock_gettime (CLOCK_MONOTONIC, &conn->stateWhen) ;
+      ++conn->states ;
+    }
+
+    pthread_mutex_unlock (&conn->lock) ;
+  }
 
-  return cmd.data ;
+  return NULL ;
 }
+
+
+/*
+ * recvReplies:
+ *	Get the num words of replies to the commands just sent, from the
+ *	socket or from the reader thread if it's running. Called with the
+ *	lock held.
+ *********************************************************************************
  */
 
+static int recvReplies (struct drcNetConnStruct *conn, uint32_t *replies, int num)
+{
+  int len = num * 4 ;
+
+  if (!conn->reader)
+  {
+    if (recv (conn->fd, replies, len, MSG_WAITALL) == len)
+      return 0 ;
+    connLost (conn) ;
+    return -1 ;
+  }
+
+  while ((conn->numReplies < num) && !conn->down)
+    pthread_cond_wait (&conn->replied, &conn->lock) ;
+
+  if (conn->numReplies < num)
+    return -1 ;
+
+  memcpy (replies, conn->replies, len) ;
+  conn->numReplies = 0 ;
+
+  return 0 ;
+}
+
 
 /*
- * drcNet:
- *	Create a new instance of an DRC GPIO interface.
- *	Could be a variable nunber of pins here - we might not know in advance.
+ * drcRead:
+ *	Send num commands with the same cmd for consecutive pins and wait for
+ *	all their replies. values [] has the data to send with each, and
+ *	comes back with the data from each reply.
+ *	Any writes still waiting go out first in the same send.
+ *	Returns 0, or -1 on a network failure or out of step reply - after
+ *	which the connection is no good and is made again.
  *********************************************************************************
  */
 
-int drcSetupNet (const int pinBase, const int numPins, const char *ipAddress, const char *port, const char *password)
+static int drcRead (struct wiringPiNodeStruct *node, int pin, int cmd, int num, unsigned int values [])
 {
-  int fd, len ;
-  struct wiringPiNodeStruct *node ;
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)node->priv ;
+  struct drcNetComStruct replies [32] ;
+  unsigned int seq ;
+  int i, result = 0 ;
+
+  pthread_mutex_lock (&conn->lock) ;
+
+  if (conn->down)
+  {
+    ++conn->failures ;
+    pthread_mutex_unlock (&conn->lock) ;
+    return -1 ;
+  }
+
+  if (conn->protocol < 2)
+  {
+    for (i = 0 ; i < num ; ++i)
+    {
+      replies [i].pin  = pin - node->pinBase + i ;
+      replies [i].cmd  = cmd ;
+      replies [i].data = values [i] ;
+
+      if ((send (conn->fd, &replies [i], sizeof (replies [i]), MSG_NOSIGNAL) != sizeof (replies [i])) ||
+	  (recv (conn->fd, &replies [i], sizeof (replies [i]), MSG_WAITALL) != sizeof (replies [i])))
+      {
+	connLost (conn) ;
+	result = -1 ;
+	break ;
+      }
+      values [i] = replies [i].data ;
+    }
+    pthread_mutex_unlock (&conn->lock) ;
+    return result ;
+  }
 
-  if ((fd = _drcSetupNet (ipAddress, port, password)) < 0)
-    return FALSE ;
+// With the reader running, the lock is let go while waiting for the
+//	replies, so keep other reads out until we have ours
 
-  len = sizeof (struct drcNetComStruct) ;
+  while (conn->reading)
+    pthread_cond_wait (&conn->replied, &conn->lock) ;
+  conn->reading    = TRUE ;
+  conn->numReplies = 0 ;
 
-  if (setsockopt (fd, SOL_SOCKET, SO_RCVLOWAT, (void *)&len, sizeof (len)) < 0)
-    return FALSE ;
+  if (conn->pending + num * 3 > MAX_WORDS)
+    (void)sendBatch (conn) ;
 
-  node = wiringPiNewNode (pinBase, numPins) ;
+  seq = conn->seq ;
+  for (i = 0 ; i < num ; ++i)
+    queueCmd (conn, pin - node->pinBase + i, cmd, values [i], FALSE, NULL, 0) ;
 
-  node->fd               = fd ;
-  node->pinMode          = myPinMode ;
-  node->pullUpDnControl  = myPullUpDnControl ;
-  node->analogRead       = myAnalogRead ;
+  if ((sendBatch (conn) < 0) || (recvReplies (conn, (uint32_t *)replies, num * 3) < 0))
+    result = -1 ;
+  else
+  {
+    for (i = 0 ; i < num ; ++i)
+    {
+      if ((replies [i].cmd >> DRCN_SEQ_SHIFT) != ((seq + i) & 0xFFFF))
+      {
+	connLost (conn) ;
+	result = -1 ;
+	break ;
+      }
+      values [i] = replies [i].data ;
+    }
+  }
+
+  conn->reading = FALSE ;
+  pthread_cond_broadcast (&conn->replied) ;
+
+  pthread_mutex_unlock (&conn->lock) ;
+  return result ;
+}
+
+
+/*
+ * drcBulk:
+ *	Send one of the commands with a payload and wait for the reply.
+ *	*data goes with the command and comes back with the data of the
+ *	reply, and the replyWords of payload that follow it go in reply [].
+ *	Returns 0, or -1 on a network failure or out of step reply.
+ *********************************************************************************
+ */
+
+static int drcBulk (struct wiringPiNodeStruct *node, int pin, int cmd, uint32_t *data, const uint32_t *payload, int words, uint32_t *reply, int replyWords)
+{
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)node->priv ;
+  uint32_t replies [3 + DRCN_MAX_LIST] ;
+  unsigned int seq ;
+  int result = 0 ;
+
+  pthread_mutex_lock (&conn->lock) ;
+
+  if (conn->down)
+  {
+    ++conn->failures ;
+    pthread_mutex_unlock (&conn->lock) ;
+    return -1 ;
+  }
+
+  while (conn->reading)
+    pthread_cond_wait (&conn->replied, &conn->lock) ;
+  conn->reading    = TRUE ;
+  conn->numReplies = 0 ;
+
+  seq = conn->seq ;
+  queueCmd (conn, pin - node->pinBase, cmd, *data, FALSE, payload, words) ;
+
+  if ((sendBatch (conn) < 0) || (recvReplies (conn, replies, 3 + replyWords) < 0))
+    result = -1 ;
+  else if ((replies [1] >> DRCN_SEQ_SHIFT) != (seq & 0xFFFF))
+  {
+    connLost (conn) ;
+    result = -1 ;
+  }
+  else
+  {
+    *data = replies [2] ;
+    memcpy (reply, &replies [3], replyWords * 4) ;
+  }
+
+  conn->reading = FALSE ;
+  pthread_cond_broadcast (&conn->replied) ;
+
+  pthread_mutex_unlock (&conn->lock) ;
+  return result ;
+}
+
+
+/*
+ * myPinMode:
+ *	Change the pin mode on the remote DRC device
+ *********************************************************************************
+ */
+
+static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
+{
+  drcWrite (node, pin, DRCN_PIN_MODE, mode) ;
+}
+
+
+/*
+ * myPullUpDnControl:
+ *********************************************************************************
+ */
+
+static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
+{
+  drcWrite (node, pin, DRCN_PULL_UP_DN, mode) ;
+}
+
+
+/*
+ * myDigitalWrite:
+ *********************************************************************************
+ */
+
+static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
+{
+  drcWrite (node, pin, DRCN_DIGITAL_WRITE, value) ;
+}
+
+
+/*
+ * myAnalogWrite:
+ *********************************************************************************
+ */
+
+static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
+{
+  drcWrite (node, pin, DRCN_ANALOG_WRITE, value) ;
+}
+
+
+/*
+ * myPwmWrite:
+ *********************************************************************************
+ */
+
+static void myPwmWrite (struct wiringPiNodeStruct *node, int pin, int value)
+{
+  drcWrite (node, pin, DRCN_PWM_WRITE, value) ;
+}
+
+
+/*
+ * myAnalogRead:
+ *********************************************************************************
+ */
+
+static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+{
+  unsigned int value = 0 ;
+
+  (void)drcRead (node, pin, DRCN_ANALOG_READ, 1, &value) ;
+
+  return value ;
+}
+
+
+/*
+ * myDigitalRead:
+ *********************************************************************************
+ */
+
+static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
+{
+  unsigned int value = 0 ;
+
+  (void)drcRead (node, pin, DRCN_DIGITAL_READ, 1, &value) ;
+
+  return value ;
+}
+
+
+/*
+ * myDigitalReadPins:
+ *	Read a run of pins with all the requests in the one send, rather
+ *	than one round trip per pin - or with the one request to a protocol
+ *	3 server.
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPins (struct wiringPiNodeStruct *node, int pin, int width)
+{
+  unsigned int values [32] ;
+  unsigned int bits = 0 ;
+  uint32_t data, reply [2] ;
+  int i ;
+
+  if (pin + width - 1 > node->pinMax)
+    width = node->pinMax - pin + 1 ;
+
+  data = width ;
+  if (((struct drcNetConnStruct *)node->priv)->protocol >= 3)
+    return (drcBulk (node, pin, DRCN_READ_ALL, &data, NULL, 0, reply, 2) < 0) ? 0 : reply [0] ;
+
+  memset (values, 0, sizeof (values)) ;
+
+  if (drcRead (node, pin, DRCN_DIGITAL_READ, width, values) < 0)
+    return 0 ;
+
+  for (i = 0 ; i < width ; ++i)
+    if (values [i] != LOW)
+      bits |= 1U << i ;
+
+  return bits ;
+}
+
+static unsigned int myDigitalRead8  (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin,  8) ; }
+static unsigned int myDigitalRead16 (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin, 16) ; }
+static unsigned int myDigitalRead32 (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin, 32) ; }
+
+
+/*
+ * myDigitalWritePins:
+ *	Write a run of pins, again in the one send when the server lets us.
+ *********************************************************************************
+ */
+
+static void myDigitalWritePins (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)node->priv ;
+  uint32_t payload [4] ;
+  int i ;
+
+  if (pin + width - 1 > node->pinMax)
+    width = node->pinMax - pin + 1 ;
+
+  payload [0] = 0xFFFFFFFFU >> (32 - width) ;
+  payload [1] = 0 ;
+  payload [2] = value & payload [0] ;
+  payload [3] = 0 ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    if (conn->protocol >= 3)
+      queueWrite (node, pin, DRCN_WRITE_MASKED, 0, payload, 4) ;
+    else
+      for (i = 0 ; i < width ; ++i)
+	queueWrite (node, pin + i, DRCN_DIGITAL_WRITE, (value >> i) & 1, NULL, 0) ;
+    if (conn->batchUs == 0)
+      (void)sendBatch (conn) ;
+  pthread_mutex_unlock (&conn->lock) ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value, 32) ; }
+
+
+/*
+ * drcNetFlush:
+ *	Send any batched writes and wait until the server has done them.
+ *	Returns 0, or -1 if the connection has failed.
+ *********************************************************************************
+ */
+
+int drcNetFlush (const int pinBase)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pinBase) ;
+  unsigned int dummy = 0 ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetFlush: No DRC network node at pin %d\n", pinBase) ;
+
+  if (((struct drcNetConnStruct *)node->priv)->protocol < 2)		// Nothing is ever batched
+    return 0 ;
+
+  return drcRead (node, pinBase, DRCN_NOP, 1, &dummy) ;
+}
+
+
+/*
+ * drcNetBatch:
+ *	Hold writes back for up to us microseconds so they go out together,
+ *	behind the next read if one comes along sooner. 0 (the default)
+ *	sends every write straight away, still without waiting for a reply.
+ *	Has no effect with a protocol 1 server.
+ *********************************************************************************
+ */
+
+int drcNetBatch (const int pinBase, const unsigned int us)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pinBase) ;
+  struct drcNetConnStruct *conn ;
+  pthread_t thread ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetBatch: No DRC network node at pin %d\n", pinBase) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  pthread_mutex_lock (&conn->lock) ;
+
+  if ((us != 0) && !conn->flusher)
+  {
+    if (pthread_create (&thread, NULL, flushTimer, conn) != 0)
+    {
+      pthread_mutex_unlock (&conn->lock) ;
+      return wiringPiFailure (WPI_ALMOST, "drcNetBatch: Unable to start flush thread: %s\n", strerror (errno)) ;
+    }
+    pthread_detach (thread) ;
+    conn->flusher = TRUE ;
+  }
+
+  (void)sendBatch (conn) ;
+  conn->batchUs = us ;
+
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetSubscribe:
+ *	Have the server push the edges of a pin to us as they happen, rather
+ *	than us polling it. The function is called with the pin, level and
+ *	server timestamp (uS) of each edge matching the INT_EDGE_ mode, from
+ *	a thread of its own. A NULL function stops them.
+ *	Needs a protocol 2 server which can take interrupts on the pin.
+ *	Subscriptions are made again on a new connection after one is lost,
+ *	but any edges in between are missed.
+ *********************************************************************************
+ */
+
+int drcNetSubscribe (const int pin, const int mode, void (*function)(int pin, int level, unsigned long long timestamp, void *userdata), void *userdata)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  struct drcNetConnStruct *conn ;
+  pthread_t thread ;
+  unsigned int result ;
+  int i ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: No DRC network node at pin %d\n", pin) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  if (conn->protocol < 2)
+    return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: Server can't send events\n") ;
+
+  pthread_mutex_lock (&conn->lock) ;
+
+  if (!conn->reader)
+  {
+    if (startReader (conn) < 0)
+    {
+      pthread_mutex_unlock (&conn->lock) ;
+      return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: Unable to start reader thread: %s\n", strerror (errno)) ;
+    }
+
+    if (pthread_create (&thread, NULL, netEvents, conn) == 0)
+      pthread_detach (thread) ;
+    conn->reader = TRUE ;
+  }
+
+// Take note of the callback first, the first event can follow the reply
+
+  for (i = 0 ; i < conn->numSubs ; ++i)
+    if (conn->subs [i].pin == pin - node->pinBase)
+      break ;
+
+  if (function == NULL)
+  {
+    if (i < conn->numSubs)
+      conn->subs [i] = conn->subs [--conn->numSubs] ;
+  }
+  else
+  {
+    if (i == MAX_SUBS)
+    {
+      pthread_mutex_unlock (&conn->lock) ;
+      return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: Too many pins subscribed\n") ;
+    }
+    if (i == conn->numSubs)
+      ++conn->numSubs ;
+
+    conn->subs [i].pin       = pin - node->pinBase ;
+    conn->subs [i].clientPin = pin ;
+    conn->subs [i].mode      = mode ;
+    conn->subs [i].function  = function ;
+    conn->subs [i].userdata  = userdata ;
+  }
+
+  pthread_mutex_unlock (&conn->lock) ;
+
+  result = (function == NULL) ? 0 : mode ;
+
+  if (drcRead (node, pin, DRCN_SUBSCRIBE, 1, &result) < 0)
+    return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: Lost the connection to the server\n") ;
+
+  if (result != 0)
+  {
+    (void)drcNetSubscribe (pin, 0, NULL, NULL) ;
+    return wiringPiFailure (WPI_ALMOST, "drcNetSubscribe: Server can't take interrupts on pin %d\n", pin) ;
+  }
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetDigitalWriteMasked:
+ *	Write the pins from pin up with their bit set in mask, up to 64 of
+ *	them, to the levels of their bits in value. One command to a protocol
+ *	3 server, otherwise a write per pin.
+ *********************************************************************************
+ */
+
+int drcNetDigitalWriteMasked (const int pin, const unsigned long long mask, const unsigned long long value)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  struct drcNetConnStruct *conn ;
+  uint32_t payload [4] ;
+  int i ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetDigitalWriteMasked: No DRC network node at pin %d\n", pin) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  payload [0] = (uint32_t)mask ;
+  payload [1] = (uint32_t)(mask >> 32) ;
+  payload [2] = (uint32_t)value ;
+  payload [3] = (uint32_t)(value >> 32) ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    if (conn->protocol >= 3)
+      queueWrite (node, pin, DRCN_WRITE_MASKED, 0, payload, 4) ;
+    else
+      for (i = 0 ; (i < 64) && (pin + i <= node->pinMax) ; ++i)
+	if ((mask >> i) & 1)
+	  queueWrite (node, pin + i, DRCN_DIGITAL_WRITE, (value >> i) & 1, NULL, 0) ;
+    if (conn->batchUs == 0)
+      (void)sendBatch (conn) ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetDigitalReadAll:
+ *	Read count pins (1-64) from pin into the bits of *bits in one round
+ *	trip. Bit 0 is pin.
+ *********************************************************************************
+ */
+
+int drcNetDigitalReadAll (const int pin, const int count, unsigned long long *bits)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  unsigned int values [32] ;
+  uint32_t data = count, reply [2] ;
+  int i, j, width ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetDigitalReadAll: No DRC network node at pin %d\n", pin) ;
+
+  if ((count < 1) || (count > 64))
+    return wiringPiFailure (WPI_ALMOST, "drcNetDigitalReadAll: count must be 1-64 (%d)\n", count) ;
+
+  if (((struct drcNetConnStruct *)node->priv)->protocol >= 3)
+  {
+    if (drcBulk (node, pin, DRCN_READ_ALL, &data, NULL, 0, reply, 2) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetDigitalReadAll: Lost the connection to the server\n") ;
+    *bits = reply [0] | ((unsigned long long)reply [1] << 32) ;
+    return 0 ;
+  }
+
+  *bits = 0 ;
+  for (i = 0 ; i < count ; i += 32)
+  {
+    width = (count - i > 32) ? 32 : count - i ;
+    memset (values, 0, sizeof (values)) ;
+    if (drcRead (node, pin + i, DRCN_DIGITAL_READ, width, values) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetDigitalReadAll: Lost the connection to the server\n") ;
+    for (j = 0 ; j < width ; ++j)
+      if (values [j] != LOW)
+	*bits |= 1ULL << (i + j) ;
+  }
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetAnalogReadList:
+ *	Read num (up to 32) analog pins, all on the same server, into values []
+ *	in one round trip. The pins needn't be consecutive.
+ *********************************************************************************
+ */
+
+int drcNetAnalogReadList (const int pins [], const int num, int values [])
+{
+  struct wiringPiNodeStruct *node ;
+  uint32_t data = num, payload [DRCN_MAX_LIST] ;
+  int i ;
+
+  if ((num < 1) || (num > DRCN_MAX_LIST))
+    return wiringPiFailure (WPI_ALMOST, "drcNetAnalogReadList: num must be 1-%d (%d)\n", DRCN_MAX_LIST, num) ;
+
+  node = wiringPiFindNode (pins [0]) ;
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetAnalogReadList: No DRC network node at pin %d\n", pins [0]) ;
+
+  for (i = 0 ; i < num ; ++i)
+  {
+    if ((pins [i] < node->pinBase) || (pins [i] > node->pinMax))
+      return wiringPiFailure (WPI_ALMOST, "drcNetAnalogReadList: pin %d is not on the same node as pin %d\n", pins [i], pins [0]) ;
+    payload [i] = pins [i] - node->pinBase ;
+  }
+
+  if (((struct drcNetConnStruct *)node->priv)->protocol < 3)
+  {
+    for (i = 0 ; i < num ; ++i)
+      values [i] = myAnalogRead (node, pins [i]) ;
+    return 0 ;
+  }
+
+  if (drcBulk (node, node->pinBase, DRCN_ANALOG_READ_LIST, &data, payload, num, payload, num) < 0)
+    return wiringPiFailure (WPI_ALMOST, "drcNetAnalogReadList: Lost the connection to the server\n") ;
+
+  for (i = 0 ; i < num ; ++i)
+    values [i] = (int)payload [i] ;
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetUdp:
+ *	Open UDP to the server, on port if not NULL, else the port of the
+ *	TCP connection, and send the writes that can go that way by UDP
+ *	or not. These are the digital, analog and PWM writes, where a lost
+ *	one is put right by the next and all that matters is the newest -
+ *	one older than the last the server took in is dropped. Everything
+ *	else keeps to TCP, and there's nothing to stop a UDP write getting
+ *	there before a TCP command sent ahead of it, other than the
+ *	drcNetFlush done here before the writes go over.
+ *	Needs a protocol 4 server.
+ *********************************************************************************
+ */
+
+int drcNetUdp (const int pinBase, const char *port, const int writes)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pinBase) ;
+  struct drcNetConnStruct *conn ;
+  struct sockaddr_storage addr ;
+  socklen_t addrLen = sizeof (addr) ;
+  unsigned int token = 0 ;
+  pthread_t thread ;
+  int fd, portNum ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdp: No DRC network node at pin %d\n", pinBase) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  if (conn->protocol < 4)
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Server can't do UDP\n") ;
+
+  if (conn->udpFd < 0)
+  {
+    if (drcRead (node, pinBase, DRCN_UDP_OPEN, 1, &token) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Lost the connection to the server\n") ;
+    if (token == 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Server has no UDP\n") ;
+
+    if (getpeername (conn->fd, (struct sockaddr *)&addr, &addrLen) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: getpeername failed: %s\n", strerror (errno)) ;
+
+    if (port != NULL)
+    {
+      if ((portNum = atoi (port)) <= 0)
+	return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Bad port: %s\n", port) ;
+      if (addr.ss_family == AF_INET)
+	((struct sockaddr_in  *)&addr)->sin_port  = htons (portNum) ;
+      else
+	((struct sockaddr_in6 *)&addr)->sin6_port = htons (portNum) ;
+    }
+
+    if ((fd = socket (addr.ss_family, SOCK_DGRAM, 0)) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Unable to create socket: %s\n", strerror (errno)) ;
+
+    if (connect (fd, (struct sockaddr *)&addr, addrLen) < 0)
+    {
+      close (fd) ;
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Unable to connect: %s\n", strerror (errno)) ;
+    }
+
+    pthread_mutex_lock (&conn->lock) ;
+      conn->udpFd    = fd ;
+      conn->udpToken = token ;
+      conn->udpLen   = sizeof (struct drcNetUdpStruct) ;	// An empty one so the server knows where we are
+      (void)udpSend (conn) ;
+    pthread_mutex_unlock (&conn->lock) ;
+
+    if (pthread_create (&thread, NULL, udpReader, conn) != 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdp: Unable to start UDP thread: %s\n", strerror (errno)) ;
+    pthread_detach (thread) ;
+  }
+
+  if (writes && !conn->udpWrites && (drcNetFlush (pinBase) < 0))
+    return -1 ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    (void)sendBatch (conn) ;
+    conn->udpWrites = writes ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetUdpState:
+ *	Have the server broadcast the levels of count pins (1-64) from pin
+ *	to us by UDP every period mS, for drcNetUdpStateRead. A count of 0
+ *	stops it. Needs drcNetUdp first.
+ *********************************************************************************
+ */
+
+int drcNetUdpState (const int pin, const int count, const unsigned int period)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  struct drcNetConnStruct *conn ;
+  uint32_t data, payload = period ;
+  int tries ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdpState: No DRC network node at pin %d\n", pin) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  if (conn->udpFd < 0)
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdpState: UDP not open\n") ;
+
+  if ((count < 0) || (count > 64) || (period == 0))
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdpState: count must be 0-64 and period non-zero\n") ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    conn->haveState = FALSE ;
+    conn->statePin  = pin - node->pinBase ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+// Our first datagram, or any since, may not have got there yet
+
+  for (tries = 0 ; tries < 10 ; ++tries)
+  {
+    data = count ;
+    if (drcBulk (node, pin, DRCN_UDP_STATE, &data, &payload, 1, NULL, 0) < 0)
+      return wiringPiFailure (WPI_ALMOST, "drcNetUdpState: Lost the connection to the server\n") ;
+
+    if (data == 0)
+    {
+      pthread_mutex_lock (&conn->lock) ;
+	conn->stateCount  = count ;
+	conn->statePeriod = period ;
+      pthread_mutex_unlock (&conn->lock) ;
+      return 0 ;
+    }
+
+    pthread_mutex_lock (&conn->lock) ;
+      conn->udpLen = sizeof (struct drcNetUdpStruct) ;
+      (void)udpSend (conn) ;
+    pthread_mutex_unlock (&conn->lock) ;
+    delay (10) ;
+  }
+
+  return wiringPiFailure (WPI_ALMOST, "drcNetUdpState: Server isn't getting our datagrams\n") ;
+}
+
+
+/*
+ * drcNetUdpStateRead:
+ *	Get the levels from the newest state broadcast, bit 0 being the
+ *	first pin. Returns how many mS ago it came in, or -1 if none has.
+ *********************************************************************************
+ */
+
+int drcNetUdpStateRead (const int pin, unsigned long long *bits)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  struct drcNetConnStruct *conn ;
+  struct timespec now ;
+  int age = -1 ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdpStateRead: No DRC network node at pin %d\n", pin) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  clock_gettime (CLOCK_MONOTONIC, &now) ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    if (conn->haveState)
+    {
+      *bits = conn->stateBits ;
+      age   = (now.tv_sec - conn->stateWhen.tv_sec) * 1000 + (now.tv_nsec - conn->stateWhen.tv_nsec) / 1000000 ;
+    }
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return age ;
+}
+
+
+/*
+ * drcNetUdpStats:
+ *	How many state broadcasts have been taken in, and how many dropped
+ *	for being older than one already had.
+ *********************************************************************************
+ */
+
+int drcNetUdpStats (const int pin, unsigned int *states, unsigned int *stale)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+  struct drcNetConnStruct *conn ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetUdpStats: No DRC network node at pin %d\n", pin) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    *states = conn->states ;
+    *stale  = conn->statesStale ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return 0 ;
+}
+
+
+/*
+ * drcNetStatus:
+ *	Return TRUE if the node's connection is up, FALSE if it was lost and
+ *	is being made again. *failures, if not NULL, gets the number of
+ *	commands that have failed since the last call - writes dropped and
+ *	reads which returned 0 because of it.
+ *********************************************************************************
+ */
+
+int drcNetStatus (const int pinBase, unsigned int *failures)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pinBase) ;
+  struct drcNetConnStruct *conn ;
+  int up ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetStatus: No DRC network node at pin %d\n", pinBase) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    up = !conn->down ;
+    if (failures != NULL)
+      *failures = conn->failures ;
+    conn->failures = 0 ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return up ;
+}
+
+
+/*
+ * drcNetShare:
+ *	Whether nodes set up from now on share the connection of an earlier
+ *	node to the same server, port and password (the default), or get
+ *	one of their own.
+ *********************************************************************************
+ */
+
+void drcNetShare (const int share)
+{
+  shareConns = share ;
+}
+
+
+/*
+ * drcNetProtocol:
+ *	Return the protocol in use to the server, first dropping to an older
+ *	one if asked to: 3 for no UDP, 2 for no bulk commands, 1 to wait for
+ *	a reply to every command. There's no going up past what the server
+ *	offered. It's for every node sharing the connection.
+ *********************************************************************************
+ */
+
+int drcNetProtocol (const int pinBase, const int protocol)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pinBase) ;
+  struct drcNetConnStruct *conn ;
+  int result ;
+
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcNetProtocol: No DRC network node at pin %d\n", pinBase) ;
+
+  conn = (struct drcNetConnStruct *)node->priv ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    (void)sendBatch (conn) ;
+    if ((protocol > 0) && (protocol < conn->protocol))
+      conn->protocol = protocol ;
+    if (conn->protocol < 4)
+      conn->udpWrites = FALSE ;
+    result = conn->protocol ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  return result ;
+}
+
+
+/*
+ * restore:
+ *	Set the server up again the way it was for us on the connection
+ *	just made: the subscriptions and UDP.
+ *********************************************************************************
+ */
+
+static void restore (struct drcNetConnStruct *conn)
+{
+  struct wiringPiNodeStruct *node = conn->node ;
+  unsigned int value, statePeriod ;
+  int pins [MAX_SUBS], modes [MAX_SUBS] ;
+  int i, numSubs, statePin, stateCount ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    numSubs = conn->numSubs ;
+    for (i = 0 ; i < numSubs ; ++i)
+    {
+      pins  [i] = conn->subs [i].pin ;
+      modes [i] = conn->subs [i].mode ;
+    }
+  pthread_mutex_unlock (&conn->lock) ;
+
+  for (i = 0 ; i < numSubs ; ++i)
+  {
+    value = modes [i] ;
+    (void)drcRead (node, node->pinBase + pins [i], DRCN_SUBSCRIBE, 1, &value) ;
+  }
+
+  if (conn->udpFd < 0)
+    return ;
+
+  value = 0 ;
+  if ((drcRead (node, node->pinBase, DRCN_UDP_OPEN, 1, &value) < 0) || (value == 0))
+    return ;
+
+  pthread_mutex_lock (&conn->lock) ;
+    conn->udpToken = value ;
+    statePin    = conn->statePin ;
+    stateCount  = conn->stateCount ;
+    statePeriod = conn->statePeriod ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  if (stateCount != 0)
+    (void)drcNetUdpState (node->pinBase + statePin, stateCount, statePeriod) ;
+}
+
+
+/*
+ * reconnect:
+ *	Thread making the connection again after it was lost, backing off
+ *	between attempts. A server that has forgotten our session token -
+ *	it'll have been restarted - gets the password straight away.
+ *********************************************************************************
+ */
+
+static void *reconnect (void *arg)
+{
+  struct drcNetConnStruct *conn = (struct drcNetConnStruct *)arg ;
+  uint32_t session [4] ;
+  int fd, protocol, wait = RECONNECT_MIN ;
+
+// The reader has to be done with the old socket first
+
+  pthread_mutex_lock (&conn->lock) ;
+    while (conn->readerRunning)
+      pthread_cond_wait (&conn->replied, &conn->lock) ;
+    close (conn->fd) ;
+    memcpy (session, conn->session, sizeof (session)) ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  for (;;)
+  {
+    if ((fd = netConnect (conn->host, conn->port, conn->password, session, &protocol)) >= 0)
+      break ;
+
+    if ((errno == EACCES) && ((session [0] | session [1] | session [2] | session [3]) != 0))
+    {
+      memset (session, 0, sizeof (session)) ;
+      continue ;
+    }
+
+    delay (wait) ;
+    if ((wait *= 2) > RECONNECT_MAX)
+      wait = RECONNECT_MAX ;
+  }
+
+  pthread_mutex_lock (&conn->lock) ;
+    conn->fd = fd ;
+    memcpy (conn->session, session, sizeof (session)) ;
+    if (protocol < conn->protocol)
+      conn->protocol = protocol ;
+    conn->serverProtocol = protocol ;
+    conn->numReplies   = 0 ;
+    conn->down         = FALSE ;
+    conn->reconnecting = FALSE ;
+    if (conn->reader && (startReader (conn) < 0))
+      connLost (conn) ;
+  pthread_mutex_unlock (&conn->lock) ;
+
+  restore (conn) ;
+
+  return NULL ;
+}
+
+
+/*
+ * drcNet:
+ *	Create a new instance of an DRC GPIO interface.
+ *	Could be a variable nunber of pins here - we might not know in advance.
+ *********************************************************************************
+ */
+
+int drcSetupNet (const int pinBase, const int numPins, const char *ipAddress, const char *port, const char *password)
+{
+  int fd, protocol ;
+  uint32_t session [4] ;
+  struct wiringPiNodeStruct *node ;
+  struct drcNetConnStruct *conn ;
+
+  pthread_mutex_lock (&connsLock) ;
+
+  for (conn = shareConns ? conns : NULL ; conn != NULL ; conn = conn->next)
+    if ((strcmp (conn->host, ipAddress) == 0) && (strcmp (conn->port, port) == 0) && (strcmp (conn->password, password) == 0))
+      break ;
+
+  if (conn == NULL)
+  {
+    memset (session, 0, sizeof (session)) ;
+
+    if ((fd = netConnect (ipAddress, port, password, session, &protocol)) < 0)
+    {
+      pthread_mutex_unlock (&connsLock) ;
+      return FALSE ;
+    }
+
+    if ((conn = (struct drcNetConnStruct *)calloc (1, sizeof (*conn))) == NULL)
+    {
+      pthread_mutex_unlock (&connsLock) ;
+      close (fd) ;
+      return FALSE ;
+    }
+
+    conn->fd       = fd ;
+    conn->protocol = (protocol > DRCN_PROTOCOL) ? DRCN_PROTOCOL : protocol ;
+    conn->serverProtocol = protocol ;
+    conn->udpFd    = -1 ;
+    conn->host     = strdup (ipAddress) ;
+    conn->port     = strdup (port) ;
+    conn->password = strdup (password) ;	// Kept for reconnecting
+    memcpy (conn->session, session, sizeof (session)) ;
+    pthread_mutex_init (&conn->lock, NULL) ;
+    pthread_cond_init  (&conn->wake, NULL) ;
+    pthread_cond_init  (&conn->replied, NULL) ;
+    pthread_cond_init  (&conn->events, NULL) ;
+
+    conn->next = conns ;
+    conns      = conn ;
+  }
+
+  pthread_mutex_unlock (&connsLock) ;
+
+  node = wiringPiNewNode (pinBase, numPins) ;
+
+  if (conn->node == NULL)
+    conn->node = node ;
+
+  node->fd               = conn->fd ;		// Until a reconnect, conn->fd has it after
+  node->priv             = conn ;
+  node->pinMode          = myPinMode ;
+  node->pullUpDnControl  = myPullUpDnControl ;
   node->analogRead       = myAnalogRead ;
   node->analogWrite      = myAnalogWrite ;
   node->digitalRead      = myDigitalRead ;
   node->digitalWrite     = myDigitalWrite ;
-//node->digitalRead8     = myDigitalRead8 ;
-//node->digitalWrite8    = myDigitalWrite8 ;
+  node->digitalRead8     = myDigitalRead8 ;
+  node->digitalRead16    = myDigitalRead16 ;
+  node->digitalRead32    = myDigitalRead32 ;
+  node->digitalWrite8    = myDigitalWrite8 ;
+  node->digitalWrite16   = myDigitalWrite16 ;
+  node->digitalWrite32   = myDigitalWrite32 ;
   node->pwmWrite         = myPwmWrite ;
 
   return TRUE ;
@@ -35,7 +35,23 @@ struct drcNetStruct
 extern "C" {
 #endif
 
-extern int drcSetupNet (const int pinBase, const int numPins, const char *ipAddress, const char *port, const char *password) ;
+extern int drcSetupNet    (const int pinBase, const int numPins, const char *ipAddress, const char *port, const char *password) ;
+extern int drcNetFlush    (const int pinBase) ;
+extern int drcNetBatch    (const int pinBase, const unsigned int us) ;
+extern int drcNetProtocol (const int pinBase, const int protocol) ;
+extern int drcNetStatus   (const int pinBase, unsigned int *failures) ;
+extern void drcNetShare   (const int share) ;
+
+extern int drcNetDigitalWriteMasked (const int pin, const unsigned long long mask, const unsigned long long value) ;
+extern int drcNetDigitalReadAll     (const int pin, const int count, unsigned long long *bits) ;
+extern int drcNetAnalogReadList     (const int pins [], const int num, int values []) ;
+
+extern int drcNetUdp          (const int pinBase, const char *port, const int writes) ;
+extern int drcNetUdpState     (const int pin, const int count, const unsigned int period) ;
+extern int drcNetUdpStateRead (const int pin, unsigned long long *bits) ;
+extern int drcNetUdpStats     (const int pin, unsigned int *states, unsigned int *stale) ;
+
+extern int drcNetSubscribe (const int pin, const int mode, void (*function)(int pin, int level, unsigned long long timestamp, void *userdata), void *userdata) ;
 
 #ifdef __cplusplus
 }
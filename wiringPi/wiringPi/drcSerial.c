@@ -23,15 +23,106 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #include "wiringPi.h"
 #include "wiringSerial.h"
 
 #include "drcSerial.h"
 
+// Commands sent ahead of their replies. The device only has a small
+//	receive buffer (64 bytes on an ATmega) and 2 bytes go in for
+//	each command, so we stop and take the replies in after this many.
+
+#define	MAX_PIPE	32
+
+// Our side of the link: commands are put together in out [] and go in
+//	the one write, replies are read into in [] as many as have arrived.
+
+struct drcSerialStruct
+{
+  pthread_mutex_t lock ;
+  unsigned char   out [MAX_PIPE * 3] ;
+  int             outLen ;
+  unsigned char   in [256] ;
+  int             inPos, inLen ;
+} ;
+
+
+/*
+ * put:
+ *	Add a byte to the commands going out
+ *********************************************************************************
+ */
+
+static void put (struct drcSerialStruct *drc, int c)
+{
+  drc->out [drc->outLen++] = c ;
+}
+
+
+/*
+ * flush:
+ *	Send the commands put together so far
+ *********************************************************************************
+ */
+
+static void flush (struct wiringPiNodeStruct *node)
+{
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int done = 0, n ;
+
+  while (done < drc->outLen)
+  {
+    if ((n = write (node->fd, drc->out + done, drc->outLen - done)) <= 0)
+    {
+      if ((n < 0) && (errno == EINTR))
+	continue ;
+      break ;
+    }
+    done += n ;
+  }
+
+  drc->outLen = 0 ;
+}
+
+
+/*
+ * get:
+ *	Get a byte of a reply, sending anything waiting to go first.
+ *	Returns -1 after the 10 seconds serialOpen has the reads time out in.
+ *********************************************************************************
+ */
+
+static int get (struct wiringPiNodeStruct *node)
+{
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int n ;
+
+  if (drc->inPos == drc->inLen)
+  {
+    if (drc->outLen != 0)
+      flush (node) ;
+
+    while ((n = read (node->fd, drc->in, sizeof (drc->in))) < 0)
+      if (errno != EINTR)
+	break ;
+
+    if (n <= 0)
+      return -1 ;
+
+    drc->inPos = 0 ;
+    drc->inLen = n ;
+  }
+
+  return drc->in [drc->inPos++] ;
+}
+
 
 /*
  * myPinMode:
@@ -41,14 +132,21 @@
 
 static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  /**/ if (mode == OUTPUT)
-    serialPutchar (node->fd, 'o') ;       // Input
-  else if (mode == PWM_OUTPUT)
-    serialPutchar (node->fd, 'p') ;       // PWM
-  else
-    serialPutchar (node->fd, 'i') ;       // Default to input
-
-  serialPutchar (node->fd, pin - node->pinBase) ;
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+
+  pthread_mutex_lock (&drc->lock) ;
+
+    /**/ if (mode == OUTPUT)
+      put (drc, 'o') ;       // Output
+    else if (mode == PWM_OUTPUT)
+      put (drc, 'p') ;       // PWM
+    else
+      put (drc, 'i') ;       // Default to input
+
+    put (drc, pin - node->pinBase) ;
+    flush (node) ;
+
+  pthread_mutex_unlock (&drc->lock) ;
 }
 
 
@@ -60,22 +158,29 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 
 static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
 {
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+
+  pthread_mutex_lock (&drc->lock) ;
 
 // Force pin into input mode
 
-  serialPutchar (node->fd, 'i' ) ;
-  serialPutchar (node->fd, pin - node->pinBase) ;
+    put (drc, 'i' ) ;
+    put (drc, pin - node->pinBase) ;
 
-  /**/ if (mode == PUD_UP)
-  {
-    serialPutchar (node->fd, '1') ;
-    serialPutchar (node->fd, pin - node->pinBase) ;
-  }
-  else if (mode == PUD_OFF)
-  {
-    serialPutchar (node->fd, '0') ;
-    serialPutchar (node->fd, pin - node->pinBase) ;
-  }
+    /**/ if (mode == PUD_UP)
+    {
+      put (drc, '1') ;
+      put (drc, pin - node->pinBase) ;
+    }
+    else if (mode == PUD_OFF)
+    {
+      put (drc, '0') ;
+      put (drc, pin - node->pinBase) ;
+    }
+
+    flush (node) ;
+
+  pthread_mutex_unlock (&drc->lock) ;
 }
 
 
@@ -86,8 +191,13 @@ static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mod
 
 static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
 {
-  serialPutchar (node->fd, value == 0 ? '0' : '1') ;
-  serialPutchar (node->fd, pin - node->pinBase) ;
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+
+  pthread_mutex_lock (&drc->lock) ;
+    put (drc, value == 0 ? '0' : '1') ;
+    put (drc, pin - node->pinBase) ;
+    flush (node) ;
+  pthread_mutex_unlock (&drc->lock) ;
 }
 
 
@@ -98,9 +208,50 @@ static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
 
 static void myPwmWrite (struct wiringPiNodeStruct *node, int pin, int value)
 {
-  serialPutchar (node->fd, 'v') ;
-  serialPutchar (node->fd, pin - node->pinBase) ;
-  serialPutchar (node->fd, value & 0xFF) ;
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+
+  pthread_mutex_lock (&drc->lock) ;
+    put (drc, 'v') ;
+    put (drc, pin - node->pinBase) ;
+    put (drc, value & 0xFF) ;
+    flush (node) ;
+  pthread_mutex_unlock (&drc->lock) ;
+}
+
+
+/*
+ * analogReads:
+ *	Read num analog pins, MAX_PIPE at a time down the line. Returns
+ *	0 or -1 if the device stopped answering.
+ *********************************************************************************
+ */
+
+static int analogReads (struct wiringPiNodeStruct *node, const int pins [], int num, int values [])
+{
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int i, j, chunk, vHi, vLo ;
+
+  for (i = 0 ; i < num ; i += chunk)
+  {
+    chunk = (num - i > MAX_PIPE) ? MAX_PIPE : num - i ;
+
+    for (j = 0 ; j < chunk ; ++j)
+    {
+      put (drc, 'a') ;
+      put (drc, pins [i + j] - node->pinBase) ;
+    }
+
+    for (j = 0 ; j < chunk ; ++j)
+    {
+      vHi = get (node) ;
+      vLo = get (node) ;
+      if ((vHi < 0) || (vLo < 0))
+	return -1 ;
+      values [i + j] = (vHi << 8) | vLo ;
+    }
+  }
+
+  return 0 ;
 }
 
 
@@ -111,14 +262,15 @@ static void myPwmWrite (struct wiringPiNodeStruct *node, int pin, int value)
 
 static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 {
-  int vHi, vLo ;
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int value ;
 
-  serialPutchar (node->fd, 'a') ;
-  serialPutchar (node->fd, pin - node->pinBase) ;
-  vHi = serialGetchar (node->fd) ;
-  vLo = serialGetchar (node->fd) ;
+  pthread_mutex_lock (&drc->lock) ;
+    if (analogReads (node, &pin, 1, &value) < 0)
+      value = -1 ;
+  pthread_mutex_unlock (&drc->lock) ;
 
-  return (vHi << 8) | vLo ;
+  return value ;
 }
 
 
@@ -129,9 +281,122 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 
 static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 {
-  serialPutchar (node->fd, 'r') ; // Send read command
-  serialPutchar (node->fd, pin - node->pinBase) ;
-  return (serialGetchar (node->fd) == '0') ? 0 : 1 ;
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int c ;
+
+  pthread_mutex_lock (&drc->lock) ;
+    put (drc, 'r') ; // Send read command
+    put (drc, pin - node->pinBase) ;
+    c = get (node) ;
+  pthread_mutex_unlock (&drc->lock) ;
+
+  return (c == '0') ? 0 : 1 ;
+}
+
+
+/*
+ * myDigitalReadPins:
+ *	Read a run of pins with all the read commands going in the one
+ *	write and the replies coming back together, rather than a round
+ *	trip over the line for each.
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPins (struct wiringPiNodeStruct *node, int pin, int width)
+{
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  unsigned int bits = 0 ;
+  int i ;
+
+  if (pin + width - 1 > node->pinMax)
+    width = node->pinMax - pin + 1 ;
+
+  pthread_mutex_lock (&drc->lock) ;
+
+    for (i = 0 ; i < width ; ++i)
+    {
+      put (drc, 'r') ;
+      put (drc, pin + i - node->pinBase) ;
+    }
+
+    for (i = 0 ; i < width ; ++i)
+      if (get (node) != '0')
+	bits |= 1U << i ;
+
+  pthread_mutex_unlock (&drc->lock) ;
+
+  return bits ;
+}
+
+static unsigned int myDigitalRead8  (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin,  8) ; }
+static unsigned int myDigitalRead16 (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin, 16) ; }
+static unsigned int myDigitalRead32 (struct wiringPiNodeStruct *node, int pin) { return myDigitalReadPins (node, pin, 32) ; }
+
+
+/*
+ * myDigitalWritePins:
+ *	Write a run of pins, again in the one write.
+ *********************************************************************************
+ */
+
+static void myDigitalWritePins (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  struct drcSerialStruct *drc = (struct drcSerialStruct *)node->priv ;
+  int i ;
+
+  if (pin + width - 1 > node->pinMax)
+    width = node->pinMax - pin + 1 ;
+
+  pthread_mutex_lock (&drc->lock) ;
+    for (i = 0 ; i < width ; ++i)
+    {
+      put (drc, ((value >> i) & 1) == 0 ? '0' : '1') ;
+      put (drc, pin + i - node->pinBase) ;
+    }
+    flush (node) ;
+  pthread_mutex_unlock (&drc->lock) ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { myDigitalWritePins (node, pin, value, 32) ; }
+
+
+/*
+ * drcSerialAnalogReadList:
+ *	Read num analog pins, all on the same DRC device, into values [].
+ *	The pins needn't be consecutive. The commands go down the line
+ *	together, so it's one round trip for up to 32 pins.
+ *********************************************************************************
+ */
+
+int drcSerialAnalogReadList (const int pins [], const int num, int values [])
+{
+  struct wiringPiNodeStruct *node ;
+  struct drcSerialStruct *drc ;
+  int i, result ;
+
+  if (num < 1)
+    return wiringPiFailure (WPI_ALMOST, "drcSerialAnalogReadList: num must be 1 or more (%d)\n", num) ;
+
+  node = wiringPiFindNode (pins [0]) ;
+  if ((node == NULL) || (node->digitalRead8 != myDigitalRead8))
+    return wiringPiFailure (WPI_ALMOST, "drcSerialAnalogReadList: No DRC serial node at pin %d\n", pins [0]) ;
+
+  for (i = 0 ; i < num ; ++i)
+    if ((pins [i] < node->pinBase) || (pins [i] > node->pinMax))
+      return wiringPiFailure (WPI_ALMOST, "drcSerialAnalogReadList: pin %d is not on the same node as pin %d\n", pins [i], pins [0]) ;
+
+  drc = (struct drcSerialStruct *)node->priv ;
+
+  pthread_mutex_lock (&drc->lock) ;
+    result = analogReads (node, pins, num, values) ;
+  pthread_mutex_unlock (&drc->lock) ;
+
+  if (result < 0)
+    return wiringPiFailure (WPI_ALMOST, "drcSerialAnalogReadList: No reply from the device\n") ;
+
+  return 0 ;
 }
 
 
@@ -149,6 +414,7 @@ int drcSetupSerial (const int pinBase, const int numPins, const char *device, co
   int ok, tries ;
   time_t then ;
   struct wiringPiNodeStruct *node ;
+  struct drcSerialStruct *drc ;
 
   if ((fd = serialOpen (device, baud)) < 0)
     return FALSE ;
@@ -182,14 +448,28 @@ int drcSetupSerial (const int pinBase, const int numPins, const char *device, co
     return FALSE ;
   }
 
+  if ((drc = (struct drcSerialStruct *)calloc (1, sizeof (*drc))) == NULL)
+  {
+    serialClose (fd) ;
+    return FALSE ;
+  }
+  pthread_mutex_init (&drc->lock, NULL) ;
+
   node = wiringPiNewNode (pinBase, numPins) ;
 
   node->fd              = fd ;
+  node->priv            = drc ;
   node->pinMode         = myPinMode ;
   node->pullUpDnControl = myPullUpDnControl ;
   node->analogRead      = myAnalogRead ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
+  node->digitalRead8    = myDigitalRead8 ;
+  node->digitalRead16   = myDigitalRead16 ;
+  node->digitalRead32   = myDigitalRead32 ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
   node->pwmWrite        = myPwmWrite ;
 
   return TRUE ;
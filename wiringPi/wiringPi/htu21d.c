@@ -46,68 +46,94 @@ int checksum (UNU uint8_t data [4])
 
 
 /*
- * myAnalogRead:
+ * htu21dFetch:
+ *	Read the result of a measurement and calculate the value.
+ *	Returns -9998 if the read failed, -9997 for a bad checksum.
  *********************************************************************************
  */
 
-static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+static int htu21dFetch (int fd, int chan)
 {
-  int chan = pin - node->pinBase ;
-  int fd   = node->fd ;
+  struct wiringPiI2CMessage msg ;
   uint8_t data [4] ;
   uint32_t sTemp, sHumid ;
   double   fTemp, fHumid ;
-  int      cTemp, cHumid ;
-
-  /**/ if (chan == 0)	// Read Temperature
-  {
-
-// Send read temperature command:
 
-    data [0] = 0xF3 ;
-    if (write (fd, data, 1) != 1)
-      return -9999 ;
+  msg.addr  = -1 ;
+  msg.flags = WPI_I2C_READ ;
+  msg.buf   = data ;
+  msg.len   = 3 ;
 
-// Wait then read the data
-
-    delay (50) ;
-    if (read (fd, data, 3) != 3)
-      return -9998 ;
+  if (wiringPiI2CTransfer (fd, &msg, 1) < 0)
+    return -9998 ;
 
-    if (!checksum (data))
-      return -9997 ;
+  if (!checksum (data))
+    return -9997 ;
 
 // Do the calculation
 
+  if (chan == 0)
+  {
     sTemp = (data [0] << 8) | data [1] ;
     fTemp = -48.85 + 175.72 * (double)sTemp / 63356.0 ;
-    cTemp = (int)rint (((100.0 * fTemp) + 0.5) / 10.0) ;
-    return cTemp ;
+    return (int)rint (((100.0 * fTemp) + 0.5) / 10.0) ;
   }
-  else if (chan == 1)	// humidity
+  else
   {
-// Send read humidity command:
+    sHumid = (data [0] << 8) | data [1] ;
+    fHumid = -6.0 + 125.0 * (double)sHumid / 65536.0 ;
+    return (int)rint (((100.0 * fHumid) + 0.5) / 10.0) ;
+  }
+}
 
-    data [0] = 0xF5 ;
-    if (write (fd, data, 1) != 1)
-      return -9999 ;
 
-// Wait then read the data
+/*
+ * myAnalogRead:
+ *********************************************************************************
+ */
+
+static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+{
+  int chan = pin - node->pinBase ;
 
-    delay (50) ;
-    if (read (fd, data, 3) != 3)
-      return -9998 ;
+  if ((chan != 0) && (chan != 1))
+    return -9999 ;
 
-    if (!checksum (data))
-      return -9997 ;
+// Send the read temperature (0xF3) or humidity (0xF5) command:
 
-    sHumid = (data [0] << 8) | data [1] ;
-    fHumid = -6.0 + 125.0 * (double)sHumid / 65536.0 ;
-    cHumid = (int)rint (((100.0 * fHumid) + 0.5) / 10.0) ;
-    return cHumid ;
-  }
-  else
+  if (wiringPiI2CWrite (node->fd, (chan == 0) ? 0xF3 : 0xF5) < 0)
     return -9999 ;
+
+// Wait then read the data
+
+  delay (50) ;
+  return htu21dFetch (node->fd, chan) ;
+}
+
+
+/*
+ * myPollStart: myPollFetch:
+ *	Split reads for wpiPoll, the 50mS measurement runs while the bus
+ *	does other work.
+ *********************************************************************************
+ */
+
+static int myPollStart (struct wiringPiNodeStruct *node, int pin)
+{
+  int chan = pin - node->pinBase ;
+
+  if (wiringPiI2CWrite (node->fd, (chan == 0) ? 0xF3 : 0xF5) < 0)
+    return -1 ;
+
+  return 50000 ;
+}
+
+static int myPollFetch (struct wiringPiNodeStruct *node, int pin, int *value)
+{
+  if ((*value = htu21dFetch (node->fd, pin - node->pinBase)) <= -9997)
+    return -1 ;
+
+  return 0 ;
 }
 
 
@@ -123,21 +149,21 @@ int htu21dSetup (const int pinBase)
 {
   int fd ;
   struct wiringPiNodeStruct *node ;
-  uint8_t data ;
   int status ;
 
-  if ((fd = wiringPiI2CSetup (I2C_ADDRESS)) < 0)
+  if ((fd = wiringPiI2COpen (-1, I2C_ADDRESS)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 2) ;
 
   node->fd         = fd ;
   node->analogRead = myAnalogRead ;
+  node->pollStart  = myPollStart ;
+  node->pollFetch  = myPollFetch ;
 
 // Send a reset code to it:
 
-  data = 0xFE ;
-  if (write (fd, &data, 1) != 1)
+  if (wiringPiI2CWrite (fd, 0xFE) < 0)
     return FALSE ;
 
   delay (15) ;
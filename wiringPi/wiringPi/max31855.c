@@ -36,7 +36,7 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
   int temp ;
   int chan = pin - node->pinBase ;
 
-  wiringPiSPIDataRW (node->fd, (unsigned char *)&spiData, 4) ;
+  wiringPiSPIHandleRW (node->fd, (unsigned char *)&spiData, 4) ;
 
   spiData = __bswap_32(spiData) ;
 
@@ -86,13 +86,14 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 int max31855Setup (const int pinBase, int spiChannel)
 {
   struct wiringPiNodeStruct *node ;
+  int handle ;
 
-  if (wiringPiSPISetup (spiChannel, 5000000) < 0)	// 5MHz - prob 4 on the Pi
+  if ((handle = wiringPiSPIOpen (0, spiChannel, 5000000, 0)) < 0)	// 5MHz - prob 4 on the Pi
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 4) ;
 
-  node->fd         = spiChannel ;
+  node->fd         = handle ;
   node->analogRead = myAnalogRead ;
 
   return TRUE ;
@@ -50,7 +50,7 @@ static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
   spiData [0] = chanBits ;
   spiData [1] = dataBits ;
 
-  wiringPiSPIDataRW (node->fd, spiData, 2) ;
+  wiringPiSPIHandleRW (node->fd, spiData, 2) ;
 }
 
 /*
@@ -64,13 +64,14 @@ int max5322Setup (const int pinBase, int spiChannel)
 {
   struct wiringPiNodeStruct *node ;
   unsigned char spiData [2] ;
+  int handle ;
 
-  if (wiringPiSPISetup (spiChannel, 8000000) < 0)	// 10MHz Max
+  if ((handle = wiringPiSPIOpen (0, spiChannel, 8000000, 0)) < 0)	// 10MHz Max
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 2) ;
 
-  node->fd          = spiChannel ;
+  node->fd          = handle ;
   node->analogWrite = myAnalogWrite ;
 
 // Enable both DACs
@@ -78,7 +79,7 @@ int max5322Setup (const int pinBase, int spiChannel)
   spiData [0] = 0b11100000 ;
   spiData [1] = 0 ;
   
-  wiringPiSPIDataRW (node->fd, spiData, 2) ;
+  wiringPiSPIHandleRW (node->fd, spiData, 2) ;
 
   return TRUE ;
 }
@@ -27,10 +27,33 @@
 
 #include "wiringPi.h"
 #include "wiringPiI2C.h"
+#include "wpiRegCache.h"
 #include "mcp23x0817.h"
 
 #include "mcp23008.h"
 
+// Registers the chip changes by itself, never cached
+
+#define	VOLATILE_REGS	(WPI_REGCACHE_REG (MCP23x08_GPIO) | WPI_REGCACHE_REG (MCP23x08_INTF) | \
+			 WPI_REGCACHE_REG (MCP23x08_INTCAP))
+
+
+/*
+ * busRead: busWrite:
+ *	Register access for the register cache
+ *********************************************************************************
+ */
+
+static int busRead (struct wiringPiNodeStruct *node, int reg)
+{
+  return wiringPiI2CReadReg8 (node->fd, reg) ;
+}
+
+static int busWrite (struct wiringPiNodeStruct *node, int reg, int value)
+{
+  return wiringPiI2CWriteReg8 (node->fd, reg, value) ;
+}
+
 
 /*
  * myPinMode:
@@ -39,18 +62,12 @@
 
 static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   reg  = MCP23x08_IODIR ;
   mask = 1 << (pin - node->pinBase) ;
-  old  = wiringPiI2CReadReg8 (node->fd, reg) ;
 
-  if (mode == OUTPUT)
-    old &= (~mask) ;
-  else
-    old |=   mask ;
-
-  wiringPiI2CWriteReg8 (node->fd, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == OUTPUT) ? 0 : mask) ;
 }
 
 
@@ -61,19 +78,12 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 
 static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   reg  = MCP23x08_GPPU ;
   mask = 1 << (pin - node->pinBase) ;
 
-  old  = wiringPiI2CReadReg8 (node->fd, reg) ;
-
-  if (mode == PUD_UP)
-    old |=   mask ;
-  else
-    old &= (~mask) ;
-
-  wiringPiI2CWriteReg8 (node->fd, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == PUD_UP) ? mask : 0) ;
 }
 
 
@@ -118,6 +128,47 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  int value ;
+
+  if ((value = wiringPiI2CReadReg8 (node->fd, MCP23x08_GPIO)) < 0)
+    return 0 ;
+
+  return value >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on with a single write.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned int mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFF ;
+  port = node->data2 ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  wiringPiI2CWriteReg8 (node->fd, MCP23x08_GPIO, port) ;
+  node->data2 = port ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
 /*
  * mcp23008Setup:
  *	Create a new instance of an MCP23008 I2C GPIO interface. We know it
@@ -130,20 +181,37 @@ int mcp23008Setup (const int pinBase, const int i2cAddress)
 {
   int fd ;
   struct wiringPiNodeStruct *node ;
+  struct wpiRegCacheStruct *cache ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
-  wiringPiI2CWriteReg8 (fd, MCP23x08_IOCON, IOCON_INIT) ;
+// The cache first: once the node exists its pins can be used
+
+  if ((cache = wpiRegCacheNew (NULL, busRead, busWrite, VOLATILE_REGS)) == NULL)
+  {
+    wiringPiI2CClose (fd) ;
+    return FALSE ;
+  }
 
   node = wiringPiNewNode (pinBase, 8) ;
+  cache->node = node ;
 
   node->fd              = fd ;
   node->pinMode         = myPinMode ;
   node->pullUpDnControl = myPullUpDnControl ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
-  node->data2           = wiringPiI2CReadReg8 (fd, MCP23x08_OLAT) ;
+  node->digitalRead8    = myDigitalReadPort ;
+  node->digitalRead16   = myDigitalReadPort ;
+  node->digitalRead32   = myDigitalReadPort ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
+  node->priv            = cache ;
+
+  wpiRegCacheWrite (node->priv, MCP23x08_IOCON, IOCON_INIT) ;
+  node->data2           = wpiRegCacheRead (node->priv, MCP23x08_OLAT) ;
 
   return TRUE ;
 }
@@ -132,6 +132,62 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *	Both banks in one transfer: the address pointer toggles
+ *	between the two registers of a pair.
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  unsigned char data [2] ;
+
+  if (wiringPiI2CReadBlock (node->fd, MCP23016_GP0, data, 2) < 0)
+    return 0 ;
+
+  return (data [0] | (data [1] << 8)) >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on. Only the bank(s) with changed pins
+ *	get written, both in one transfer.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned char data [2] ;
+  unsigned int  mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFFFF ;
+  port = node->data2 | (node->data3 << 8) ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  /**/ if ((mask & 0xFF00) == 0)
+    wiringPiI2CWriteReg8 (node->fd, MCP23016_GP0, port & 0xFF) ;
+  else if ((mask & 0x00FF) == 0)
+    wiringPiI2CWriteReg8 (node->fd, MCP23016_GP1, port >> 8) ;
+  else
+  {
+    data [0] = port & 0xFF ;
+    data [1] = port >> 8 ;
+    wiringPiI2CWriteBlock (node->fd, MCP23016_GP0, data, 2) ;
+  }
+
+  node->data2 = port & 0xFF ;
+  node->data3 = port >> 8 ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
 /*
  * mcp23016Setup:
  *	Create a new instance of an MCP23016 I2C GPIO interface. We know it
@@ -145,7 +201,7 @@ int mcp23016Setup (const int pinBase, const int i2cAddress)
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
   wiringPiI2CWriteReg8 (fd, MCP23016_IOCON0, IOCON_INIT) ;
@@ -157,6 +213,12 @@ int mcp23016Setup (const int pinBase, const int i2cAddress)
   node->pinMode         = myPinMode ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
+  node->digitalRead8    = myDigitalReadPort ;
+  node->digitalRead16   = myDigitalReadPort ;
+  node->digitalRead32   = myDigitalReadPort ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
   node->data2           = wiringPiI2CReadReg8 (fd, MCP23016_OLAT0) ;
   node->data3           = wiringPiI2CReadReg8 (fd, MCP23016_OLAT1) ;
 
@@ -27,10 +27,34 @@
 
 #include "wiringPi.h"
 #include "wiringPiI2C.h"
+#include "wpiRegCache.h"
 #include "mcp23x0817.h"
 
 #include "mcp23017.h"
 
+// Registers the chip changes by itself, never cached
+
+#define	VOLATILE_REGS	(WPI_REGCACHE_REG (MCP23x17_GPIOA)   | WPI_REGCACHE_REG (MCP23x17_GPIOB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTFA)   | WPI_REGCACHE_REG (MCP23x17_INTFB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTCAPA) | WPI_REGCACHE_REG (MCP23x17_INTCAPB))
+
+
+/*
+ * busRead: busWrite:
+ *	Register access for the register cache
+ *********************************************************************************
+ */
+
+static int busRead (struct wiringPiNodeStruct *node, int reg)
+{
+  return wiringPiI2CReadReg8 (node->fd, reg) ;
+}
+
+static int busWrite (struct wiringPiNodeStruct *node, int reg, int value)
+{
+  return wiringPiI2CWriteReg8 (node->fd, reg, value) ;
+}
+
 
 /*
  * myPinMode:
@@ -39,7 +63,7 @@
 
 static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   pin -= node->pinBase ;
 
@@ -52,14 +76,8 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
   }
 
   mask = 1 << pin ;
-  old  = wiringPiI2CReadReg8 (node->fd, reg) ;
-
-  if (mode == OUTPUT)
-    old &= (~mask) ;
-  else
-    old |=   mask ;
 
-  wiringPiI2CWriteReg8 (node->fd, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == OUTPUT) ? 0 : mask) ;
 }
 
 
@@ -70,7 +88,7 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 
 static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   pin -= node->pinBase ;
 
@@ -83,14 +101,8 @@ static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mod
   }
 
   mask = 1 << pin ;
-  old  = wiringPiI2CReadReg8 (node->fd, reg) ;
 
-  if (mode == PUD_UP)
-    old |=   mask ;
-  else
-    old &= (~mask) ;
-
-  wiringPiI2CWriteReg8 (node->fd, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == PUD_UP) ? mask : 0) ;
 }
 
 
@@ -163,6 +175,122 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *	Both banks in one transfer: with IOCON.BANK clear GPIOB follows
+ *	GPIOA, and the address pointer moves on to it with SEQOP set (it
+ *	toggles within the pair) as well as clear (sequential mode).
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  unsigned char data [2] ;
+
+  if (wiringPiI2CReadBlock (node->fd, MCP23x17_GPIOA, data, 2) < 0)
+    return 0 ;
+
+  return (data [0] | (data [1] << 8)) >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on. Only the bank(s) with changed pins
+ *	get written, both in one transfer.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned char data [2] ;
+  unsigned int  mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFFFF ;
+  port = node->data2 | (node->data3 << 8) ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  /**/ if ((mask & 0xFF00) == 0)
+    wiringPiI2CWriteReg8 (node->fd, MCP23x17_GPIOA, port & 0xFF) ;
+  else if ((mask & 0x00FF) == 0)
+    wiringPiI2CWriteReg8 (node->fd, MCP23x17_GPIOB, port >> 8) ;
+  else
+  {
+    data [0] = port & 0xFF ;
+    data [1] = port >> 8 ;
+    wiringPiI2CWriteBlock (node->fd, MCP23x17_GPIOA, data, 2) ;
+  }
+
+  node->data2 = port & 0xFF ;
+  node->data3 = port >> 8 ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
+/*
+ * myISRMode:
+ *	Interrupt-on-change for the pin: INTCON clear compares against the
+ *	previous value rather than DEFVAL, so both edges interrupt and the
+ *	core filters by mode. INT_EDGE_NONE turns it off again.
+ *********************************************************************************
+ */
+
+static int myISRMode (struct wiringPiNodeStruct *node, int pin, int mode)
+{
+  int mask, bank ;
+
+  pin -= node->pinBase ;
+  bank = pin >> 3 ;		// The B registers follow the A ones
+  mask = 1 << (pin & 7) ;
+
+  if (mode == INT_EDGE_NONE)
+  {
+    if (wpiRegCacheUpdate (node->priv, MCP23x17_GPINTENA + bank, mask, 0) < 0)
+      return wiringPiFailure (WPI_ALMOST, "mcp23017ISRMode: Unable to configure pin %d\n", node->pinBase + pin) ;
+    return 0 ;
+  }
+
+  if ((wpiRegCacheUpdate (node->priv, MCP23x17_INTCONA  + bank, mask, 0)    < 0) ||
+      (wpiRegCacheUpdate (node->priv, MCP23x17_DEFVALA  + bank, mask, 0)    < 0) ||
+      (wpiRegCacheUpdate (node->priv, MCP23x17_GPINTENA + bank, mask, mask) < 0))
+    return wiringPiFailure (WPI_ALMOST, "mcp23017ISRMode: Unable to configure pin %d\n", node->pinBase + pin) ;
+
+  return 0 ;
+}
+
+
+/*
+ * myInterrupt:
+ *	The INT line fired: fetch the flags and the pin states captured at
+ *	the interrupt in one transfer (which also clears it) and report an
+ *	edge for every flagged pin.
+ *********************************************************************************
+ */
+
+static void myInterrupt (UNU int pin, UNU int level, unsigned long long timestamp, void *userdata)
+{
+  struct wiringPiNodeStruct *node = (struct wiringPiNodeStruct *)userdata ;
+  unsigned char data [4] ;	// INTFA, INTFB, INTCAPA, INTCAPB
+  unsigned int flags, captured ;
+  int bit ;
+
+  if (wiringPiI2CReadBlock (node->fd, MCP23x17_INTFA, data, 4) < 0)
+    return ;
+
+  flags    = data [0] | (data [1] << 8) ;
+  captured = data [2] | (data [3] << 8) ;
+
+  for (bit = 0 ; bit < 16 ; ++bit)
+    if ((flags & (1 << bit)) != 0)
+      wiringPiNodeEdge (node->pinBase + bit, (captured >> bit) & 1, timestamp) ;
+}
+
+
 /*
  * mcp23017Setup:
  *	Create a new instance of an MCP23017 I2C GPIO interface. We know it
@@ -175,21 +303,79 @@ int mcp23017Setup (const int pinBase, const int i2cAddress)
 {
   int fd ;
   struct wiringPiNodeStruct *node ;
+  struct wpiRegCacheStruct *cache ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
-  wiringPiI2CWriteReg8 (fd, MCP23x17_IOCON, IOCON_INIT) ;
+// The cache first: once the node exists its pins can be used
+
+  if ((cache = wpiRegCacheNew (NULL, busRead, busWrite, VOLATILE_REGS)) == NULL)
+  {
+    wiringPiI2CClose (fd) ;
+    return FALSE ;
+  }
 
   node = wiringPiNewNode (pinBase, 16) ;
+  cache->node = node ;
 
   node->fd              = fd ;
   node->pinMode         = myPinMode ;
   node->pullUpDnControl = myPullUpDnControl ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
-  node->data2           = wiringPiI2CReadReg8 (fd, MCP23x17_OLATA) ;
-  node->data3           = wiringPiI2CReadReg8 (fd, MCP23x17_OLATB) ;
+  node->digitalRead8    = myDigitalReadPort ;
+  node->digitalRead16   = myDigitalReadPort ;
+  node->digitalRead32   = myDigitalReadPort ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
+  node->priv            = cache ;
+
+  wpiRegCacheWrite (node->priv, MCP23x17_IOCON, IOCON_INIT) ;
+  node->data2           = wpiRegCacheRead (node->priv, MCP23x17_OLATA) ;
+  node->data3           = wpiRegCacheRead (node->priv, MCP23x17_OLATB) ;
+
+  return TRUE ;
+}
+
+
+/*
+ * mcp23017ISRSetup:
+ *	Wire the INTA line of the chip set up at pinBase to Pi pin intPin.
+ *	After that wiringPiISR and wiringPiISRArg work on its pins. INTA
+ *	gets mirrored to cover both banks, active low; the registers go to
+ *	sequential mode so INTF and INTCAP of both banks come in one read.
+ *********************************************************************************
+ */
+
+int mcp23017ISRSetup (const int pinBase, const int intPin)
+{
+  struct wiringPiNodeStruct *node ;
+  unsigned char data [2] ;
+  int mask = IOCON_MIRROR | IOCON_SEQOP | IOCON_ODR | IOCON_INTPOL ;
+
+  node = wiringPiFindNode (pinBase) ;
+  if ((node == NULL) || (node->pinBase != pinBase) || (node->digitalRead != myDigitalRead))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "mcp23017ISRSetup: No MCP23017 at pin %d\n", pinBase) ;
+    return FALSE ;
+  }
+
+  if (wpiRegCacheUpdate (node->priv, MCP23x17_IOCON, mask, IOCON_MIRROR) < 0)
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "mcp23017ISRSetup: Unable to configure IOCON\n") ;
+    return FALSE ;
+  }
+
+// Clear anything pending from before, or INTA stays low and never fires
+
+  (void)wiringPiI2CReadBlock (node->fd, MCP23x17_INTCAPA, data, 2) ;
+
+  node->isrMode = myISRMode ;
+
+  if (wiringPiISRArg (intPin, INT_EDGE_FALLING, myInterrupt, node) < 0)
+    return FALSE ;
 
   return TRUE ;
 }
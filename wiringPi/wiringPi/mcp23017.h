@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 extern int mcp23017Setup (const int pinBase, const int i2cAddress) ;
+extern int mcp23017ISRSetup (const int pinBase, const int intPin) ;
 
 #ifdef __cplusplus
 }
@@ -27,10 +27,16 @@
 
 #include "wiringPi.h"
 #include "wiringPiSPI.h"
+#include "wpiRegCache.h"
 #include "mcp23x0817.h"
 
 #include "mcp23s08.h"
 
+// Registers the chip changes by itself, never cached
+
+#define	VOLATILE_REGS	(WPI_REGCACHE_REG (MCP23x08_GPIO) | WPI_REGCACHE_REG (MCP23x08_INTF) | \
+			 WPI_REGCACHE_REG (MCP23x08_INTCAP))
+
 #define	MCP_SPEED	4000000
 
 
@@ -71,6 +77,37 @@ static uint8_t readByte (uint8_t spiPort, uint8_t devId, uint8_t reg)
 }
 
 
+/*
+ * busRead: busWrite:
+ *	Register access for the register cache
+ *********************************************************************************
+ */
+
+static int busRead (struct wiringPiNodeStruct *node, int reg)
+{
+  uint8_t spiData [4] ;
+
+  spiData [0] = CMD_READ | ((node->data1 & 7) << 1) ;
+  spiData [1] = reg ;
+
+  if (wiringPiSPIDataRW (node->data0, spiData, 3) < 0)
+    return -1 ;
+
+  return spiData [2] ;
+}
+
+static int busWrite (struct wiringPiNodeStruct *node, int reg, int value)
+{
+  uint8_t spiData [4] ;
+
+  spiData [0] = CMD_WRITE | ((node->data1 & 7) << 1) ;
+  spiData [1] = reg ;
+  spiData [2] = value ;
+
+  return wiringPiSPIDataRW (node->data0, spiData, 3) < 0 ? -1 : 0 ;
+}
+
+
 /*
  * myPinMode:
  *********************************************************************************
@@ -78,18 +115,12 @@ static uint8_t readByte (uint8_t spiPort, uint8_t devId, uint8_t reg)
 
 static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   reg  = MCP23x08_IODIR ;
   mask = 1 << (pin - node->pinBase) ;
-  old  = readByte (node->data0, node->data1, reg) ;
 
-  if (mode == OUTPUT)
-    old &= (~mask) ;
-  else
-    old |=   mask ;
-
-  writeByte (node->data0, node->data1, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == OUTPUT) ? 0 : mask) ;
 }
 
 
@@ -100,19 +131,12 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 
 static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   reg  = MCP23x08_GPPU ;
   mask = 1 << (pin - node->pinBase) ;
 
-  old  = readByte (node->data0, node->data1, reg) ;
-
-  if (mode == PUD_UP)
-    old |=   mask ;
-  else
-    old &= (~mask) ;
-
-  writeByte (node->data0, node->data1, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == PUD_UP) ? mask : 0) ;
 }
 
 
@@ -157,6 +181,47 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  int value ;
+
+  if ((value = busRead (node, MCP23x08_GPIO)) < 0)
+    return 0 ;
+
+  return value >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on with a single write.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned int mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFF ;
+  port = node->data2 ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  writeByte (node->data0, node->data1, MCP23x08_GPIO, port) ;
+  node->data2 = port ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
 /*
  * mcp23s08Setup:
  *	Create a new instance of an MCP23s08 SPI GPIO interface. We know it
@@ -168,13 +233,18 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 int mcp23s08Setup (const int pinBase, const int spiPort, const int devId)
 {
   struct wiringPiNodeStruct *node ;
+  struct wpiRegCacheStruct *cache ;
 
   if (wiringPiSPISetup (spiPort, MCP_SPEED) < 0)
     return FALSE ;
 
-  writeByte (spiPort, devId, MCP23x08_IOCON, IOCON_INIT) ;
+// The cache first: once the node exists its pins can be used
+
+  if ((cache = wpiRegCacheNew (NULL, busRead, busWrite, VOLATILE_REGS)) == NULL)
+    return FALSE ;
 
   node = wiringPiNewNode (pinBase, 8) ;
+  cache->node = node ;
 
   node->data0           = spiPort ;
   node->data1           = devId ;
@@ -182,7 +252,16 @@ int mcp23s08Setup (const int pinBase, const int spiPort, const int devId)
   node->pullUpDnControl = myPullUpDnControl ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
-  node->data2           = readByte (spiPort, devId, MCP23x08_OLAT) ;
+  node->digitalRead8    = myDigitalReadPort ;
+  node->digitalRead16   = myDigitalReadPort ;
+  node->digitalRead32   = myDigitalReadPort ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
+  node->priv            = cache ;
+
+  wpiRegCacheWrite (node->priv, MCP23x08_IOCON, IOCON_INIT) ;
+  node->data2           = wpiRegCacheRead (node->priv, MCP23x08_OLAT) ;
 
   return TRUE ;
 }
@@ -27,10 +27,17 @@
 
 #include "wiringPi.h"
 #include "wiringPiSPI.h"
+#include "wpiRegCache.h"
 #include "mcp23x0817.h"
 
 #include "mcp23s17.h"
 
+// Registers the chip changes by itself, never cached
+
+#define	VOLATILE_REGS	(WPI_REGCACHE_REG (MCP23x17_GPIOA)   | WPI_REGCACHE_REG (MCP23x17_GPIOB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTFA)   | WPI_REGCACHE_REG (MCP23x17_INTFB)   | \
+			 WPI_REGCACHE_REG (MCP23x17_INTCAPA) | WPI_REGCACHE_REG (MCP23x17_INTCAPB))
+
 #define	MCP_SPEED	4000000
 
 
@@ -71,6 +78,37 @@ static uint8_t readByte (uint8_t spiPort, uint8_t devId, uint8_t reg)
 }
 
 
+/*
+ * busRead: busWrite:
+ *	Register access for the register cache
+ *********************************************************************************
+ */
+
+static int busRead (struct wiringPiNodeStruct *node, int reg)
+{
+  uint8_t spiData [4] ;
+
+  spiData [0] = CMD_READ | ((node->data1 & 7) << 1) ;
+  spiData [1] = reg ;
+
+  if (wiringPiSPIDataRW (node->data0, spiData, 3) < 0)
+    return -1 ;
+
+  return spiData [2] ;
+}
+
+static int busWrite (struct wiringPiNodeStruct *node, int reg, int value)
+{
+  uint8_t spiData [4] ;
+
+  spiData [0] = CMD_WRITE | ((node->data1 & 7) << 1) ;
+  spiData [1] = reg ;
+  spiData [2] = value ;
+
+  return wiringPiSPIDataRW (node->data0, spiData, 3) < 0 ? -1 : 0 ;
+}
+
+
 /*
  * myPinMode:
  *********************************************************************************
@@ -78,7 +116,7 @@ static uint8_t readByte (uint8_t spiPort, uint8_t devId, uint8_t reg)
 
 static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   pin -= node->pinBase ;
 
@@ -91,14 +129,8 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
   }
 
   mask = 1 << pin ;
-  old  = readByte (node->data0, node->data1, reg) ;
-
-  if (mode == OUTPUT)
-    old &= (~mask) ;
-  else
-    old |=   mask ;
 
-  writeByte (node->data0, node->data1, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == OUTPUT) ? 0 : mask) ;
 }
 
 
@@ -109,7 +141,7 @@ static void myPinMode (struct wiringPiNodeStruct *node, int pin, int mode)
 
 static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mode)
 {
-  int mask, old, reg ;
+  int mask, reg ;
 
   pin -= node->pinBase ;
 
@@ -122,14 +154,8 @@ static void myPullUpDnControl (struct wiringPiNodeStruct *node, int pin, int mod
   }
 
   mask = 1 << pin ;
-  old  = readByte (node->data0, node->data1, reg) ;
-
-  if (mode == PUD_UP)
-    old |=   mask ;
-  else
-    old &= (~mask) ;
 
-  writeByte (node->data0, node->data1, reg, old) ;
+  (void)wpiRegCacheUpdate (node->priv, reg, mask, (mode == PUD_UP) ? mask : 0) ;
 }
 
 
@@ -202,6 +228,130 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *	Both banks in one transfer: with IOCON.BANK clear GPIOB follows
+ *	GPIOA, and the address pointer moves on to it with SEQOP set (it
+ *	toggles within the pair) as well as clear (sequential mode).
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  uint8_t spiData [4] ;
+
+  spiData [0] = CMD_READ | ((node->data1 & 7) << 1) ;
+  spiData [1] = MCP23x17_GPIOA ;
+
+  if (wiringPiSPIDataRW (node->data0, spiData, 4) < 0)
+    return 0 ;
+
+  return (spiData [2] | (spiData [3] << 8)) >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on. Only the bank(s) with changed pins
+ *	get written, both in one transfer.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned char data [4] ;
+  unsigned int  mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFFFF ;
+  port = node->data2 | (node->data3 << 8) ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  /**/ if ((mask & 0xFF00) == 0)
+    writeByte (node->data0, node->data1, MCP23x17_GPIOA, port & 0xFF) ;
+  else if ((mask & 0x00FF) == 0)
+    writeByte (node->data0, node->data1, MCP23x17_GPIOB, port >> 8) ;
+  else
+  {
+    data [0] = CMD_WRITE | ((node->data1 & 7) << 1) ;
+    data [1] = MCP23x17_GPIOA ;
+    data [2] = port & 0xFF ;
+    data [3] = port >> 8 ;
+    wiringPiSPIDataRW (node->data0, data, 4) ;
+  }
+
+  node->data2 = port & 0xFF ;
+  node->data3 = port >> 8 ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
+/*
+ * myISRMode:
+ *	Interrupt-on-change for the pin: INTCON clear compares against the
+ *	previous value rather than DEFVAL, so both edges interrupt and the
+ *	core filters by mode. INT_EDGE_NONE turns it off again.
+ *********************************************************************************
+ */
+
+static int myISRMode (struct wiringPiNodeStruct *node, int pin, int mode)
+{
+  int mask, bank ;
+
+  pin -= node->pinBase ;
+  bank = pin >> 3 ;		// The B registers follow the A ones
+  mask = 1 << (pin & 7) ;
+
+  if (mode == INT_EDGE_NONE)
+  {
+    if (wpiRegCacheUpdate (node->priv, MCP23x17_GPINTENA + bank, mask, 0) < 0)
+      return wiringPiFailure (WPI_ALMOST, "mcp23s17ISRMode: Unable to configure pin %d\n", node->pinBase + pin) ;
+    return 0 ;
+  }
+
+  if ((wpiRegCacheUpdate (node->priv, MCP23x17_INTCONA  + bank, mask, 0)    < 0) ||
+      (wpiRegCacheUpdate (node->priv, MCP23x17_DEFVALA  + bank, mask, 0)    < 0) ||
+      (wpiRegCacheUpdate (node->priv, MCP23x17_GPINTENA + bank, mask, mask) < 0))
+    return wiringPiFailure (WPI_ALMOST, "mcp23s17ISRMode: Unable to configure pin %d\n", node->pinBase + pin) ;
+
+  return 0 ;
+}
+
+
+/*
+ * myInterrupt:
+ *	The INT line fired: fetch the flags and the pin states captured at
+ *	the interrupt in one transfer (which also clears it) and report an
+ *	edge for every flagged pin.
+ *********************************************************************************
+ */
+
+static void myInterrupt (UNU int pin, UNU int level, unsigned long long timestamp, void *userdata)
+{
+  struct wiringPiNodeStruct *node = (struct wiringPiNodeStruct *)userdata ;
+  unsigned char data [6] ;	// Command, register, INTFA, INTFB, INTCAPA, INTCAPB
+  unsigned int flags, captured ;
+  int bit ;
+
+  data [0] = CMD_READ | ((node->data1 & 7) << 1) ;
+  data [1] = MCP23x17_INTFA ;
+
+  if (wiringPiSPIDataRW (node->data0, data, 6) < 0)
+    return ;
+
+  flags    = data [2] | (data [3] << 8) ;
+  captured = data [4] | (data [5] << 8) ;
+
+  for (bit = 0 ; bit < 16 ; ++bit)
+    if ((flags & (1 << bit)) != 0)
+      wiringPiNodeEdge (node->pinBase + bit, (captured >> bit) & 1, timestamp) ;
+}
+
+
 /*
  * mcp23s17Setup:
  *	Create a new instance of an MCP23s17 SPI GPIO interface. We know it
@@ -213,14 +363,18 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 int mcp23s17Setup (const int pinBase, const int spiPort, const int devId)
 {
   struct wiringPiNodeStruct *node ;
+  struct wpiRegCacheStruct *cache ;
 
   if (wiringPiSPISetup (spiPort, MCP_SPEED) < 0)
     return FALSE ;
 
-  writeByte (spiPort, devId, MCP23x17_IOCON,  IOCON_INIT | IOCON_HAEN) ;
-  writeByte (spiPort, devId, MCP23x17_IOCONB, IOCON_INIT | IOCON_HAEN) ;
+// The cache first: once the node exists its pins can be used
+
+  if ((cache = wpiRegCacheNew (NULL, busRead, busWrite, VOLATILE_REGS)) == NULL)
+    return FALSE ;
 
   node = wiringPiNewNode (pinBase, 16) ;
+  cache->node = node ;
 
   node->data0           = spiPort ;
   node->data1           = devId ;
@@ -228,8 +382,62 @@ int mcp23s17Setup (const int pinBase, const int spiPort, const int devId)
   node->pullUpDnControl = myPullUpDnControl ;
   node->digitalRead     = myDigitalRead ;
   node->digitalWrite    = myDigitalWrite ;
-  node->data2           = readByte (spiPort, devId, MCP23x17_OLATA) ;
-  node->data3           = readByte (spiPort, devId, MCP23x17_OLATB) ;
+  node->digitalRead8    = myDigitalReadPort ;
+  node->digitalRead16   = myDigitalReadPort ;
+  node->digitalRead32   = myDigitalReadPort ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
+  node->priv            = cache ;
+
+  wpiRegCacheWrite (node->priv, MCP23x17_IOCON,  IOCON_INIT | IOCON_HAEN) ;
+  wpiRegCacheWrite (node->priv, MCP23x17_IOCONB, IOCON_INIT | IOCON_HAEN) ;
+  node->data2           = wpiRegCacheRead (node->priv, MCP23x17_OLATA) ;
+  node->data3           = wpiRegCacheRead (node->priv, MCP23x17_OLATB) ;
+
+  return TRUE ;
+}
+
+
+/*
+ * mcp23s17ISRSetup:
+ *	Wire the INTA line of the chip set up at pinBase to Pi pin intPin.
+ *	After that wiringPiISR and wiringPiISRArg work on its pins. INTA
+ *	gets mirrored to cover both banks, active low; the registers go to
+ *	sequential mode so INTF and INTCAP of both banks come in one read.
+ *********************************************************************************
+ */
+
+int mcp23s17ISRSetup (const int pinBase, const int intPin)
+{
+  struct wiringPiNodeStruct *node ;
+  unsigned char data [4] ;
+  int mask = IOCON_MIRROR | IOCON_SEQOP | IOCON_ODR | IOCON_INTPOL ;
+
+  node = wiringPiFindNode (pinBase) ;
+  if ((node == NULL) || (node->pinBase != pinBase) || (node->digitalRead != myDigitalRead))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "mcp23s17ISRSetup: No MCP23S17 at pin %d\n", pinBase) ;
+    return FALSE ;
+  }
+
+  if ((wpiRegCacheUpdate (node->priv, MCP23x17_IOCON,  mask, IOCON_MIRROR) < 0) ||
+      (wpiRegCacheUpdate (node->priv, MCP23x17_IOCONB, mask, IOCON_MIRROR) < 0))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "mcp23s17ISRSetup: Unable to configure IOCON\n") ;
+    return FALSE ;
+  }
+
+// Clear anything pending from before, or INTA stays low and never fires
+
+  data [0] = CMD_READ | ((node->data1 & 7) << 1) ;
+  data [1] = MCP23x17_INTCAPA ;
+  (void)wiringPiSPIDataRW (node->data0, data, 4) ;
+
+  node->isrMode = myISRMode ;
+
+  if (wiringPiISRArg (intPin, INT_EDGE_FALLING, myInterrupt, node) < 0)
+    return FALSE ;
 
   return TRUE ;
 }
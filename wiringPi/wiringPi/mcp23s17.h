@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 extern int mcp23s17Setup (int pinBase, int spiPort, int devId) ;
+extern int mcp23s17ISRSetup (int pinBase, int intPin) ;
 
 #ifdef __cplusplus
 }
@@ -47,7 +47,7 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
   spiData [0] = chanBits ;
   spiData [1] = 0 ;
 
-  wiringPiSPIDataRW (node->fd, spiData, 2) ;
+  wiringPiSPIHandleRW (node->fd, spiData, 2) ;
 
   return ((spiData [0] << 8) | (spiData [1] >> 1)) & 0x3FF ;
 }
@@ -63,13 +63,14 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 int mcp3002Setup (const int pinBase, int spiChannel)
 {
   struct wiringPiNodeStruct *node ;
+  int handle ;
 
-  if (wiringPiSPISetup (spiChannel, 1000000) < 0)
+  if ((handle = wiringPiSPIOpen (0, spiChannel, 1000000, 0)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 2) ;
 
-  node->fd         = spiChannel ;
+  node->fd         = handle ;
   node->analogRead = myAnalogRead ;
 
   return TRUE ;
@@ -47,7 +47,7 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
   spiData [1] = chanBits ;
   spiData [2] = 0 ;
 
-  wiringPiSPIDataRW (node->fd, spiData, 3) ;
+  wiringPiSPIHandleRW (node->fd, spiData, 3) ;
 
   return ((spiData [1] << 8) | spiData [2]) & 0x3FF ;
 }
@@ -63,13 +63,14 @@ static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
 int mcp3004Setup (const int pinBase, int spiChannel)
 {
   struct wiringPiNodeStruct *node ;
+  int handle ;
 
-  if (wiringPiSPISetup (spiChannel, 1000000) < 0)
+  if ((handle = wiringPiSPIOpen (0, spiChannel, 1000000, 0)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 8) ;
 
-  node->fd         = spiChannel ;
+  node->fd         = handle ;
   node->analogRead = myAnalogRead ;
 
   return TRUE ;
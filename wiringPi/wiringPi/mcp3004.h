@@ -26,8 +26,28 @@
 extern "C" {
 #endif
 
+// Continuous sampling, see mcp3004Stream.c
+
+#define	MCP3004_MAX_STREAMS	4
+
+struct mcp3004StreamBlockStruct
+{
+  unsigned long long    timestamp ;	// Start of the block, uS CLOCK_MONOTONIC
+  unsigned int          duration ;	// uS
+  unsigned int          sequence ;	// Counts blocks from 1
+  int                   channels ;	// Channels per scan
+  int                   scans ;
+  const unsigned short *samples ;	// scans * channels, interleaved
+} ;
+
 extern int mcp3004Setup (int pinBase, int spiChannel) ;
 
+extern int mcp3004StreamStart    (int spiChannel, int speed, int bits, int channelMask, int scans,
+		void (*callback)(const struct mcp3004StreamBlockStruct *block, void *userdata), void *userdata) ;
+extern int mcp3004StreamRead     (int stream, unsigned short *samples, int max, struct mcp3004StreamBlockStruct *block, int timeoutMs) ;
+extern int mcp3004StreamOverruns (int stream) ;
+extern int mcp3004StreamStop     (int stream) ;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,497 @@
+/*
+ * mcp3004Stream.c:
+ *	Continuous sampling of an MCP3004/3008 (10-bit) or MCP3204/3208
+ *	(12-bit) ADC.
+ *	A thread runs a fixed batch of conversion frames over and over, each
+ *	frame being one segment of a multi-segment SPI transaction, so a block
+ *	of samples costs one ioctl per WPI_SPI_MAX_SEGMENTS conversions rather
+ *	than one per sample. The raw frames of a block are decoded in one pass
+ *	into one of two sample buffers: consumers read the completed buffer
+ *	while the thread fills the other.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "wiringPi.h"
+#include "wiringPiSPI.h"
+
+#include "mcp3004.h"
+
+struct streamStruct
+{
+  int             handle ;		// SPI handle, -1 when the slot is free
+  int             active ;		// Started and not being stopped, under streamsMutex
+  int             bits ;
+  int             channels ;
+  int             scans ;
+  int             samples ;		// scans * channels
+  unsigned char  *tx ;
+  unsigned char  *rx ;
+  struct wiringPiSPISegment *segments ;
+  unsigned short *blocks [2] ;
+  struct mcp3004StreamBlockStruct info [2] ;
+  void          (*callback)(const struct mcp3004StreamBlockStruct *block, void *userdata) ;
+  void           *userdata ;
+
+  pthread_t       thread ;
+  pthread_mutex_t lock ;		// Protects the fields below
+  pthread_cond_t  cond ;
+  int             running ;
+  int             error ;		// errno of a failed transfer, stops the stream
+  int             ready ;		// Index of the last completed block, -1 none yet
+  unsigned int    sequence ;		// Sequence number of that block
+  unsigned int    lastRead ;
+  int             reading ;		// TRUE once mcp3004StreamRead was called
+  int             readers ;		// Threads inside mcp3004StreamRead
+  unsigned int    overruns ;
+} ;
+
+static struct streamStruct streams [MCP3004_MAX_STREAMS] ;
+static pthread_mutex_t     streamsMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+
+/*
+ * streamMicros:
+ *	Monotonic time in microseconds
+ *********************************************************************************
+ */
+
+static unsigned long long streamMicros (void)
+{
+  struct timespec ts ;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts) ;
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000 ;
+}
+
+
+/*
+ * streamDecode:
+ *	Pull the results out of the raw 3-byte frames. The result sits in
+ *	the low bits of bytes 1 and 2 for both chip families; a plain
+ *	strided loop the compiler can vectorise.
+ *********************************************************************************
+ */
+
+static void streamDecode (unsigned short *out, const unsigned char *rx, int samples, unsigned int mask)
+{
+  int i ;
+
+  for (i = 0 ; i < samples ; ++i)
+    out [i] = ((rx [3 * i + 1] << 8) | rx [3 * i + 2]) & mask ;
+}
+
+
+/*
+ * streamThread:
+ *	Run the batch, decode, publish, repeat.
+ *********************************************************************************
+ */
+
+static void *streamThread (void *arg)
+{
+  struct streamStruct *s = (struct streamStruct *)arg ;
+  struct mcp3004StreamBlockStruct *info ;
+  unsigned long long start ;
+  unsigned int mask = (1 << s->bits) - 1 ;
+  char name [16] ;
+  int  i, n, w ;
+
+  snprintf (name, sizeof (name), "mcp3004-%d", (int)(s - streams)) ;
+  piThreadRealtime (name, 50) ;
+
+  for (w = 0 ;; w ^= 1)
+  {
+    pthread_mutex_lock (&s->lock) ;
+    if (!s->running)
+    {
+      pthread_mutex_unlock (&s->lock) ;
+      break ;
+    }
+    pthread_mutex_unlock (&s->lock) ;
+
+    start = streamMicros () ;
+    for (i = 0 ; i < s->samples ; i += n)
+    {
+      n = s->samples - i ;
+      if (n > WPI_SPI_MAX_SEGMENTS)
+	n = WPI_SPI_MAX_SEGMENTS ;
+      if (wiringPiSPIHandleTransfer (s->handle, &s->segments [i], n) < 0)
+	break ;
+    }
+
+    if (i < s->samples)
+    {
+      pthread_mutex_lock (&s->lock) ;
+      s->error   = errno ;
+      s->running = FALSE ;
+      pthread_cond_broadcast (&s->cond) ;
+      pthread_mutex_unlock (&s->lock) ;
+      break ;
+    }
+
+    streamDecode (s->blocks [w], s->rx, s->samples, mask) ;
+
+// Publish. Readers copy the ready block under the lock, and we never
+//	write to it until the other one has been published.
+
+    info = &s->info [w] ;
+
+    pthread_mutex_lock (&s->lock) ;
+    info->timestamp = start ;
+    info->duration  = (unsigned int)(streamMicros () - start) ;
+    info->sequence  = ++s->sequence ;
+    if (s->reading && (s->lastRead + 1 != info->sequence))
+      ++s->overruns ;
+    s->ready = w ;
+    pthread_cond_broadcast (&s->cond) ;
+    pthread_mutex_unlock (&s->lock) ;
+
+    if (s->callback != NULL)
+      s->callback (info, s->userdata) ;
+  }
+
+  return NULL ;
+}
+
+
+/*
+ * streamFree:
+ *	Release everything a stream slot holds.
+ *********************************************************************************
+ */
+
+static void streamFree (struct streamStruct *s)
+{
+  if (s->handle >= 0)
+    wiringPiSPIHandleClose (s->handle) ;
+
+  free (s->tx) ;
+  free (s->rx) ;
+  free (s->segments) ;
+  free (s->blocks [0]) ;
+  free (s->blocks [1]) ;
+  pthread_cond_destroy  (&s->cond) ;
+  pthread_mutex_destroy (&s->lock) ;
+
+  memset (s, 0, sizeof (struct streamStruct)) ;
+}
+
+
+/*
+ * mcp3004StreamStart:
+ *	Start sampling the channels in channelMask continuously, scans
+ *	rounds over those channels making one block. bits is 10 for the
+ *	MCP3004/3008 and 12 for the MCP3204/3208.
+ *	callback, if not NULL, is called on the sampling thread with every
+ *	completed block and should return quickly.
+ *	Returns a stream number, or -1 on error.
+ *********************************************************************************
+ */
+
+int mcp3004StreamStart (int spiChannel, int speed, int bits, int channelMask, int scans,
+	void (*callback)(const struct mcp3004StreamBlockStruct *block, void *userdata), void *userdata)
+{
+  struct streamStruct *s ;
+  pthread_condattr_t attr ;
+  int chans [8] ;
+  int stream, channels, chan, i, last ;
+  unsigned char *frame ;
+
+  for (channels = 0, chan = 0 ; chan < 8 ; ++chan)
+    if ((channelMask & (1 << chan)) != 0)
+      chans [channels++] = chan ;
+
+  if (((bits != 10) && (bits != 12)) || (channels == 0) || (channelMask & ~0xFF) || (scans < 1) || (scans > 65536 / channels))
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamStart: Invalid bits %d, channel mask 0x%X or scans %d\n", bits, channelMask, scans) ;
+  }
+
+  pthread_mutex_lock (&streamsMutex) ;
+
+  for (stream = 0 ; stream < MCP3004_MAX_STREAMS ; ++stream)
+    if (streams [stream].samples == 0)
+      break ;
+
+  if (stream == MCP3004_MAX_STREAMS)
+  {
+    pthread_mutex_unlock (&streamsMutex) ;
+    errno = EMFILE ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamStart: All %d streams in use\n", MCP3004_MAX_STREAMS) ;
+  }
+
+  s = &streams [stream] ;
+  s->handle   = -1 ;
+  s->bits     = bits ;
+  s->channels = channels ;
+  s->scans    = scans ;
+  s->samples  = channels * scans ;
+  s->callback = callback ;
+  s->userdata = userdata ;
+  s->ready    = -1 ;
+  pthread_mutex_init (&s->lock, NULL) ;
+  pthread_condattr_init (&attr) ;
+  pthread_condattr_setclock (&attr, CLOCK_MONOTONIC) ;
+  pthread_cond_init (&s->cond, &attr) ;
+  pthread_condattr_destroy (&attr) ;
+
+  pthread_mutex_unlock (&streamsMutex) ;
+
+  s->tx         = malloc (s->samples * 3) ;
+  s->rx         = malloc (s->samples * 3) ;
+  s->segments   = calloc (s->samples, sizeof (struct wiringPiSPISegment)) ;
+  s->blocks [0] = malloc (s->samples * sizeof (unsigned short)) ;
+  s->blocks [1] = malloc (s->samples * sizeof (unsigned short)) ;
+
+  if ((s->tx == NULL) || (s->rx == NULL) || (s->segments == NULL) || (s->blocks [0] == NULL) || (s->blocks [1] == NULL))
+  {
+    pthread_mutex_lock (&streamsMutex) ;
+    streamFree (s) ;
+    pthread_mutex_unlock (&streamsMutex) ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamStart: Out of memory\n") ;
+  }
+
+// One 3-byte frame per conversion, chip-select released after each.
+//	The last frame of every ioctl must not set csChange, that would keep
+//	the chip selected past the end of the message.
+
+  for (i = 0 ; i < s->samples ; ++i)
+  {
+    chan  = chans [i % channels] ;
+    frame = s->tx + 3 * i ;
+
+    if (bits == 10)
+    {
+      frame [0] = 1 ;				// Start bit
+      frame [1] = 0b10000000 | (chan << 4) ;	// Single-ended, channel
+    }
+    else
+    {
+      frame [0] = 0b00000110 | (chan >> 2) ;	// Start bit, single-ended, D2
+      frame [1] = (chan & 3) << 6 ;		// D1, D0
+    }
+    frame [2] = 0 ;
+
+    last = ((i + 1) % WPI_SPI_MAX_SEGMENTS == 0) || (i == s->samples - 1) ;
+
+    s->segments [i].tx       = frame ;
+    s->segments [i].rx       = s->rx + 3 * i ;
+    s->segments [i].len      = 3 ;
+    s->segments [i].csChange = last ? 0 : 1 ;
+  }
+
+  for (i = 0 ; i < 2 ; ++i)
+  {
+    s->info [i].channels = channels ;
+    s->info [i].scans    = scans ;
+    s->info [i].samples  = s->blocks [i] ;
+  }
+
+  if ((s->handle = wiringPiSPIOpen (0, spiChannel, speed, 0)) < 0)
+  {
+    pthread_mutex_lock (&streamsMutex) ;
+    streamFree (s) ;
+    pthread_mutex_unlock (&streamsMutex) ;
+    return -1 ;
+  }
+
+  s->running = TRUE ;
+  if (pthread_create (&s->thread, NULL, streamThread, s) != 0)
+  {
+    pthread_mutex_lock (&streamsMutex) ;
+    streamFree (s) ;
+    pthread_mutex_unlock (&streamsMutex) ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamStart: Unable to create thread: %s\n", strerror (errno)) ;
+  }
+
+  pthread_mutex_lock (&streamsMutex) ;
+  s->active = TRUE ;
+  pthread_mutex_unlock (&streamsMutex) ;
+
+  return stream ;
+}
+
+
+/*
+ * streamGet:
+ *	Validate a stream number and return it with its lock held, so it
+ *	can't be stopped and freed under the caller.
+ *********************************************************************************
+ */
+
+static struct streamStruct *streamGet (int stream)
+{
+  struct streamStruct *s = NULL ;
+
+  pthread_mutex_lock (&streamsMutex) ;
+  if ((stream >= 0) && (stream < MCP3004_MAX_STREAMS) && streams [stream].active)
+  {
+    s = &streams [stream] ;
+    pthread_mutex_lock (&s->lock) ;
+  }
+  pthread_mutex_unlock (&streamsMutex) ;
+
+  return s ;
+}
+
+
+/*
+ * mcp3004StreamRead:
+ *	Wait up to timeoutMs (-1 for ever) for a block newer than the last
+ *	one read, and copy up to max of its samples (interleaved by channel)
+ *	into samples. The details go into block, if not NULL, with
+ *	block->samples pointing at the caller's buffer.
+ *	Returns the number of samples copied, 0 on timeout, -1 on error.
+ *********************************************************************************
+ */
+
+int mcp3004StreamRead (int stream, unsigned short *samples, int max, struct mcp3004StreamBlockStruct *block, int timeoutMs)
+{
+  struct streamStruct *s ;
+  struct timespec deadline ;
+  int count, result = 0 ;
+
+  if (timeoutMs >= 0)
+  {
+    clock_gettime (CLOCK_MONOTONIC, &deadline) ;
+    deadline.tv_sec  += timeoutMs / 1000 ;
+    deadline.tv_nsec += (timeoutMs % 1000) * 1000000L ;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+      deadline.tv_sec  += 1 ;
+      deadline.tv_nsec -= 1000000000L ;
+    }
+  }
+
+  if ((s = streamGet (stream)) == NULL)
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamRead: Invalid stream: %d\n", stream) ;
+  }
+
+  s->reading = TRUE ;
+  ++s->readers ;
+
+  while (s->running && ((s->ready < 0) || (s->info [s->ready].sequence == s->lastRead)))
+  {
+    if (timeoutMs < 0)
+      pthread_cond_wait (&s->cond, &s->lock) ;
+    else if (pthread_cond_timedwait (&s->cond, &s->lock, &deadline) == ETIMEDOUT)
+      break ;
+  }
+
+  if (!s->running)
+  {
+    errno  = s->error != 0 ? s->error : EPIPE ;
+    result = -1 ;
+  }
+  else if ((s->ready >= 0) && (s->info [s->ready].sequence != s->lastRead))
+  {
+    count = s->samples < max ? s->samples : max ;
+    memcpy (samples, s->blocks [s->ready], count * sizeof (unsigned short)) ;
+    if (block != NULL)
+    {
+      *block         = s->info [s->ready] ;
+      block->samples = samples ;
+    }
+    s->lastRead = s->info [s->ready].sequence ;
+    result      = count ;
+  }
+
+  if (--s->readers == 0)
+    pthread_cond_broadcast (&s->cond) ;
+
+  pthread_mutex_unlock (&s->lock) ;
+  return result ;
+}
+
+
+/*
+ * mcp3004StreamOverruns:
+ *	Number of blocks replaced before mcp3004StreamRead got to them.
+ *********************************************************************************
+ */
+
+int mcp3004StreamOverruns (int stream)
+{
+  struct streamStruct *s ;
+  int overruns ;
+
+  if ((s = streamGet (stream)) == NULL)
+    return -1 ;
+
+  overruns = s->overruns ;
+  pthread_mutex_unlock (&s->lock) ;
+
+  return overruns ;
+}
+
+
+/*
+ * mcp3004StreamStop:
+ *	Stop the sampling thread and release the stream. Threads waiting
+ *	in mcp3004StreamRead return -1 (EPIPE); the stream is freed once
+ *	they are all out.
+ *********************************************************************************
+ */
+
+int mcp3004StreamStop (int stream)
+{
+  struct streamStruct *s = NULL ;
+
+// Nobody can find the stream once it's inactive, then wait for the
+//	readers already in it
+
+  pthread_mutex_lock (&streamsMutex) ;
+  if ((stream >= 0) && (stream < MCP3004_MAX_STREAMS) && streams [stream].active)
+  {
+    s = &streams [stream] ;
+    s->active = FALSE ;
+  }
+  pthread_mutex_unlock (&streamsMutex) ;
+
+  if (s == NULL)
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "mcp3004StreamStop: Invalid stream: %d\n", stream) ;
+  }
+
+  pthread_mutex_lock (&s->lock) ;
+  s->running = FALSE ;
+  pthread_cond_broadcast (&s->cond) ;
+  while (s->readers > 0)
+    pthread_cond_wait (&s->cond, &s->lock) ;
+  pthread_mutex_unlock (&s->lock) ;
+
+  pthread_join (s->thread, NULL) ;
+
+  pthread_mutex_lock (&streamsMutex) ;
+  streamFree (s) ;
+  pthread_mutex_unlock (&streamsMutex) ;
+
+  return 0 ;
+}
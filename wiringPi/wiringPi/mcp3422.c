@@ -28,8 +28,6 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdint.h>
-#include <fcntl.h>
-#include <sys/ioctl.h>
 
 #include <wiringPi.h>
 #include <wiringPiI2C.h>
@@ -37,6 +35,26 @@
 #include "mcp3422.h"
 
 
+/*
+ * mcp3422ReadResult:
+ *	Read the output register: the result and the config byte, whose
+ *	top bit is clear once the conversion is done.
+ *********************************************************************************
+ */
+
+static int mcp3422ReadResult (int fd, unsigned char *buffer, int n)
+{
+  struct wiringPiI2CMessage msg ;
+
+  msg.addr  = -1 ;
+  msg.flags = WPI_I2C_READ ;
+  msg.buf   = buffer ;
+  msg.len   = n ;
+
+  return wiringPiI2CTransfer (fd, &msg, 1) ;
+}
+
+
 /*
  * waitForConversion:
  *	Common code to wait for the ADC to finish conversion
@@ -47,13 +65,34 @@ void waitForConversion (int fd, unsigned char *buffer, int n)
 {
   for (;;)
   {
-    read (fd, buffer, n) ;
+    mcp3422ReadResult (fd, buffer, n) ;
     if ((buffer [n-1] & 0x80) == 0)
       break ;
     delay (1) ;
   }
 }
 
+
+/*
+ * mcp3422Value:
+ *	Pick the result out of the output register for the sample rate.
+ *	The 18-bit rate returns 4 bytes, the others 3.
+ *********************************************************************************
+ */
+
+static int mcp3422Value (struct wiringPiNodeStruct *node, const unsigned char *buffer)
+{
+  switch (node->data0)	// Sample rate
+  {
+    case MCP3422_SR_3_75:	return ((buffer [0] & 3) << 16) | (buffer [1] << 8) | buffer [2] ;	// 18 bits
+    case MCP3422_SR_15:		return (buffer [0] << 8) | buffer [1] ;				// 16 bits
+    case MCP3422_SR_60:		return ((buffer [0] & 0x3F) << 8) | buffer [1] ;		// 14 bits
+    case MCP3422_SR_240:	return ((buffer [0] & 0x0F) << 8) | buffer [1] ;		// 12 bits - default
+  }
+
+  return 0 ;
+}
+
 /*
  * myAnalogRead:
  *	Read a channel from the device
@@ -64,7 +103,6 @@ int myAnalogRead (struct wiringPiNodeStruct *node, int chan)
 {
   unsigned char config ;
   unsigned char buffer [4] ;
-  int value = 0 ;
   int realChan = (chan & 3) - node->pinBase ;
 
 // One-shot mode, trigger plus the other configs.
@@ -73,30 +111,44 @@ int myAnalogRead (struct wiringPiNodeStruct *node, int chan)
   
   wiringPiI2CWrite (node->fd, config) ;
 
-  switch (node->data0)	// Sample rate
-  {
-    case MCP3422_SR_3_75:			// 18 bits
-      waitForConversion (node->fd, &buffer [0], 4) ;
-      value = ((buffer [0] & 3) << 16) | (buffer [1] << 8) | buffer [2] ;
-      break ;
+  waitForConversion (node->fd, buffer, (node->data0 == MCP3422_SR_3_75) ? 4 : 3) ;
 
-    case MCP3422_SR_15:				// 16 bits
-      waitForConversion (node->fd, buffer, 3) ;
-      value = (buffer [0] << 8) | buffer [1] ;
-      break ;
+  return mcp3422Value (node, buffer) ;
+}
 
-    case MCP3422_SR_60:				// 14 bits
-      waitForConversion (node->fd, buffer, 3) ;
-      value = ((buffer [0] & 0x3F) << 8) | buffer [1] ;
-      break ;
 
-    case MCP3422_SR_240:			// 12 bits - default
-      waitForConversion (node->fd, buffer, 3) ;
-      value = ((buffer [0] & 0x0F) << 8) | buffer [1] ;
-      break ;
-  }
+/*
+ * myPollStart: myPollFetch:
+ *	Split reads for wpiPoll: trigger the conversion, then come back
+ *	when it should be done instead of polling the ready bit.
+ *********************************************************************************
+ */
+
+static const int conversionTimes [4] = { 4200, 16700, 66700, 266700 } ;	// uS
+
+static int myPollStart (struct wiringPiNodeStruct *node, int pin)
+{
+  int chan = (pin - node->pinBase) & 3 ;
+
+  if (wiringPiI2CWrite (node->fd, 0x80 | (chan << 5) | (node->data0 << 2) | (node->data1)) < 0)
+    return -1 ;
+
+  return conversionTimes [node->data0 & 3] ;
+}
+
+static int myPollFetch (struct wiringPiNodeStruct *node, UNU int pin, int *value)
+{
+  unsigned char buffer [4] ;
+  int n = (node->data0 == MCP3422_SR_3_75) ? 4 : 3 ;
+
+  if (mcp3422ReadResult (node->fd, buffer, n) < 0)
+    return -1 ;
+
+  if ((buffer [n-1] & 0x80) != 0)	// Not done yet
+    return 1000 ;
 
-  return value ;
+  *value = mcp3422Value (node, buffer) ;
+  return 0 ;
 }
 
 
@@ -111,7 +163,7 @@ int mcp3422Setup (int pinBase, int i2cAddress, int sampleRate, int gain)
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 4) ;
@@ -120,6 +172,8 @@ int mcp3422Setup (int pinBase, int i2cAddress, int sampleRate, int gain)
   node->data0      = sampleRate ;
   node->data1      = gain ;
   node->analogRead = myAnalogRead ;
+  node->pollStart  = myPollStart ;
+  node->pollFetch  = myPollFetch ;
 
   return TRUE ;
 }
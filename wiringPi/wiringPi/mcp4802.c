@@ -50,7 +50,7 @@ static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
   spiData [0] = chanBits ;
   spiData [1] = dataBits ;
 
-  wiringPiSPIDataRW (node->fd, spiData, 2) ;
+  wiringPiSPIHandleRW (node->fd, spiData, 2) ;
 }
 
 /*
@@ -63,13 +63,14 @@ static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
 int mcp4802Setup (const int pinBase, int spiChannel)
 {
   struct wiringPiNodeStruct *node ;
+  int handle ;
 
-  if (wiringPiSPISetup (spiChannel, 1000000) < 0)
+  if ((handle = wiringPiSPIOpen (0, spiChannel, 1000000, 0)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 2) ;
 
-  node->fd          = spiChannel ;
+  node->fd          = handle ;
   node->analogWrite = myAnalogWrite ;
 
   return TRUE ;
@@ -98,6 +98,47 @@ static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
 }
 
 
+/*
+ * myDigitalReadPort:
+ *********************************************************************************
+ */
+
+static unsigned int myDigitalReadPort (struct wiringPiNodeStruct *node, int pin)
+{
+  int value ;
+
+  if ((value = wiringPiI2CRead (node->fd)) < 0)
+    return 0 ;
+
+  return value >> (pin - node->pinBase) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on with a single write.
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned int mask, port ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = (mask << shift) & 0xFF ;
+  port = node->data2 ;
+  port = (port & ~mask) | ((value << shift) & mask) ;
+
+  wiringPiI2CWrite (node->fd, port) ;
+  node->data2 = port ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
 /*
  * pcf8574Setup:
  *	Create a new instance of a PCF8574 I2C GPIO interface. We know it
@@ -111,16 +152,22 @@ int pcf8574Setup (const int pinBase, const int i2cAddress)
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 8) ;
 
-  node->fd           = fd ;
-  node->pinMode      = myPinMode ;
-  node->digitalRead  = myDigitalRead ;
-  node->digitalWrite = myDigitalWrite ;
-  node->data2        = wiringPiI2CRead (fd) ;
+  node->fd             = fd ;
+  node->pinMode        = myPinMode ;
+  node->digitalRead    = myDigitalRead ;
+  node->digitalWrite   = myDigitalWrite ;
+  node->digitalRead8   = myDigitalReadPort ;
+  node->digitalRead16  = myDigitalReadPort ;
+  node->digitalRead32  = myDigitalReadPort ;
+  node->digitalWrite8  = myDigitalWrite8 ;
+  node->digitalWrite16 = myDigitalWrite16 ;
+  node->digitalWrite32 = myDigitalWrite32 ;
+  node->data2          = wiringPiI2CRead (fd) ;
 
   return TRUE ;
 }
@@ -38,10 +38,7 @@
 
 static void myAnalogWrite (struct wiringPiNodeStruct *node, UNU int pin, int value)
 {
-  unsigned char b [2] ;
-  b [0] = 0x40 ;
-  b [1] = value & 0xFF ;
-  write (node->fd, b, 2) ;
+  wiringPiI2CWriteReg8 (node->fd, 0x40, value & 0xFF) ;
 }
 
 
@@ -77,7 +74,7 @@ int pcf8591Setup (const int pinBase, const int i2cAddress)
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (i2cAddress)) < 0)
+  if ((fd = wiringPiI2COpen (-1, i2cAddress)) < 0)
     return FALSE ;
 
   node = wiringPiNewNode (pinBase, 4) ;
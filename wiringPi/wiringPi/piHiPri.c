@@ -25,7 +25,11 @@
  */
 
 #include <sched.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #include "wiringPi.h"
 
@@ -49,3 +53,223 @@ int piHiPri (const int pri)
 
   return sched_setscheduler (0, SCHED_RR, &sched) ;
 }
+
+
+/*
+ * Thread placement:
+ *	The real-time threads created by the library (softPwm, softTone,
+ *	softServo and the ISR dispatchers) register themselves here. If a set
+ *	of CPUs has been configured they get pinned, round-robin, to one of
+ *	them so they are never migrated mid-pulse. Each thread also gets a
+ *	stats slot to record how late it wakes up compared to what it asked for
+ *	(the ISR dispatchers don't know when their edge happened, so they
+ *	record nothing there).
+ *
+ *	The CPU set comes from piThreadPlacement () or, failing that, from the
+ *	WIRINGPI_CPUS environment variable, e.g. "2,3" or "2-3".
+ *	WIRINGPI_MLOCK (any value) locks all current and future memory.
+ *********************************************************************************
+ */
+
+#define	ENV_CPUS	"WIRINGPI_CPUS"
+#define	ENV_MLOCK	"WIRINGPI_MLOCK"
+
+#define	MAX_CPUS	 32
+
+static pthread_mutex_t threadMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+static int placementDone = FALSE ;
+static int cpuList [MAX_CPUS] ;
+static int cpuCount = 0 ;
+static int cpuNext  = 0 ;
+
+static struct piThreadStatsStruct threadStats [PI_THREAD_MAX] ;
+static int threadCount = 0 ;
+
+
+/*
+ * parseCpus:
+ *	Turn a list like "1,3-5" into our cpuList array
+ *********************************************************************************
+ */
+
+static int parseCpus (const char *cpus)
+{
+  char *end ;
+  long  first, last, cpu ;
+
+  cpuCount = 0 ;
+
+  while (*cpus != 0)
+  {
+    first = strtol (cpus, &end, 10) ;
+    if (end == cpus)
+      return -1 ;
+    last = first ;
+
+    if (*end == '-')
+    {
+      cpus = end + 1 ;
+      last = strtol (cpus, &end, 10) ;
+      if (end == cpus)
+	return -1 ;
+    }
+
+    if ((first < 0) || (last < first) || (last >= CPU_SETSIZE))
+      return -1 ;
+
+    for (cpu = first ; (cpu <= last) && (cpuCount < MAX_CPUS) ; ++cpu)
+      cpuList [cpuCount++] = (int)cpu ;
+
+    if (*end == ',')
+      ++end ;
+    else if (*end != 0)
+      return -1 ;
+    cpus = end ;
+  }
+
+  return cpuCount ;
+}
+
+
+/*
+ * piThreadPlacement:
+ *	Set the CPUs library threads get pinned to (NULL or "" to let them
+ *	float) and optionally lock all memory to avoid page-fault stalls.
+ *	Only affects threads started after the call.
+ *********************************************************************************
+ */
+
+int piThreadPlacement (const char *cpus, int lockMemory)
+{
+  int res = 0 ;
+
+  pthread_mutex_lock (&threadMutex) ;
+    placementDone = TRUE ;
+    cpuNext       = 0 ;
+    if ((cpus == NULL) || (*cpus == 0))
+      cpuCount = 0 ;
+    else if (parseCpus (cpus) < 0)
+    {
+      cpuCount = 0 ;
+      res = wiringPiFailure (WPI_ALMOST, "piThreadPlacement: invalid CPU list \"%s\"\n", cpus) ;
+    }
+  pthread_mutex_unlock (&threadMutex) ;
+
+  if (lockMemory && (mlockall (MCL_CURRENT | MCL_FUTURE) != 0))
+    res = wiringPiFailure (WPI_ALMOST, "piThreadPlacement: mlockall failed: %s\n", strerror (errno)) ;
+
+  return res ;
+}
+
+
+/*
+ * piThreadRealtime:
+ *	Called by a library thread on itself: set SCHED_RR priority, pin it
+ *	to the next configured CPU and return its stats slot (or -1 if
+ *	all slots are in use). A thread re-using a name re-uses the slot.
+ *********************************************************************************
+ */
+
+int piThreadRealtime (const char *name, const int pri)
+{
+  struct sched_param sched ;
+  cpu_set_t cpuSet ;
+  int slot, cpu = -1 ;
+
+  memset (&sched, 0, sizeof(sched)) ;
+
+  if (pri > sched_get_priority_max (SCHED_RR))
+    sched.sched_priority = sched_get_priority_max (SCHED_RR) ;
+  else
+    sched.sched_priority = pri ;
+
+  (void)pthread_setschedparam (pthread_self (), SCHED_RR, &sched) ;	// Only effective if we run as root
+
+  if (!placementDone)
+    (void)piThreadPlacement (getenv (ENV_CPUS), getenv (ENV_MLOCK) != NULL) ;
+
+  pthread_mutex_lock (&threadMutex) ;
+
+    if (cpuCount > 0)
+    {
+      cpu = cpuList [cpuNext] ;
+      cpuNext = (cpuNext + 1) % cpuCount ;
+
+      CPU_ZERO (&cpuSet) ;
+      CPU_SET  (cpu, &cpuSet) ;
+      if (pthread_setaffinity_np (pthread_self (), sizeof (cpuSet), &cpuSet) != 0)
+	cpu = -1 ;
+    }
+
+    for (slot = 0 ; slot < threadCount ; ++slot)
+      if (strncmp (threadStats [slot].name, name, sizeof (threadStats [slot].name) - 1) == 0)
+	break ;
+
+    if (slot == threadCount)
+    {
+      if (threadCount == PI_THREAD_MAX)
+	slot = -1 ;
+      else
+	++threadCount ;
+    }
+
+    if (slot != -1)
+    {
+      memset (&threadStats [slot], 0, sizeof (threadStats [slot])) ;
+      strncpy (threadStats [slot].name, name, sizeof (threadStats [slot].name) - 1) ;
+      threadStats [slot].cpu = cpu ;
+    }
+
+  pthread_mutex_unlock (&threadMutex) ;
+
+  return slot ;
+}
+
+
+/*
+ * piThreadWakeup:
+ *	Record a wakeup for the given slot. start is the micros () value
+ *	before going to sleep and wanted the requested sleep in uS.
+ *********************************************************************************
+ */
+
+void piThreadWakeup (const int slot, const unsigned int start, const unsigned int wanted)
+{
+  struct piThreadStatsStruct *stats ;
+  unsigned int took, late ;
+
+  if ((slot < 0) || (slot >= PI_THREAD_MAX))
+    return ;
+
+  stats = &threadStats [slot] ;
+  took  = micros () - start ;
+  late  = (took > wanted) ? took - wanted : 0 ;
+
+  pthread_mutex_lock (&threadMutex) ;
+    ++stats->wakeups ;
+    stats->latencyTotal += late ;
+    if (late > stats->latencyMax)
+      stats->latencyMax = late ;
+  pthread_mutex_unlock (&threadMutex) ;
+}
+
+
+/*
+ * piThreadStats:
+ *	Copy out the stats of up to max registered threads and return
+ *	how many were copied.
+ *********************************************************************************
+ */
+
+int piThreadStats (struct piThreadStatsStruct *stats, const int max)
+{
+  int count ;
+
+  pthread_mutex_lock (&threadMutex) ;
+    count = (threadCount < max) ? threadCount : max ;
+    memcpy (stats, threadStats, count * sizeof (*stats)) ;
+  pthread_mutex_unlock (&threadMutex) ;
+
+  return count ;
+}
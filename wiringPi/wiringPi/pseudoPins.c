@@ -11,6 +11,11 @@
  *		temporary variable storing/sharing between programs,
  *		or for other cunning things I've not thought of yet..
  *
+ *		Values are 64 bits. Runs of pins can be written and read
+ *		as one, without a reader seeing half of a write, and a
+ *		program can sleep until a pin changes rather than poll.
+ *		More than one table can be had by giving them names.
+ *
  *	Copyright (c) 2012-2016 Gordon Henderson
  ***********************************************************************
  * This file is part of wiringPi:
@@ -32,64 +37,426 @@
  ***********************************************************************
  */
 
-#define	SHARED_NAME	"wiringPiPseudoPins"
+
+#define	SHARED_NAME	"wiringPiPseudoPins2"
 #define	PSEUDO_PINS	64
+#define	PSEUDO_MAGIC	0x50735031	// "PsP1"
+#define	MAX_PINS	65536
 
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <fcntl.h>
 
 #include <wiringPi.h>
 
 #include "pseudoPins.h"
 
-static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+// The table as it sits in shared memory. The layout is different to
+//	the 64 ints of old, hence the new name.
+//
+//	seq is a sequence lock: odd while a write is going on. A writer
+//	takes it by making it odd, so writers queue on it too. Readers
+//	never wait on writers, they read again if seq moved under them.
+//
+//	changes goes up by one for each write that changes a value, and
+//	is the futex the waiters sleep on; waiters saves the wake call
+//	when nobody is.
+
+struct pseudoPinsStruct
+{
+  uint32_t magic ;
+  uint32_t pins ;
+  uint32_t seq ;
+  uint32_t changes ;
+  uint32_t waiters ;
+  uint32_t spare [3] ;
+  volatile int64_t values [] ;
+} ;
+
+
+/*
+ * futex:
+ *	No glibc wrapper for this. The table is in shared memory, so this
+ *	is the shared (not _PRIVATE) kind that works across processes.
+ *********************************************************************************
+ */
+
+static int futex (uint32_t *addr, int op, uint32_t val, const struct timespec *timeout)
+{
+  return syscall (SYS_futex, addr, op, val, timeout, NULL, 0) ;
+}
+
+
+/*
+ * writeLock: writeUnlock:
+ *	Take and give back the sequence lock. A writer that dies in
+ *	between leaves everyone stuck, but it's only ever held for a
+ *	few stores.
+ *********************************************************************************
+ */
+
+static uint32_t writeLock (struct pseudoPinsStruct *table)
+{
+  uint32_t seq ;
+
+  for (;;)
+  {
+    seq = __atomic_load_n (&table->seq, __ATOMIC_RELAXED) ;
+    if (((seq & 1) == 0) &&
+	__atomic_compare_exchange_n (&table->seq, &seq, seq + 1, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      return seq + 1 ;
+    sched_yield () ;
+  }
+}
+
+static void writeUnlock (struct pseudoPinsStruct *table, uint32_t seq)
+{
+  __atomic_store_n (&table->seq, seq + 1, __ATOMIC_RELEASE) ;
+}
+
+
+/*
+ * readValues: writeValues:
+ *	Copy num values out of or into the table, from pin (table relative)
+ *	up, as one. writeValues wakes the waiters if anything changed.
+ *********************************************************************************
+ */
+
+static void readValues (struct pseudoPinsStruct *table, int pin, int num, int64_t values [])
+{
+  uint32_t seq ;
+  int i ;
+
+  for (;;)
+  {
+    seq = __atomic_load_n (&table->seq, __ATOMIC_ACQUIRE) ;
+    if ((seq & 1) != 0)
+    {
+      sched_yield () ;
+      continue ;
+    }
+
+    for (i = 0 ; i < num ; ++i)
+      values [i] = table->values [pin + i] ;
+
+    __atomic_thread_fence (__ATOMIC_ACQUIRE) ;
+    if (__atomic_load_n (&table->seq, __ATOMIC_RELAXED) == seq)
+      return ;
+  }
+}
+
+static void writeValues (struct pseudoPinsStruct *table, int pin, int num, const int64_t values [])
 {
-  int *ptr   = (int *)node->data0 ;
-  int  myPin = pin - node->pinBase ;
+  uint32_t seq ;
+  int i, changed = FALSE ;
+
+  seq = writeLock (table) ;
+    for (i = 0 ; i < num ; ++i)
+      if (table->values [pin + i] != values [i])
+      {
+	table->values [pin + i] = values [i] ;
+	changed = TRUE ;
+      }
+  writeUnlock (table, seq) ;
+
+  if (!changed)
+    return ;
 
-  return *(ptr + myPin) ;
+  __atomic_add_fetch (&table->changes, 1, __ATOMIC_SEQ_CST) ;
+  if (__atomic_load_n (&table->waiters, __ATOMIC_SEQ_CST) != 0)
+    (void)futex (&table->changes, FUTEX_WAKE, INT32_MAX, NULL) ;
 }
 
 
+/*
+ * myAnalogRead: myAnalogWrite: myDigitalRead: myDigitalWrite:
+ *	The wiringPi view of the pins, cut down to an int
+ *********************************************************************************
+ */
+
+static int myAnalogRead (struct wiringPiNodeStruct *node, int pin)
+{
+  int64_t value ;
+
+  readValues ((struct pseudoPinsStruct *)node->priv, pin - node->pinBase, 1, &value) ;
+
+  return (int)value ;
+}
+
 static void myAnalogWrite (struct wiringPiNodeStruct *node, int pin, int value)
 {
-  int *ptr   = (int *)node->data0 ;
-  int  myPin = pin - node->pinBase ;
+  int64_t v = value ;
+
+  writeValues ((struct pseudoPinsStruct *)node->priv, pin - node->pinBase, 1, &v) ;
+}
+
+static int myDigitalRead (struct wiringPiNodeStruct *node, int pin)
+{
+  return (myAnalogRead (node, pin) == 0) ? LOW : HIGH ;
+}
 
-  *(ptr + myPin) = value ;
+static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
+{
+  myAnalogWrite (node, pin, (value == LOW) ? LOW : HIGH) ;
 }
 
 
 /*
- * pseudoPinsSetup:
- *	Create a new wiringPi device node for the pseudoPins driver
+ * findPins:
+ *	Find the node pin is in, and check the run of num from it is too
  *********************************************************************************
  */
 
-int pseudoPinsSetup (const int pinBase)
+static struct wiringPiNodeStruct *findPins (const char *func, int pin, int num)
+{
+  struct wiringPiNodeStruct *node = wiringPiFindNode (pin) ;
+
+  if ((node == NULL) || (node->analogRead != myAnalogRead))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "%s: No pseudo pins at pin %d\n", func, pin) ;
+    return NULL ;
+  }
+
+  if ((num < 1) || (pin + num - 1 > node->pinMax))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "%s: %d pins from pin %d run off the end of the table\n", func, num, pin) ;
+    return NULL ;
+  }
+
+  return node ;
+}
+
+
+/*
+ * pseudoPinsRead: pseudoPinsWrite:
+ *	The full 64 bits of a pin
+ *********************************************************************************
+ */
+
+int pseudoPinsRead (const int pin, int64_t *value)
+{
+  return pseudoPinsSnapshot (pin, 1, value) ;
+}
+
+int pseudoPinsWrite (const int pin, const int64_t value)
+{
+  return pseudoPinsWriteList (pin, 1, &value) ;
+}
+
+
+/*
+ * pseudoPinsSnapshot:
+ *	Read num pins from pin into values [], all as they were at the
+ *	one moment - no write to them is seen half done.
+ *********************************************************************************
+ */
+
+int pseudoPinsSnapshot (const int pin, const int num, int64_t values [])
+{
+  struct wiringPiNodeStruct *node ;
+
+  if ((node = findPins ("pseudoPinsSnapshot", pin, num)) == NULL)
+    return -1 ;
+
+  readValues ((struct pseudoPinsStruct *)node->priv, pin - node->pinBase, num, values) ;
+
+  return 0 ;
+}
+
+
+/*
+ * pseudoPinsWriteList:
+ *	Write values [] to num pins from pin, as one.
+ *********************************************************************************
+ */
+
+int pseudoPinsWriteList (const int pin, const int num, const int64_t values [])
 {
   struct wiringPiNodeStruct *node ;
-  void *ptr ;
 
-  node = wiringPiNewNode (pinBase, PSEUDO_PINS) ;
+  if ((node = findPins ("pseudoPinsWriteList", pin, num)) == NULL)
+    return -1 ;
 
-  node->fd = shm_open (SHARED_NAME, O_CREAT | O_RDWR, 0666) ;
+  writeValues ((struct pseudoPinsStruct *)node->priv, pin - node->pinBase, num, values) ;
+
+  return 0 ;
+}
+
+
+/*
+ * pseudoPinsWait:
+ *	Sleep until one of the num (up to 64) pins from pin is different to
+ *	what's in values [] - what the caller last saw - or for timeout mS
+ *	(-1 for ever). values [] is brought up to date either way. Returns 1 if
+ *	something changed, 0 on the timeout, -1 on error.
+ *	Any change to the table wakes all that wait on it, so it's best
+ *	not to share one between a lot of busy pins and a lot of waiters.
+ *********************************************************************************
+ */
+
+int pseudoPinsWait (const int pin, const int num, int64_t values [], const int timeout)
+{
+  struct wiringPiNodeStruct *node ;
+  struct pseudoPinsStruct *table ;
+  struct timespec ts ;
+  int64_t now [PSEUDO_PINS] ;
+  uint32_t changes ;
+  unsigned int start = millis () ;
+  int i, left ;
 
-  if (node->fd < 0)
+  if (num > PSEUDO_PINS)
+    return wiringPiFailure (WPI_ALMOST, "pseudoPinsWait: num must be 1-%d (%d)\n", PSEUDO_PINS, num) ;
+
+  if ((node = findPins ("pseudoPinsWait", pin, num)) == NULL)
+    return -1 ;
+
+  table = (struct pseudoPinsStruct *)node->priv ;
+
+  for (;;)
+  {
+    changes = __atomic_load_n (&table->changes, __ATOMIC_SEQ_CST) ;
+
+    readValues (table, pin - node->pinBase, num, now) ;
+    if (memcmp (now, values, num * sizeof (int64_t)) != 0)
+    {
+      memcpy (values, now, num * sizeof (int64_t)) ;
+      return 1 ;
+    }
+
+    if (timeout >= 0)
+    {
+      if ((left = timeout - (int)(millis () - start)) <= 0)
+	return 0 ;
+      ts.tv_sec  = left / 1000 ;
+      ts.tv_nsec = (left % 1000) * 1000000 ;
+    }
+
+// The futex only sleeps if changes is still what we read before the
+//	values, so a write in between isn't missed.
+
+    __atomic_add_fetch (&table->waiters, 1, __ATOMIC_SEQ_CST) ;
+    i = futex (&table->changes, FUTEX_WAIT, changes, (timeout >= 0) ? &ts : NULL) ;
+    __atomic_sub_fetch (&table->waiters, 1, __ATOMIC_SEQ_CST) ;
+
+    if ((i < 0) && (errno != EAGAIN) && (errno != EINTR) && (errno != ETIMEDOUT))
+      return wiringPiFailure (WPI_ALMOST, "pseudoPinsWait: futex: %s\n", strerror (errno)) ;
+  }
+}
+
+
+/*
+ * pseudoPinsSetupShared:
+ *	Create a new wiringPi device node for numPins pseudo pins in the
+ *	table called name (NULL for the default one that pseudoPinsSetup
+ *	uses), making the table if it's not there. Whoever makes it gives
+ *	it its size; a table that's there already has to have at least
+ *	numPins.
+ *********************************************************************************
+ */
+
+int pseudoPinsSetupShared (const int pinBase, const int numPins, const char *name)
+{
+  struct wiringPiNodeStruct *node ;
+  struct pseudoPinsStruct *table ;
+  struct stat st ;
+  size_t size = sizeof (struct pseudoPinsStruct) + numPins * sizeof (int64_t) ;
+  int fd, made = TRUE, tries ;
+
+  if (name == NULL)
+    name = SHARED_NAME ;
+
+  if ((numPins < 1) || (numPins > MAX_PINS))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "pseudoPinsSetupShared: numPins must be 1-%d (%d)\n", MAX_PINS, numPins) ;
     return FALSE ;
+  }
+
+// Only one of us gets to make it; the others wait for it to be made
+
+  if ((fd = shm_open (name, O_CREAT | O_EXCL | O_RDWR, 0666)) < 0)
+  {
+    if ((errno != EEXIST) || ((fd = shm_open (name, O_RDWR, 0666)) < 0))
+      return FALSE ;
+    made = FALSE ;
+  }
 
-  if (ftruncate (node->fd, PSEUDO_PINS * sizeof (int)) < 0)
+  if (made)
+  {
+    if (ftruncate (fd, size) < 0)
+    {
+      close (fd) ;
+      shm_unlink (name) ;
+      return FALSE ;
+    }
+  }
+  else
+  {
+    st.st_size = 0 ;
+    for (tries = 0 ; (fstat (fd, &st) == 0) && (st.st_size == 0) && (tries < 100) ; ++tries)
+      delay (10) ;
+    if ((size_t)st.st_size < size)
+    {
+      close (fd) ;
+      (void)wiringPiFailure (WPI_ALMOST, "pseudoPinsSetupShared: %s is too small for %d pins\n", name, numPins) ;
+      return FALSE ;
+    }
+  }
+
+  if ((table = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+  {
+    close (fd) ;
+    if (made)
+      shm_unlink (name) ;
     return FALSE ;
+  }
 
-  ptr = mmap (NULL, PSEUDO_PINS * sizeof (int), PROT_READ | PROT_WRITE, MAP_SHARED, node->fd, 0) ;
+  if (made)
+  {
+    table->pins = numPins ;
+    __atomic_store_n (&table->magic, PSEUDO_MAGIC, __ATOMIC_RELEASE) ;
+  }
+  else
+  {
+    for (tries = 0 ; (__atomic_load_n (&table->magic, __ATOMIC_ACQUIRE) == 0) && (tries < 100) ; ++tries)
+      delay (10) ;
+    if ((table->magic != PSEUDO_MAGIC) || (table->pins < (uint32_t)numPins))
+    {
+      munmap (table, size) ;
+      close (fd) ;
+      (void)wiringPiFailure (WPI_ALMOST, "pseudoPinsSetupShared: %s is not a table of %d pins\n", name, numPins) ;
+      return FALSE ;
+    }
+  }
 
-  node->data0 = (unsigned int)ptr ;
+  node = wiringPiNewNode (pinBase, numPins) ;
 
-  node->analogRead  = myAnalogRead ;
-  node->analogWrite = myAnalogWrite ;
+  node->fd           = fd ;
+  node->priv         = table ;
+  node->analogRead   = myAnalogRead ;
+  node->analogWrite  = myAnalogWrite ;
+  node->digitalRead  = myDigitalRead ;
+  node->digitalWrite = myDigitalWrite ;
 
   return TRUE ;
 }
+
+
+/*
+ * pseudoPinsSetup:
+ *	Create a new wiringPi device node for the pseudoPins driver
+ *********************************************************************************
+ */
+
+int pseudoPinsSetup (const int pinBase)
+{
+  return pseudoPinsSetupShared (pinBase, PSEUDO_PINS, SHARED_NAME) ;
+}
@@ -23,4 +23,21 @@
  ***********************************************************************
  */
 
-extern int pseudoPinsSetup (const int pinBase) ;
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int pseudoPinsSetup       (const int pinBase) ;
+extern int pseudoPinsSetupShared (const int pinBase, const int numPins, const char *name) ;
+
+extern int pseudoPinsRead        (const int pin, int64_t *value) ;
+extern int pseudoPinsWrite       (const int pin, const int64_t value) ;
+extern int pseudoPinsSnapshot    (const int pin, const int num, int64_t values []) ;
+extern int pseudoPinsWriteList   (const int pin, const int num, const int64_t values []) ;
+extern int pseudoPinsWait        (const int pin, const int num, int64_t values [], const int timeout) ;
+
+#ifdef __cplusplus
+}
+#endif
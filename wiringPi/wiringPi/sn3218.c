@@ -54,7 +54,7 @@ int sn3218Setup (const int pinBase)
   int fd ;
   struct wiringPiNodeStruct *node ;
 
-  if ((fd = wiringPiI2CSetup (0x54)) < 0)
+  if ((fd = wiringPiI2COpen (-1, 0x54)) < 0)
     return FALSE ;
 
 // Setup the chip - initialise all 18 LEDs to off
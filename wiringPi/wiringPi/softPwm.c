@@ -66,11 +66,9 @@ static volatile int newPin = -1 ;
 
 static void *softPwmThread (void *arg)
 {
-  int pin, mark, space ;
-  struct sched_param param ;
-
-  param.sched_priority = sched_get_priority_max (SCHED_RR) ;
-  pthread_setschedparam (pthread_self (), SCHED_RR, &param) ;
+  int pin, mark, space, slot ;
+  unsigned int start ;
+  char name [16] ;
 
   pin = *((int *)arg) ;
   free (arg) ;
@@ -78,7 +76,8 @@ static void *softPwmThread (void *arg)
   pin    = newPin ;
   newPin = -1 ;
 
-  piHiPri (90) ;
+  snprintf (name, sizeof (name), "softPwm-%d", pin) ;
+  slot = piThreadRealtime (name, 90) ;
 
   for (;;)
   {
@@ -87,11 +86,15 @@ static void *softPwmThread (void *arg)
 
     if (mark != 0)
       digitalWrite (pin, HIGH) ;
+    start = micros () ;
     delayMicroseconds (mark * 100) ;
+    piThreadWakeup (slot, start, mark * 100) ;
 
     if (space != 0)
       digitalWrite (pin, LOW) ;
+    start = micros () ;
     delayMicroseconds (space * 100) ;
+    piThreadWakeup (slot, start, space * 100) ;
   }
 
   return NULL ;
@@ -79,7 +79,8 @@ static int pulseWidth [MAX_SERVOS] ;	// microseconds
 static PI_THREAD (softServoThread)
 {
   register int i, j, k, m, tmp ;
-  int lastDelay, pin, servo ;
+  int lastDelay, pin, servo, slot ;
+  unsigned int start ;
 
   int myDelays [MAX_SERVOS] ;
   int myPins   [MAX_SERVOS] ;
@@ -90,7 +91,7 @@ static PI_THREAD (softServoThread)
   tTotal.tv_sec  =    0 ;
   tTotal.tv_usec = 8000 ;
 
-  piHiPri (50) ;
+  slot = piThreadRealtime ("softServo", 50) ;
 
   for (;;)
   {
@@ -146,7 +147,9 @@ static PI_THREAD (softServoThread)
     timersub (&tTotal, &tPeriod, &tGap) ;
     tNs.tv_sec  = tGap.tv_sec ;
     tNs.tv_nsec = tGap.tv_usec * 1000 ;
+    start = micros () ;
     nanosleep (&tNs, NULL) ;
+    piThreadWakeup (slot, start, tGap.tv_usec) ;
   }
 
   return NULL ;
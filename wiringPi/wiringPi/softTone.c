@@ -50,16 +50,15 @@ static int newPin = -1 ;
 
 static PI_THREAD (softToneThread)
 {
-  int pin, freq, halfPeriod ;
-  struct sched_param param ;
-
-  param.sched_priority = sched_get_priority_max (SCHED_RR) ;
-  pthread_setschedparam (pthread_self (), SCHED_RR, &param) ;
+  int pin, freq, halfPeriod, slot ;
+  unsigned int start ;
+  char name [16] ;
 
   pin    = newPin ;
   newPin = -1 ;
 
-  piHiPri (50) ;
+  snprintf (name, sizeof (name), "softTone-%d", pin) ;
+  slot = piThreadRealtime (name, 50) ;
 
   for (;;)
   {
@@ -71,10 +70,14 @@ static PI_THREAD (softToneThread)
       halfPeriod = 500000 / freq ;
 
       digitalWrite (pin, HIGH) ;
+      start = micros () ;
       delayMicroseconds (halfPeriod) ;
+      piThreadWakeup (slot, start, halfPeriod) ;
 
       digitalWrite (pin, LOW) ;
+      start = micros () ;
       delayMicroseconds (halfPeriod) ;
+      piThreadWakeup (slot, start, halfPeriod) ;
     }
   }
 
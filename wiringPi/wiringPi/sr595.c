@@ -36,32 +36,22 @@
 
 
 /*
- * myDigitalWrite:
+ * latchOut:
+ *	Clock the output register out to the shift register(s)
  *********************************************************************************
  */
 
-static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
+static void latchOut (struct wiringPiNodeStruct *node)
 {
-  unsigned int mask ;
   int  dataPin, clockPin, latchPin ;
   int  bit, bits, output ;
 
-  pin     -= node->pinBase ;				// Normalise pin number
   bits     = node->pinMax - node->pinBase + 1 ;		// ie. number of clock pulses
   dataPin  = node->data0 ;
   clockPin = node->data1 ;
   latchPin = node->data2 ;
   output   = node->data3 ;
 
-  mask = 1 << pin ;
-
-  if (value == LOW)
-    output &= (~mask) ;
-  else
-    output |=   mask ;
-
-  node->data3 = output ;
-
 // A low -> high latch transition copies the latch to the output pins
 
   digitalWrite (latchPin, LOW) ; delayMicroseconds (1) ;
@@ -76,6 +66,53 @@ static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
 }
 
 
+/*
+ * myDigitalWrite:
+ *********************************************************************************
+ */
+
+static void myDigitalWrite (struct wiringPiNodeStruct *node, int pin, int value)
+{
+  unsigned int mask ;
+
+  pin -= node->pinBase ;				// Normalise pin number
+
+  mask = 1 << pin ;
+
+  if (value == LOW)
+    node->data3 &= (~mask) ;
+  else
+    node->data3 |=   mask ;
+
+  latchOut (node) ;
+}
+
+
+/*
+ * writePort:
+ *	Change width pins from pin on with a single pass through the
+ *	shift register(s).
+ *********************************************************************************
+ */
+
+static void writePort (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  unsigned int mask ;
+  int shift = pin - node->pinBase ;
+
+  mask = (width < 32) ? (1U << width) - 1 : 0xFFFFFFFF ;
+  mask = mask << shift ;
+
+  node->data3 = (node->data3 & ~mask) | ((value << shift) & mask) ;
+
+  latchOut (node) ;
+}
+
+static void myDigitalWrite8  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value,  8) ; }
+static void myDigitalWrite16 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 16) ; }
+static void myDigitalWrite32 (struct wiringPiNodeStruct *node, int pin, unsigned int value) { writePort (node, pin, value, 32) ; }
+
+
 /*
  * sr595Setup:
  *	Create a new instance of a 74x595 shift register GPIO expander.
@@ -94,6 +131,9 @@ int sr595Setup (const int pinBase, const int numPins,
   node->data2           = latchPin ;
   node->data3           = 0 ;		// Output register
   node->digitalWrite    = myDigitalWrite ;
+  node->digitalWrite8   = myDigitalWrite8 ;
+  node->digitalWrite16  = myDigitalWrite16 ;
+  node->digitalWrite32  = myDigitalWrite32 ;
 
 // Initialise the underlying hardware
 
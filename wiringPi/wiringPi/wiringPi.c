@@ -74,6 +74,7 @@
 
 #include "softPwm.h"
 #include "softTone.h"
+#include "wpiEvent.h"
 
 #include "wiringPi.h"
 #include "../version.h"
@@ -145,6 +146,7 @@ static volatile unsigned int GPIO_PWM ;
 
 #define	PWM_CONTROL 0
 #define	PWM_STATUS  1
+#define	PWM_FIFO    6
 #define	PWM0_RANGE  4
 #define	PWM0_DATA   5
 #define	PWM1_RANGE  8
@@ -171,6 +173,14 @@ static volatile unsigned int GPIO_PWM ;
 #define	PWM1_SERIAL     0x0200  // Run in serial mode
 #define	PWM1_ENABLE     0x0100  // Channel Enable
 
+#define	PWM_CLRFIFO     0x0040  // Clear FIFO (both channels)
+
+#define	PWM_STA_FULL    0x0001  // FIFO full
+
+// The PWM clock is fed from the 19.2MHz oscillator (clock source 1)
+
+#define	PWM_CLOCK_HZ	19200000
+
 // Timer
 //	Word offsets
 
@@ -191,6 +201,11 @@ static volatile uint32_t *pwm ;
 static volatile uint32_t *clk ;
 static volatile uint32_t *pads ;
 
+// Set when pwmSetRegisters has pointed pwm and clk somewhere, so the PWM
+//	functions work without wiringPiSetup
+
+static int pwmHooked = FALSE ;
+
 #ifdef	USE_TIMER
 static volatile uint32_t *timer ;
 static volatile uint32_t *timerIrqRaw ;
@@ -320,6 +335,55 @@ static int sysFds [64] =
 // ISR Data
 
 static void (*isrFunctions [64])(void) ;
+static void (*isrArgFunctions [64])(int pin, int level, unsigned long long timestamp, void *userdata) ;
+static void  *isrArgData [64] ;
+
+// Callbacks of node pins, one per pin of the node, see wiringPiNodeEdge
+
+struct wiringPiNodeISRStruct
+{
+  int    mode ;
+  void (*function)(void) ;
+  void (*argFunction)(int pin, int level, unsigned long long timestamp, void *userdata) ;
+  void  *userdata ;
+} ;
+
+// Set by the caller's thread, read by the driver's interrupt thread
+
+static pthread_mutex_t nodeISRMutex = PTHREAD_MUTEX_INITIALIZER ;
+static int isrGpio    [64] ;	// BCM pin the handler thread waits on
+static int isrRunning [64] ;	// Handler thread started
+
+// Pulse meters:
+//	Per-pin edge counters and period statistics, fed directly by the
+//	interrupt handler threads so user code only has to read aggregates.
+
+struct pulseMeterStruct
+{
+  int      enabled ;
+  int      mode ;
+  int      haveEdge ;
+  uint64_t lastEdge ;		// Last period edge (rising in INT_EDGE_BOTH mode)
+  struct wpiPulseStatsStruct stats ;
+} ;
+
+static struct pulseMeterStruct pulseMeters [64] ;
+static pthread_mutex_t pulseMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+// ISR filters:
+//	Glitch and debounce filtering applied by the interrupt handler thread
+//	before anything is dispatched for an edge.
+
+struct isrFilterStruct
+{
+  unsigned int glitchUs ;	// Pulses shorter than this are dropped
+  unsigned int debounceUs ;	// Line must be quiet this long
+  int          mode ;		// Edge mode the pin was set up with
+  int          stable ;		// Last accepted level
+  struct wpiISRFilterStatsStruct stats ;
+} ;
+
+static struct isrFilterStruct isrFilters [64] ;
 
 
 // Doing it the Arduino way with lookup tables...
@@ -1137,6 +1201,19 @@ int getAlt (int pin)
 }
 
 
+/*
+ * pwmUsable:
+ *	The PWM registers are there: mapped by wiringPiSetup, or set with
+ *	pwmSetRegisters
+ *********************************************************************************
+ */
+
+static int pwmUsable (void)
+{
+  return pwmHooked || (wiringPiMode == WPI_MODE_PINS) || (wiringPiMode == WPI_MODE_PHYS) || (wiringPiMode == WPI_MODE_GPIO) ;
+}
+
+
 /*
  * pwmSetMode:
  *	Select the native "balanced" mode, or standard mark:space mode
@@ -1145,7 +1222,7 @@ int getAlt (int pin)
 
 void pwmSetMode (int mode)
 {
-  if ((wiringPiMode == WPI_MODE_PINS) || (wiringPiMode == WPI_MODE_PHYS) || (wiringPiMode == WPI_MODE_GPIO))
+  if (pwmUsable ())
   {
     if (mode == PWM_MODE_MS)
       *(pwm + PWM_CONTROL) = PWM0_ENABLE | PWM1_ENABLE | PWM0_MS_MODE | PWM1_MS_MODE ;
@@ -1164,7 +1241,7 @@ void pwmSetMode (int mode)
 
 void pwmSetRange (unsigned int range)
 {
-  if ((wiringPiMode == WPI_MODE_PINS) || (wiringPiMode == WPI_MODE_PHYS) || (wiringPiMode == WPI_MODE_GPIO))
+  if (pwmUsable ())
   {
     *(pwm + PWM0_RANGE) = range ; delayMicroseconds (10) ;
     *(pwm + PWM1_RANGE) = range ; delayMicroseconds (10) ;
@@ -1180,22 +1257,19 @@ void pwmSetRange (unsigned int range)
  *********************************************************************************
  */
 
-void pwmSetClock (int divisor)
+static void pwmClockDivisor (int divisor)
 {
   uint32_t pwm_control ;
-  divisor &= 4095 ;
 
-  if ((wiringPiMode == WPI_MODE_PINS) || (wiringPiMode == WPI_MODE_PHYS) || (wiringPiMode == WPI_MODE_GPIO))
-  {
-    if (wiringPiDebug)
-      printf ("Setting to: %d. Current: 0x%08X\n", divisor, *(clk + PWMCLK_DIV)) ;
+  if (wiringPiDebug)
+    printf ("Setting to: %d. Current: 0x%08X\n", divisor, *(clk + PWMCLK_DIV)) ;
 
-    pwm_control = *(pwm + PWM_CONTROL) ;		// preserve PWM_CONTROL
+  pwm_control = *(pwm + PWM_CONTROL) ;		// preserve PWM_CONTROL
 
 // We need to stop PWM prior to stopping PWM clock in MS mode otherwise BUSY
 // stays high.
 
-    *(pwm + PWM_CONTROL) = 0 ;				// Stop PWM
+  *(pwm + PWM_CONTROL) = 0 ;				// Stop PWM
 
 // Stop PWM clock before changing divisor. The delay after this does need to
 // this big (95uS occasionally fails, 100uS OK), it's almost as though the BUSY
@@ -1203,20 +1277,209 @@ void pwmSetClock (int divisor)
 // adjusted the clock sometimes switches to very slow, once slow further DIV
 // adjustments do nothing and it's difficult to get out of this mode.
 
-    *(clk + PWMCLK_CNTL) = BCM_PASSWORD | 0x01 ;	// Stop PWM Clock
-      delayMicroseconds (110) ;			// prevents clock going sloooow
+  *(clk + PWMCLK_CNTL) = BCM_PASSWORD | 0x01 ;	// Stop PWM Clock
+    delayMicroseconds (110) ;			// prevents clock going sloooow
 
-    while ((*(clk + PWMCLK_CNTL) & 0x80) != 0)	// Wait for clock to be !BUSY
-      delayMicroseconds (1) ;
+  while ((*(clk + PWMCLK_CNTL) & 0x80) != 0)	// Wait for clock to be !BUSY
+    delayMicroseconds (1) ;
 
-    *(clk + PWMCLK_DIV)  = BCM_PASSWORD | (divisor << 12) ;
+  *(clk + PWMCLK_DIV)  = BCM_PASSWORD | (divisor << 12) ;
 
-    *(clk + PWMCLK_CNTL) = BCM_PASSWORD | 0x11 ;	// Start PWM clock
-    *(pwm + PWM_CONTROL) = pwm_control ;		// restore PWM_CONTROL
+  *(clk + PWMCLK_CNTL) = BCM_PASSWORD | 0x11 ;	// Start PWM clock
+  *(pwm + PWM_CONTROL) = pwm_control ;		// restore PWM_CONTROL
 
-    if (wiringPiDebug)
-      printf ("Set     to: %d. Now    : 0x%08X\n", divisor, *(clk + PWMCLK_DIV)) ;
+  if (wiringPiDebug)
+    printf ("Set     to: %d. Now    : 0x%08X\n", divisor, *(clk + PWMCLK_DIV)) ;
+}
+
+void pwmSetClock (int divisor)
+{
+  divisor &= 4095 ;
+
+  if (pwmUsable ())
+    pwmClockDivisor (divisor) ;
+}
+
+
+/*
+ * pwmSetRegisters:
+ *	Point the PWM and PWM clock register blocks somewhere else, e.g. at a
+ *	simulated register block for testing. pwmRegs needs at least 10 words,
+ *	clkRegs at least 42. The PWM functions then work without
+ *	wiringPiSetup () having been called, pwmWrite taking BCM GPIO pin
+ *	numbers as after wiringPiSetupGpio ().
+ *********************************************************************************
+ */
+
+void pwmSetRegisters (volatile unsigned int *pwmRegs, volatile unsigned int *clkRegs)
+{
+  pwm = pwmRegs ;
+  clk = clkRegs ;
+  pwmHooked = (pwmRegs != NULL) && (clkRegs != NULL) ;
+}
+
+
+/*
+ * pwmChannelMode:
+ *	Set mark:space or balanced mode and the output polarity of one PWM
+ *	channel (0 or 1) and enable it, leaving the other channel alone.
+ *********************************************************************************
+ */
+
+int pwmChannelMode (int channel, int mode, int invert)
+{
+  uint32_t control, bits ;
+  int shift ;
+
+  if ((channel < 0) || (channel > 1))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelMode: channel must be 0 or 1 (%d)\n", channel) ;
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelMode: PWM registers are not mapped\n") ;
+
+  shift = channel * 8 ;
+  bits  = PWM0_ENABLE ;
+  if (mode == PWM_MODE_MS)
+    bits |= PWM0_MS_MODE ;
+  if (invert)
+    bits |= PWM0_REVPOLAR ;
+
+  control  = *(pwm + PWM_CONTROL) ;
+  control &= ~((PWM0_ENABLE | PWM0_MS_MODE | PWM0_REVPOLAR) << shift) ;
+  *(pwm + PWM_CONTROL) = control | (bits << shift) ;
+
+  return 0 ;
+}
+
+
+/*
+ * pwmChannelRange:
+ *	Set the range register of one PWM channel
+ *********************************************************************************
+ */
+
+int pwmChannelRange (int channel, unsigned int range)
+{
+  if ((channel < 0) || (channel > 1))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelRange: channel must be 0 or 1 (%d)\n", channel) ;
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelRange: PWM registers are not mapped\n") ;
+
+  *(pwm + PWM0_RANGE + channel * 4) = range ; delayMicroseconds (10) ;
+
+  return 0 ;
+}
+
+
+/*
+ * pwmChannelFrequency:
+ *	Set the range of a channel and work out the clock divisor to give the
+ *	requested frequency in Hz. Returns the frequency actually achieved.
+ *	Note that both channels share the one PWM clock, so this also changes
+ *	the frequency of the other channel (but not its range).
+ *********************************************************************************
+ */
+
+int pwmChannelFrequency (int channel, unsigned int freq, unsigned int range)
+{
+  unsigned int divisor ;
+
+  if ((freq == 0) || (range == 0))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelFrequency: frequency and range must be > 0\n") ;
+
+  if ((freq * range) / range == freq)
+    divisor = (PWM_CLOCK_HZ + (freq * range) / 2) / (freq * range) ;
+  else
+    divisor = 0 ;				// Overflow, way too fast
+
+  if ((divisor < 2) || (divisor > 4095))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelFrequency: %u Hz is out of reach with a range of %u\n", freq, range) ;
+
+  if (pwmChannelRange (channel, range) < 0)
+    return -1 ;
+
+  pwmClockDivisor ((int)divisor) ;
+
+  return PWM_CLOCK_HZ / (divisor * range) ;
+}
+
+
+/*
+ * pwmChannelWrite:
+ * pwmWriteChannels:
+ *	Set the duty of one channel, or both with back-to-back register
+ *	writes so they change within the same PWM period.
+ *********************************************************************************
+ */
+
+int pwmChannelWrite (int channel, unsigned int value)
+{
+  if ((channel < 0) || (channel > 1))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelWrite: channel must be 0 or 1 (%d)\n", channel) ;
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelWrite: PWM registers are not mapped\n") ;
+
+  *(pwm + PWM0_DATA + channel * 4) = value ;
+
+  return 0 ;
+}
+
+int pwmWriteChannels (unsigned int value0, unsigned int value1)
+{
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmWriteChannels: PWM registers are not mapped\n") ;
+
+  *(pwm + PWM0_DATA) = value0 ;
+  *(pwm + PWM1_DATA) = value1 ;
+
+  return 0 ;
+}
+
+
+/*
+ * pwmChannelFifo:
+ * pwmFifoWrite:
+ *	Switch a channel over to be fed from the PWM FIFO (the FIFO is
+ *	cleared when enabling), then stream samples into it. With both
+ *	channels in FIFO mode the samples are taken alternately.
+ *	pwmFifoWrite does not block - it returns how many samples fitted.
+ *********************************************************************************
+ */
+
+int pwmChannelFifo (int channel, int enable)
+{
+  uint32_t control, bits ;
+
+  if ((channel < 0) || (channel > 1))
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelFifo: channel must be 0 or 1 (%d)\n", channel) ;
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmChannelFifo: PWM registers are not mapped\n") ;
+
+  bits    = (PWM0_USEFIFO | PWM0_REPEATFF) << (channel * 8) ;
+  control = *(pwm + PWM_CONTROL) ;
+
+  if (enable)
+    *(pwm + PWM_CONTROL) = control | bits | PWM_CLRFIFO ;
+  else
+    *(pwm + PWM_CONTROL) = control & ~bits ;
+
+  return 0 ;
+}
+
+int pwmFifoWrite (const unsigned int *samples, int count)
+{
+  int i ;
+
+  if (pwm == NULL)
+    return wiringPiFailure (WPI_ALMOST, "pwmFifoWrite: PWM registers are not mapped\n") ;
+
+  for (i = 0 ; i < count ; ++i)
+  {
+    if ((*(pwm + PWM_STATUS) & PWM_STA_FULL) != 0)
+      break ;
+    *(pwm + PWM_FIFO) = samples [i] ;
   }
+
+  return i ;
 }
 
 
@@ -1275,6 +1538,41 @@ struct wiringPiNodeStruct *wiringPiFindNode (int pin)
 }
 
 
+/*
+ * nodeReadPins: nodeWritePins:
+ *	The port-wide defaults for nodes: one pin at a time, up to the end
+ *	of the node.
+ *********************************************************************************
+ */
+
+static unsigned int nodeReadPins (struct wiringPiNodeStruct *node, int pin, int width)
+{
+  unsigned int value = 0 ;
+  int bit ;
+
+  for (bit = 0 ; (bit < width) && ((pin + bit) <= node->pinMax) ; ++bit)
+    if (node->digitalRead (node, pin + bit) != LOW)
+      value |= 1U << bit ;
+
+  return value ;
+}
+
+static void nodeWritePins (struct wiringPiNodeStruct *node, int pin, unsigned int value, int width)
+{
+  int bit ;
+
+  for (bit = 0 ; (bit < width) && ((pin + bit) <= node->pinMax) ; ++bit)
+    node->digitalWrite (node, pin + bit, (value >> bit) & 1) ;
+}
+
+static unsigned int digitalRead8Default   (struct wiringPiNodeStruct *node, int pin) { return nodeReadPins (node, pin,  8) ; }
+static unsigned int digitalRead16Default  (struct wiringPiNodeStruct *node, int pin) { return nodeReadPins (node, pin, 16) ; }
+static unsigned int digitalRead32Default  (struct wiringPiNodeStruct *node, int pin) { return nodeReadPins (node, pin, 32) ; }
+static         void digitalWrite8Default  (struct wiringPiNodeStruct *node, int pin, unsigned int value) { nodeWritePins (node, pin, value,  8) ; }
+static         void digitalWrite16Default (struct wiringPiNodeStruct *node, int pin, unsigned int value) { nodeWritePins (node, pin, value, 16) ; }
+static         void digitalWrite32Default (struct wiringPiNodeStruct *node, int pin, unsigned int value) { nodeWritePins (node, pin, value, 32) ; }
+
+
 /*
  * wiringPiNewNode:
  *	Create a new GPIO node into the wiringPi handling system
@@ -1283,8 +1581,6 @@ struct wiringPiNodeStruct *wiringPiFindNode (int pin)
 
 static         void pinModeDummy             (UNU struct wiringPiNodeStruct *node, UNU int pin, UNU int mode)  { return ; }
 static         void pullUpDnControlDummy     (UNU struct wiringPiNodeStruct *node, UNU int pin, UNU int pud)   { return ; }
-static unsigned int digitalRead8Dummy        (UNU struct wiringPiNodeStruct *node, UNU int UNU pin)            { return 0 ; }
-static         void digitalWrite8Dummy       (UNU struct wiringPiNodeStruct *node, UNU int pin, UNU int value) { return ; }
 static          int digitalReadDummy         (UNU struct wiringPiNodeStruct *node, UNU int UNU pin)            { return LOW ; }
 static         void digitalWriteDummy        (UNU struct wiringPiNodeStruct *node, UNU int pin, UNU int value) { return ; }
 static         void pwmWriteDummy            (UNU struct wiringPiNodeStruct *node, UNU int pin, UNU int value) { return ; }
@@ -1316,9 +1612,13 @@ struct wiringPiNodeStruct *wiringPiNewNode (int pinBase, int numPins)
   node->pinMode          = pinModeDummy ;
   node->pullUpDnControl  = pullUpDnControlDummy ;
   node->digitalRead      = digitalReadDummy ;
-//node->digitalRead8     = digitalRead8Dummy ;
   node->digitalWrite     = digitalWriteDummy ;
-//node->digitalWrite8    = digitalWrite8Dummy ;
+  node->digitalRead8     = digitalRead8Default ;
+  node->digitalRead16    = digitalRead16Default ;
+  node->digitalRead32    = digitalRead32Default ;
+  node->digitalWrite8    = digitalWrite8Default ;
+  node->digitalWrite16   = digitalWrite16Default ;
+  node->digitalWrite32   = digitalWrite32Default ;
   node->pwmWrite         = pwmWriteDummy ;
   node->analogRead       = analogReadDummy ;
   node->analogWrite      = analogWriteDummy ;
@@ -1534,25 +1834,66 @@ int digitalRead (int pin)
 
 
 /*
- * digitalRead8:
- *	Read 8-bits (a byte) from given start pin.
+ * readPort:
+ *	Read width bits starting at the given pin, pin in bit 0. On-board
+ *	pins are read one at a time, node pins a node at a time with the
+ *	node's port-wide read, so a run of pins can span several devices.
+ *	Missing pins read as 0.
  *********************************************************************************
+ */
 
-unsigned int digitalRead8 (int pin)
+static unsigned int readPort (int pin, int width)
 {
-  struct wiringPiNodeStruct *node = wiringPiNodes ;
+  struct wiringPiNodeStruct *node ;
+  unsigned int value = 0, bits ;
+  int got = 0, n ;
 
-  if ((pin & PI_GPIO_MASK) == 0)		// On-Board Pin
-    return 0 ;
-  else
+  while (got < width)
   {
-    if ((node = wiringPiFindNode (pin)) == NULL)
-      return LOW ;
-    return node->digitalRead8 (node, pin) ;
+    if (((pin + got) & PI_GPIO_MASK) == 0)		// On-Board Pin
+    {
+      if (digitalRead (pin + got) != LOW)
+	value |= 1U << got ;
+      ++got ;
+      continue ;
+    }
+
+    if ((node = wiringPiFindNode (pin + got)) == NULL)
+      break ;
+
+    n = node->pinMax - (pin + got) + 1 ;
+    if (n > (width - got))
+      n = width - got ;
+
+    /**/ if (n <= 8)
+      bits = node->digitalRead8  (node, pin + got) ;
+    else if (n <= 16)
+      bits = node->digitalRead16 (node, pin + got) ;
+    else
+      bits = node->digitalRead32 (node, pin + got) ;
+
+    if (n < 32)
+      bits &= (1U << n) - 1 ;
+
+    value |= bits << got ;
+    got   += n ;
   }
+
+  return value ;
 }
+
+
+/*
+ * digitalRead8: digitalRead16: digitalRead32:
+ *	Read 8, 16 or 32 pins from the given start pin in one go (where
+ *	the device can) - the start pin ends up in bit 0.
+ *********************************************************************************
  */
 
+unsigned int digitalRead8  (int pin) { return readPort (pin,  8) ; }
+unsigned int digitalRead16 (int pin) { return readPort (pin, 16) ; }
+unsigned int digitalRead32 (int pin) { return readPort (pin, 32) ; }
+
 
 /*
  * digitalWrite:
@@ -1598,24 +1939,68 @@ void digitalWrite (int pin, int value)
 
 
 /*
- * digitalWrite8:
- *	Set an output 8-bit byte on the device from the given pin number
+ * writePort:
+ *	Write width bits starting at the given pin, the counterpart of
+ *	readPort. The node hooks write all 8, 16 or 32 pins, stopping only
+ *	at the end of the node, so where the run ends part way through a
+ *	node the hooks only get what they can write in full and the rest
+ *	goes a pin at a time.
  *********************************************************************************
+ */
 
-void digitalWrite8 (int pin, int value)
+static void writePort (int pin, unsigned int value, int width)
 {
-  struct wiringPiNodeStruct *node = wiringPiNodes ;
+  struct wiringPiNodeStruct *node ;
+  int done = 0, n, toEnd ;
 
-  if ((pin & PI_GPIO_MASK) == 0)		// On-Board Pin
-    return ;
-  else
+  while (done < width)
   {
-    if ((node = wiringPiFindNode (pin)) != NULL)
-      node->digitalWrite8 (node, pin, value) ;
+    if (((pin + done) & PI_GPIO_MASK) == 0)		// On-Board Pin
+    {
+      digitalWrite (pin + done, (value >> done) & 1) ;
+      ++done ;
+      continue ;
+    }
+
+    if ((node = wiringPiFindNode (pin + done)) == NULL)
+      return ;
+
+    n     = node->pinMax - (pin + done) + 1 ;
+    toEnd = (n <= (width - done)) ;		// Run goes to the end of the node
+    if (!toEnd)
+    {
+      n = width - done ;
+      /**/ if (n >= 32) n = 32 ;
+      else if (n >= 16) n = 16 ;
+      else if (n >=  8) n =  8 ;
+      else              n =  1 ;
+    }
+
+    /**/ if (n == 1)
+      node->digitalWrite   (node, pin + done, (value >> done) & 1) ;
+    else if (n <= 8)
+      node->digitalWrite8  (node, pin + done, value >> done) ;
+    else if (n <= 16)
+      node->digitalWrite16 (node, pin + done, value >> done) ;
+    else
+      node->digitalWrite32 (node, pin + done, value >> done) ;
+
+    done += n ;
   }
 }
+
+
+/*
+ * digitalWrite8: digitalWrite16: digitalWrite32:
+ *	Set 8, 16 or 32 output pins from the given start pin in one go
+ *	(where the device can) - bit 0 goes to the start pin.
+ *********************************************************************************
  */
 
+void digitalWrite8  (int pin, int value)          { writePort (pin, value,  8) ; }
+void digitalWrite16 (int pin, int value)          { writePort (pin, value, 16) ; }
+void digitalWrite32 (int pin, unsigned int value) { writePort (pin, value, 32) ; }
+
 
 /*
  * pwmWrite:
@@ -1633,7 +2018,7 @@ void pwmWrite (int pin, int value)
       pin = pinToGpio [pin] ;
     else if (wiringPiMode == WPI_MODE_PHYS)
       pin = physToGpio [pin] ;
-    else if (wiringPiMode != WPI_MODE_GPIO)
+    else if ((wiringPiMode != WPI_MODE_GPIO) && !pwmHooked)
       return ;
 
     *(pwm + gpioToPwmPort [pin]) = value ;
@@ -1844,41 +2229,186 @@ unsigned int digitalReadByte2 (void)
  *********************************************************************************
  */
 
-int waitForInterrupt (int pin, int mS)
+static int interruptWait (int fd, long long uS, int *level)
 {
-  int fd, x ;
+  int x ;
   uint8_t c ;
   struct pollfd polls ;
-
-  /**/ if (wiringPiMode == WPI_MODE_PINS)
-    pin = pinToGpio [pin] ;
-  else if (wiringPiMode == WPI_MODE_PHYS)
-    pin = physToGpio [pin] ;
-
-  if ((fd = sysFds [pin]) == -1)
-    return -2 ;
+  struct timespec timeout ;
 
 // Setup poll structure
 
   polls.fd     = fd ;
   polls.events = POLLPRI | POLLERR ;
 
+  timeout.tv_sec  = (time_t)(uS / 1000000) ;
+  timeout.tv_nsec = (long)(uS % 1000000) * 1000L ;
+
 // Wait for it ...
 
-  x = poll (&polls, 1, mS) ;
+  x = ppoll (&polls, 1, (uS < 0) ? NULL : &timeout, NULL) ;
 
 // If no error, do a dummy read to clear the interrupt
 //	A one character read appars to be enough.
+//	It also tells us the level the pin settled at.
 
   if (x > 0)
   {
     lseek (fd, 0, SEEK_SET) ;	// Rewind
+    c = '0' ;
     (void)read (fd, &c, 1) ;	// Read & clear
+    if (level != NULL)
+      *level = (c == '0') ? LOW : HIGH ;
   }
 
   return x ;
 }
 
+int waitForInterrupt (int pin, int mS)
+{
+  int fd ;
+
+  /**/ if (wiringPiMode == WPI_MODE_PINS)
+    pin = pinToGpio [pin] ;
+  else if (wiringPiMode == WPI_MODE_PHYS)
+    pin = physToGpio [pin] ;
+
+  if ((fd = sysFds [pin]) == -1)
+    return -2 ;
+
+  return interruptWait (fd, (mS < 0) ? -1 : (long long)mS * 1000, NULL) ;	// 64 bits, mS * 1000 overflows an int past ~35 minutes
+}
+
+
+/*
+ * interruptLevel:
+ *	Read the current level of a /sys/class/gpio value file
+ *********************************************************************************
+ */
+
+static int interruptLevel (int fd)
+{
+  uint8_t c = '0' ;
+
+  lseek (fd, 0, SEEK_SET) ;
+  (void)read (fd, &c, 1) ;
+
+  return (c == '0') ? LOW : HIGH ;
+}
+
+
+/*
+ * timestampMicros:
+ *	64-bit version of micros () used to timestamp edges, so it doesn't
+ *	wrap after 71 minutes.
+ *********************************************************************************
+ */
+
+static uint64_t timestampMicros (void)
+{
+  struct timespec ts ;
+
+  clock_gettime (CLOCK_MONOTONIC_RAW, &ts) ;
+  return (uint64_t)ts.tv_sec * (uint64_t)1000000 + (uint64_t)(ts.tv_nsec / 1000) - epochMicro ;
+}
+
+
+/*
+ * pulseMeterEdge:
+ *	Account one edge in the pulse meter of the given pin.
+ *	A period runs from one edge to the next, or from rising edge to
+ *	rising edge in INT_EDGE_BOTH mode, where the falling edges give us
+ *	the high time for the duty cycle.
+ *********************************************************************************
+ */
+
+static void pulseMeterEdge (int pin, int level, uint64_t when)
+{
+  struct pulseMeterStruct *meter = &pulseMeters [pin] ;
+  unsigned int period ;
+
+  pthread_mutex_lock (&pulseMutex) ;
+
+    ++meter->stats.edges ;
+
+    if ((meter->mode != INT_EDGE_BOTH) || (level == HIGH))
+    {
+      if (meter->haveEdge)
+      {
+	period = (unsigned int)(when - meter->lastEdge) ;
+	if ((meter->stats.periods == 0) || (period < meter->stats.periodMin))
+	  meter->stats.periodMin = period ;
+	if (period > meter->stats.periodMax)
+	  meter->stats.periodMax = period ;
+	meter->stats.periodTotal += period ;
+	++meter->stats.periods ;
+      }
+      meter->lastEdge = when ;
+      meter->haveEdge = TRUE ;
+    }
+    else if (meter->haveEdge)
+      meter->stats.highTotal += when - meter->lastEdge ;
+
+  pthread_mutex_unlock (&pulseMutex) ;
+}
+
+
+/*
+ * interruptFilter:
+ *	Called after an edge woke the handler thread. With a glitch filter we
+ *	swallow everything inside the glitch window, with debouncing we wait
+ *	until the line has been quiet for the debounce time. Then the level
+ *	the line settled at has to be a real change for the edge mode in use.
+ *	Returns TRUE if the edge should be dispatched.
+ *********************************************************************************
+ */
+
+static int interruptFilter (int pin, int fd, int *level, uint64_t when)
+{
+  struct isrFilterStruct *filter = &isrFilters [pin] ;
+  uint64_t elapsed ;
+  int accept ;
+
+  if ((filter->glitchUs == 0) && (filter->debounceUs == 0))
+  {
+    ++filter->stats.accepted ;
+    return TRUE ;
+  }
+
+  if (filter->glitchUs > 0)
+    for (;;)
+    {
+      elapsed = timestampMicros () - when ;
+      if (elapsed >= filter->glitchUs)
+	break ;
+      if (interruptWait (fd, (int)(filter->glitchUs - elapsed), NULL) > 0)
+	++filter->stats.bounces ;
+    }
+
+  if (filter->debounceUs > 0)
+    while (interruptWait (fd, (int)filter->debounceUs, NULL) > 0)
+      ++filter->stats.bounces ;
+
+  *level = interruptLevel (fd) ;
+
+  /**/ if (filter->mode == INT_EDGE_RISING)
+    accept = (*level == HIGH) ;
+  else if (filter->mode == INT_EDGE_FALLING)
+    accept = (*level == LOW) ;
+  else
+    accept = (*level != filter->stable) ;
+
+  if (accept)
+  {
+    filter->stable = *level ;
+    ++filter->stats.accepted ;
+  }
+  else
+    ++filter->stats.glitches ;
+
+  return accept ;
+}
+
 
 /*
  * interruptHandler:
@@ -1888,32 +2418,62 @@ int waitForInterrupt (int pin, int mS)
  *********************************************************************************
  */
 
-static void *interruptHandler (UNU void *arg)
+static void isrDispatch (int pin, int level, uint64_t when)
 {
-  int myPin ;
+  if (pulseMeters [pin].enabled)
+    pulseMeterEdge (pin, level, when) ;
 
-  (void)piHiPri (55) ;	// Only effective if we run as root
+  wpiEventPost (pin, level, when) ;
+
+  if (isrFunctions [pin] != NULL)
+    isrFunctions [pin] () ;
+  else if (isrArgFunctions [pin] != NULL)
+    isrArgFunctions [pin] (pin, level, when, isrArgData [pin]) ;
+}
+
+static void *interruptHandler (UNU void *arg)
+{
+  int myPin, fd, level ;
+  uint64_t when ;
+  char name [16] ;
 
   myPin   = pinPass ;
   pinPass = -1 ;
 
+  fd = sysFds [isrGpio [myPin]] ;
+
+// The sysfs interface doesn't tell us when the edge happened, only that
+//	it did, so there's nothing to measure the wakeup against: the slot
+//	is only used for the placement and records no latency.
+
+  snprintf (name, sizeof (name), "isr-%d", myPin) ;
+  (void)piThreadRealtime (name, 55) ;	// Only effective if we run as root
+
   for (;;)
-    if (waitForInterrupt (myPin, -1) > 0)
-      isrFunctions [myPin] () ;
+  {
+    level = LOW ;
+    if (interruptWait (fd, -1, &level) <= 0)
+      continue ;
+
+    when = timestampMicros () ;
+    if (interruptFilter (myPin, fd, &level, when))
+      isrDispatch (myPin, level, when) ;
+  }
 
   return NULL ;
 }
 
 
 /*
- * wiringPiISR:
+ * wiringPiISRMode:
  *	Pi Specific.
- *	Take the details and create an interrupt handler that will do a call-
- *	back to the user supplied function.
+ *	Set the edge mode of a pin and make sure its interrupt handler thread
+ *	is running, without touching the callbacks. Used by wiringPiISR and
+ *	by the pulse meters and event queues.
  *********************************************************************************
  */
 
-int wiringPiISR (int pin, int mode, void (*function)(void))
+int wiringPiISRMode (int pin, int mode)
 {
   pthread_t threadId ;
   const char *modeS ;
@@ -1925,7 +2485,7 @@ int wiringPiISR (int pin, int mode, void (*function)(void))
   int   bcmGpioPin ;
 
   if ((pin < 0) || (pin > 63))
-    return wiringPiFailure (WPI_FATAL, "wiringPiISR: pin must be 0-63 (%d)\n", pin) ;
+    return wiringPiFailure (WPI_FATAL, "wiringPiISRMode: pin must be 0-63 (%d)\n", pin) ;
 
   /**/ if (wiringPiMode == WPI_MODE_UNINITIALISED)
     return wiringPiFailure (WPI_FATAL, "wiringPiISR: wiringPi has not been initialised. Unable to continue.\n") ;
@@ -1948,6 +2508,8 @@ int wiringPiISR (int pin, int mode, void (*function)(void))
       modeS = "falling" ;
     else if (mode == INT_EDGE_RISING)
       modeS = "rising" ;
+    else if (mode == INT_EDGE_NONE)
+      modeS = "none" ;
     else
       modeS = "both" ;
 
@@ -1991,15 +2553,249 @@ int wiringPiISR (int pin, int mode, void (*function)(void))
   for (i = 0 ; i < count ; ++i)
     read (sysFds [bcmGpioPin], &c, 1) ;
 
-  isrFunctions [pin] = function ;
+  isrGpio [pin] = bcmGpioPin ;
+
+  isrFilters [pin].mode   = mode ;
+  isrFilters [pin].stable = interruptLevel (sysFds [bcmGpioPin]) ;
+
+// One handler thread per pin - if it's already running it simply picks up
+//	the new function.
 
   pthread_mutex_lock (&pinMutex) ;
-    pinPass = pin ;
-    pthread_create (&threadId, NULL, interruptHandler, NULL) ;
-    while (pinPass != -1)
-      delay (1) ;
+    if (!isrRunning [pin])
+    {
+      pinPass = pin ;
+      if (pthread_create (&threadId, NULL, interruptHandler, NULL) != 0)
+	pinPass = -1 ;
+      else
+	isrRunning [pin] = TRUE ;
+      while (pinPass != -1)
+	delay (1) ;
+    }
   pthread_mutex_unlock (&pinMutex) ;
 
+  if (!isrRunning [pin])
+    return wiringPiFailure (WPI_FATAL, "wiringPiISR: unable to start interrupt thread: %s\n", strerror (errno)) ;
+
+  return 0 ;
+}
+
+
+/*
+ * nodeISR:
+ *	wiringPiISR and wiringPiISRArg for the pins of a node, if its driver
+ *	can generate interrupts for them.
+ *********************************************************************************
+ */
+
+static int nodeISR (int pin, int mode, void (*function)(void),
+	void (*argFunction)(int pin, int level, unsigned long long timestamp, void *userdata), void *userdata)
+{
+  struct wiringPiNodeStruct *node ;
+  struct wiringPiNodeISRStruct *isr ;
+
+  if (((node = wiringPiFindNode (pin)) == NULL) || (node->isrMode == NULL))
+    return wiringPiFailure (WPI_FATAL, "wiringPiISR: pin %d can't generate interrupts\n", pin) ;
+
+  pthread_mutex_lock (&nodeISRMutex) ;
+
+  if (node->isrs == NULL)
+  {
+    node->isrs = (struct wiringPiNodeISRStruct *)calloc (node->pinMax - node->pinBase + 1, sizeof (struct wiringPiNodeISRStruct)) ;
+    if (node->isrs == NULL)
+    {
+      pthread_mutex_unlock (&nodeISRMutex) ;
+      return wiringPiFailure (WPI_FATAL, "wiringPiISR: Unable to allocate memory: %s\n", strerror (errno)) ;
+    }
+  }
+
+  isr = &node->isrs [pin - node->pinBase] ;
+
+  isr->mode        = (mode == INT_EDGE_SETUP) ? INT_EDGE_BOTH : mode ;
+  isr->function    = function ;
+  isr->argFunction = argFunction ;
+  isr->userdata    = userdata ;
+
+  pthread_mutex_unlock (&nodeISRMutex) ;
+
+  return node->isrMode (node, pin, mode) ;
+}
+
+
+/*
+ * wiringPiNodeEdge:
+ *	Called by a node driver for an edge on one of its pins, normally from
+ *	the interrupt handler thread of the Pi pin its interrupt line is wired
+ *	to. Runs the callback of the pin like a Pi pin's, filtered by the edge
+ *	mode it was set up with.
+ *********************************************************************************
+ */
+
+void wiringPiNodeEdge (int pin, int level, unsigned long long timestamp)
+{
+  struct wiringPiNodeStruct *node ;
+  struct wiringPiNodeISRStruct isr ;
+
+  if ((node = wiringPiFindNode (pin)) == NULL)
+    return ;
+
+// Take a copy, the callback runs without the lock
+
+  pthread_mutex_lock (&nodeISRMutex) ;
+  if (node->isrs == NULL)
+  {
+    pthread_mutex_unlock (&nodeISRMutex) ;
+    return ;
+  }
+  isr = node->isrs [pin - node->pinBase] ;
+  pthread_mutex_unlock (&nodeISRMutex) ;
+
+  if (isr.mode == INT_EDGE_NONE)
+    return ;
+  if ((isr.mode == INT_EDGE_RISING) && (level != HIGH))
+    return ;
+  if ((isr.mode == INT_EDGE_FALLING) && (level != LOW))
+    return ;
+
+  if (isr.function != NULL)
+    isr.function () ;
+  else if (isr.argFunction != NULL)
+    isr.argFunction (pin, level, timestamp, isr.userdata) ;
+}
+
+
+/*
+ * wiringPiISR:
+ * wiringPiISRArg:
+ *	Pi Specific.
+ *	Take the details and create an interrupt handler that will do a call-
+ *	back to the user supplied function. The Arg version tells the function
+ *	which pin fired, the level it went to, when, and passes on userdata.
+ *	A pin has one of each kind of callback, setting one clears the other.
+ *	INT_EDGE_NONE turns the interrupts of the pin off.
+ *	Pins of a node work too if its driver supports interrupts.
+ *********************************************************************************
+ */
+
+int wiringPiISR (int pin, int mode, void (*function)(void))
+{
+  if (pin > 63)
+    return nodeISR (pin, mode, function, NULL, NULL) ;
+
+  if (pin < 0)
+    return wiringPiFailure (WPI_FATAL, "wiringPiISR: pin must be 0-63 (%d)\n", pin) ;
+
+  isrArgFunctions [pin] = NULL ;
+  isrFunctions    [pin] = function ;
+
+  return wiringPiISRMode (pin, mode) ;
+}
+
+int wiringPiISRArg (int pin, int mode, void (*function)(int pin, int level, unsigned long long timestamp, void *userdata), void *userdata)
+{
+  if (pin > 63)
+    return nodeISR (pin, mode, NULL, function, userdata) ;
+
+  if (pin < 0)
+    return wiringPiFailure (WPI_FATAL, "wiringPiISRArg: pin must be 0-63 (%d)\n", pin) ;
+
+  isrFunctions    [pin] = NULL ;
+  isrArgData      [pin] = userdata ;
+  isrArgFunctions [pin] = function ;
+
+  return wiringPiISRMode (pin, mode) ;
+}
+
+
+/*
+ * wiringPiISRFilter:
+ *	Set the glitch filter (minimum pulse width) and debounce (quiet time)
+ *	of a pin, both in uS and 0 to disable. Filtered edges are dropped
+ *	before callbacks and pulse meters see them, and accepted edges are
+ *	delivered late by up to the sum of both times.
+ *********************************************************************************
+ */
+
+int wiringPiISRFilter (int pin, unsigned int glitchUs, unsigned int debounceUs)
+{
+  if ((pin < 0) || (pin > 63))
+    return wiringPiFailure (WPI_FATAL, "wiringPiISRFilter: pin must be 0-63 (%d)\n", pin) ;
+
+  if ((glitchUs > 1000000) || (debounceUs > 1000000))
+    return wiringPiFailure (WPI_FATAL, "wiringPiISRFilter: filter times must be <= 1000000 uS\n") ;
+
+  isrFilters [pin].glitchUs   = glitchUs ;
+  isrFilters [pin].debounceUs = debounceUs ;
+
+  return 0 ;
+}
+
+
+/*
+ * wiringPiISRFilterStats:
+ *	Return how many edges of a pin were accepted and how many the filters
+ *	suppressed.
+ *********************************************************************************
+ */
+
+int wiringPiISRFilterStats (int pin, struct wpiISRFilterStatsStruct *stats, int reset)
+{
+  if ((pin < 0) || (pin > 63))
+    return wiringPiFailure (WPI_FATAL, "wiringPiISRFilterStats: pin must be 0-63 (%d)\n", pin) ;
+
+  *stats = isrFilters [pin].stats ;
+  if (reset)
+    memset (&isrFilters [pin].stats, 0, sizeof (isrFilters [pin].stats)) ;
+
+  return 0 ;
+}
+
+
+/*
+ * wiringPiPulseMeter:
+ *	Pi Specific.
+ *	Start counting edges and measuring periods on the given pin. This runs
+ *	on the same interrupt thread as wiringPiISR, so a callback set for the
+ *	pin keeps being called. Use INT_EDGE_BOTH to get the duty cycle too.
+ *********************************************************************************
+ */
+
+int wiringPiPulseMeter (int pin, int mode)
+{
+  if ((pin < 0) || (pin > 63))
+    return wiringPiFailure (WPI_FATAL, "wiringPiPulseMeter: pin must be 0-63 (%d)\n", pin) ;
+
+  if ((mode != INT_EDGE_FALLING) && (mode != INT_EDGE_RISING) && (mode != INT_EDGE_BOTH))
+    return wiringPiFailure (WPI_FATAL, "wiringPiPulseMeter: invalid edge mode (%d)\n", mode) ;
+
+  pthread_mutex_lock (&pulseMutex) ;
+    memset (&pulseMeters [pin], 0, sizeof (pulseMeters [pin])) ;
+    pulseMeters [pin].mode    = mode ;
+    pulseMeters [pin].enabled = TRUE ;
+  pthread_mutex_unlock (&pulseMutex) ;
+
+  return wiringPiISRMode (pin, mode) ;
+}
+
+
+/*
+ * wiringPiPulseRead:
+ *	Return the pulse meter statistics of a pin collected since the meter
+ *	was started or last reset. The period in progress is kept on reset.
+ *********************************************************************************
+ */
+
+int wiringPiPulseRead (int pin, struct wpiPulseStatsStruct *stats, int reset)
+{
+  if ((pin < 0) || (pin > 63) || !pulseMeters [pin].enabled)
+    return wiringPiFailure (WPI_ALMOST, "wiringPiPulseRead: no pulse meter on pin %d\n", pin) ;
+
+  pthread_mutex_lock (&pulseMutex) ;
+    *stats = pulseMeters [pin].stats ;
+    if (reset)
+      memset (&pulseMeters [pin].stats, 0, sizeof (pulseMeters [pin].stats)) ;
+  pthread_mutex_unlock (&pulseMutex) ;
+
   return 0 ;
 }
 
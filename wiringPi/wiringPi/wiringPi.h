@@ -86,6 +86,7 @@
 #define	INT_EDGE_FALLING	1
 #define	INT_EDGE_RISING		2
 #define	INT_EDGE_BOTH		3
+#define	INT_EDGE_NONE		4
 
 // Pi model types and version numbers
 //	Intended for the GPIO program Use at your own risk.
@@ -125,6 +126,19 @@ extern const int   piMemorySize    [ 8] ;
 
 #define	PI_THREAD(X)	void *X (UNU void *dummy)
 
+// Thread placement and wakeup latency of the library real-time threads
+
+#define	PI_THREAD_MAX	32
+
+struct piThreadStatsStruct
+{
+  char         name [16] ;
+  int          cpu ;		// -1 if not pinned
+  unsigned int wakeups ;
+  unsigned int latencyMax ;	// uS
+  unsigned long long latencyTotal ;	// uS
+} ;
+
 // Failure modes
 
 #define	WPI_FATAL	(1==1)
@@ -149,23 +163,76 @@ struct wiringPiNodeStruct
   unsigned int data1 ;	//  ditto
   unsigned int data2 ;	//  ditto
   unsigned int data3 ;	//  ditto
+  void        *priv ;	//  ditto, for anything bigger
 
            void   (*pinMode)          (struct wiringPiNodeStruct *node, int pin, int mode) ;
            void   (*pullUpDnControl)  (struct wiringPiNodeStruct *node, int pin, int mode) ;
            int    (*digitalRead)      (struct wiringPiNodeStruct *node, int pin) ;
-//unsigned int    (*digitalRead8)     (struct wiringPiNodeStruct *node, int pin) ;
            void   (*digitalWrite)     (struct wiringPiNodeStruct *node, int pin, int value) ;
-//         void   (*digitalWrite8)    (struct wiringPiNodeStruct *node, int pin, int value) ;
+
+// Port-wide access: pin and the ones above it, pin in bit 0. Only called
+//	for pins of the node; reads may return more bits than asked for and
+//	writes stop at the end of the node. Default to one pin at a time.
+
+  unsigned int    (*digitalRead8)     (struct wiringPiNodeStruct *node, int pin) ;
+  unsigned int    (*digitalRead16)    (struct wiringPiNodeStruct *node, int pin) ;
+  unsigned int    (*digitalRead32)    (struct wiringPiNodeStruct *node, int pin) ;
+           void   (*digitalWrite8)    (struct wiringPiNodeStruct *node, int pin, unsigned int value) ;
+           void   (*digitalWrite16)   (struct wiringPiNodeStruct *node, int pin, unsigned int value) ;
+           void   (*digitalWrite32)   (struct wiringPiNodeStruct *node, int pin, unsigned int value) ;
+
            void   (*pwmWrite)         (struct wiringPiNodeStruct *node, int pin, int value) ;
            int    (*analogRead)       (struct wiringPiNodeStruct *node, int pin) ;
            void   (*analogWrite)      (struct wiringPiNodeStruct *node, int pin, int value) ;
 
+// Optional, for wpiPoll: start a conversion and return the uS until it's
+//	done (or -1), then fetch it: 0 with *value set, more uS to wait, or -1.
+
+           int    (*pollStart)        (struct wiringPiNodeStruct *node, int pin) ;
+           int    (*pollFetch)        (struct wiringPiNodeStruct *node, int pin, int *value) ;
+
+// Optional, for wiringPiISR on node pins: enable interrupts for the pin on
+//	the device, or disable them for INT_EDGE_NONE (0 or -1). The driver
+//	then reports the edges it sees with wiringPiNodeEdge. isrs holds the
+//	callbacks, it belongs to the core.
+
+           int    (*isrMode)          (struct wiringPiNodeStruct *node, int pin, int mode) ;
+  struct wiringPiNodeISRStruct *isrs ;
+
   struct wiringPiNodeStruct *next ;
 } ;
 
 extern struct wiringPiNodeStruct *wiringPiNodes ;
 
 
+// wpiPulseStatsStruct:
+//	Aggregates collected by the pulse meter of a pin. All times in uS.
+//	Average period is periodTotal / periods, the duty cycle (INT_EDGE_BOTH
+//	only) is highTotal / periodTotal.
+
+struct wpiPulseStatsStruct
+{
+  unsigned long long edges ;
+  unsigned int       periods ;
+  unsigned int       periodMin ;
+  unsigned int       periodMax ;
+  unsigned long long periodTotal ;
+  unsigned long long highTotal ;
+} ;
+
+// wpiISRFilterStatsStruct:
+//	Edges seen by the glitch/debounce filter of a pin. bounces are the
+//	extra edges swallowed while waiting for the line to settle, glitches
+//	the events dropped because the line didn't really change.
+
+struct wpiISRFilterStatsStruct
+{
+  unsigned int accepted ;
+  unsigned int bounces ;
+  unsigned int glitches ;
+} ;
+
+
 // Function prototypes
 //	c++ wrappers thanks to a comment by Nick Lott
 //	(and others on the Raspberry Pi forums)
@@ -197,7 +264,11 @@ extern          void pullUpDnControl     (int pin, int pud) ;
 extern          int  digitalRead         (int pin) ;
 extern          void digitalWrite        (int pin, int value) ;
 extern unsigned int  digitalRead8        (int pin) ;
+extern unsigned int  digitalRead16       (int pin) ;
+extern unsigned int  digitalRead32       (int pin) ;
 extern          void digitalWrite8       (int pin, int value) ;
+extern          void digitalWrite16      (int pin, int value) ;
+extern          void digitalWrite32      (int pin, unsigned int value) ;
 extern          void pwmWrite            (int pin, int value) ;
 extern          int  analogRead          (int pin) ;
 extern          void analogWrite         (int pin, int value) ;
@@ -222,6 +293,17 @@ extern          void pwmSetMode          (int mode) ;
 extern          void pwmSetRange         (unsigned int range) ;
 extern          void pwmSetClock         (int divisor) ;
 extern          void gpioClockSet        (int pin, int freq) ;
+
+// Hardware PWM, per channel (0 or 1)
+
+extern          void pwmSetRegisters     (volatile unsigned int *pwmRegs, volatile unsigned int *clkRegs) ;
+extern          int  pwmChannelMode      (int channel, int mode, int invert) ;
+extern          int  pwmChannelRange     (int channel, unsigned int range) ;
+extern          int  pwmChannelFrequency (int channel, unsigned int freq, unsigned int range) ;
+extern          int  pwmChannelWrite     (int channel, unsigned int value) ;
+extern          int  pwmWriteChannels    (unsigned int value0, unsigned int value1) ;
+extern          int  pwmChannelFifo      (int channel, int enable) ;
+extern          int  pwmFifoWrite        (const unsigned int *samples, int count) ;
 extern unsigned int  digitalReadByte     (void) ;
 extern unsigned int  digitalReadByte2    (void) ;
 extern          void digitalWriteByte    (int value) ;
@@ -232,6 +314,13 @@ extern          void digitalWriteByte2   (int value) ;
 
 extern int  waitForInterrupt    (int pin, int mS) ;
 extern int  wiringPiISR         (int pin, int mode, void (*function)(void)) ;
+extern int  wiringPiISRArg      (int pin, int mode, void (*function)(int pin, int level, unsigned long long timestamp, void *userdata), void *userdata) ;
+extern int  wiringPiISRMode     (int pin, int mode) ;
+extern void wiringPiNodeEdge    (int pin, int level, unsigned long long timestamp) ;
+extern int  wiringPiISRFilter   (int pin, unsigned int glitchUs, unsigned int debounceUs) ;
+extern int  wiringPiISRFilterStats (int pin, struct wpiISRFilterStatsStruct *stats, int reset) ;
+extern int  wiringPiPulseMeter  (int pin, int mode) ;
+extern int  wiringPiPulseRead   (int pin, struct wpiPulseStatsStruct *stats, int reset) ;
 
 // Threads
 
@@ -243,6 +332,13 @@ extern void piUnlock            (int key) ;
 
 extern int piHiPri (const int pri) ;
 
+// Thread placement
+
+extern int  piThreadPlacement   (const char *cpus, int lockMemory) ;
+extern int  piThreadRealtime    (const char *name, const int pri) ;
+extern void piThreadWakeup      (const int slot, const unsigned int start, const unsigned int wanted) ;
+extern int  piThreadStats       (struct piThreadStatsStruct *stats, const int max) ;
+
 // Extras from arduino land
 
 extern void         delay             (unsigned int howLong) ;
@@ -51,6 +51,8 @@
 #include <errno.h>
 #include <string.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <asm/ioctl.h>
 
@@ -60,8 +62,10 @@
 // I2C definitions
 
 #define I2C_SLAVE	0x0703
+#define I2C_RDWR	0x0707	/* Combined R/W transfer (one STOP only) */
 #define I2C_SMBUS	0x0720	/* SMBus-level access */
 
+
 #define I2C_SMBUS_READ	1
 #define I2C_SMBUS_WRITE	0
 
@@ -99,6 +103,54 @@ struct i2c_smbus_ioctl_data
   union i2c_smbus_data *data ;
 } ;
 
+struct i2c_msg
+{
+  uint16_t addr ;
+  uint16_t flags ;
+  uint16_t len ;
+  uint8_t *buf ;
+} ;
+
+struct i2c_rdwr_ioctl_data
+{
+  struct i2c_msg *msgs ;
+  uint32_t        nmsgs ;
+} ;
+
+// Device address bound to each fd by wiringPiI2CSetupInterface, plus one
+//	(0 = not known). I2C_RDWR needs the address in every message.
+
+#define	I2C_MAX_FDS	1024
+
+static uint8_t i2cAddresses [I2C_MAX_FDS] ;
+
+// Shared buses
+//	wiringPiI2COpen hands out handles (WPI_I2C_HANDLE_BASE + n) instead
+//	of file descriptors. All the handles on a bus share one fd, and every
+//	transaction carries the device address (I2C_RDWR) under the bus lock,
+//	so no I2C_SLAVE binding is ever needed.
+
+#define	I2C_MAX_BUSES	8
+
+struct i2cBusStruct
+{
+  int bus ;
+  int fd ;
+  int refs ;			// Handles on it, plus transfers in flight
+  int lockValid ;
+  pthread_mutex_t lock ;
+} ;
+
+struct i2cHandleStruct
+{
+  struct i2cBusStruct *bus ;	// NULL when unused
+  int addr ;
+} ;
+
+static struct i2cBusStruct    i2cBuses   [I2C_MAX_BUSES] ;
+static struct i2cHandleStruct i2cHandles [WPI_I2C_MAX_HANDLES] ;
+static pthread_mutex_t i2cMutex = PTHREAD_MUTEX_INITIALIZER ;
+
 static inline int i2c_smbus_access (int fd, char rw, uint8_t command, int size, union i2c_smbus_data *data)
 {
   struct i2c_smbus_ioctl_data args ;
@@ -111,6 +163,120 @@ static inline int i2c_smbus_access (int fd, char rw, uint8_t command, int size,
 }
 
 
+/*
+ * i2cHandle:
+ *	Return the handle structure for a shared bus handle, NULL for
+ *	anything else.
+ *********************************************************************************
+ */
+
+static struct i2cHandleStruct *i2cHandle (int fd)
+{
+  if ((fd < WPI_I2C_HANDLE_BASE) || (fd >= WPI_I2C_HANDLE_BASE + WPI_I2C_MAX_HANDLES))
+    return NULL ;
+
+  return &i2cHandles [fd - WPI_I2C_HANDLE_BASE] ;
+}
+
+
+/*
+ * i2cBusRelease:
+ *	Drop a reference to a bus, closing it with the last one.
+ *	Called with i2cMutex held.
+ *********************************************************************************
+ */
+
+static void i2cBusRelease (struct i2cBusStruct *bus)
+{
+  if (--bus->refs == 0)
+  {
+    close (bus->fd) ;
+    bus->fd = -1 ;
+  }
+}
+
+
+/*
+ * i2cRdwr:
+ *	Submit the messages with I2C_RDWR, on the shared bus fd under the
+ *	bus lock for a handle, straight on the fd otherwise.
+ *	The transfer holds a reference to the bus, so closing the handle
+ *	meanwhile leaves the fd open until it is done.
+ *********************************************************************************
+ */
+
+static int i2cRdwr (int fd, struct i2c_msg *msgs, int count)
+{
+  struct i2cHandleStruct *handle ;
+  struct i2cBusStruct *bus ;
+  struct i2c_rdwr_ioctl_data rdwr ;
+  int result ;
+
+  rdwr.msgs  = msgs ;
+  rdwr.nmsgs = count ;
+
+  if ((handle = i2cHandle (fd)) == NULL)
+    return ioctl (fd, I2C_RDWR, &rdwr) ;
+
+  pthread_mutex_lock (&i2cMutex) ;
+    if ((bus = handle->bus) != NULL)
+      ++bus->refs ;
+  pthread_mutex_unlock (&i2cMutex) ;
+
+  if (bus == NULL)
+  {
+    errno = EBADF ;
+    return -1 ;
+  }
+
+  pthread_mutex_lock (&bus->lock) ;
+    result = ioctl (bus->fd, I2C_RDWR, &rdwr) ;
+  pthread_mutex_unlock (&bus->lock) ;
+
+  pthread_mutex_lock (&i2cMutex) ;
+    i2cBusRelease (bus) ;
+  pthread_mutex_unlock (&i2cMutex) ;
+
+  return result ;
+}
+
+
+/*
+ * i2cHandleAccess:
+ *	The SMBus calls for a handle: an optional write of wlen bytes
+ *	followed by an optional read of rlen bytes after a repeated START,
+ *	which is what the SMBus protocol puts on the wire anyway.
+ *	Returns 0, or -1 on error, as the I2C_SMBUS ioctl does.
+ *********************************************************************************
+ */
+
+static int i2cHandleAccess (struct i2cHandleStruct *handle, int fd, uint8_t *wbuf, int wlen, uint8_t *rbuf, int rlen)
+{
+  struct i2c_msg msgs [2] ;
+  int count = 0 ;
+
+  if (wlen > 0)
+  {
+    msgs [count].addr  = handle->addr ;
+    msgs [count].flags = 0 ;
+    msgs [count].len   = wlen ;
+    msgs [count].buf   = wbuf ;
+    ++count ;
+  }
+
+  if (rlen > 0)
+  {
+    msgs [count].addr  = handle->addr ;
+    msgs [count].flags = WPI_I2C_READ ;
+    msgs [count].len   = rlen ;
+    msgs [count].buf   = rbuf ;
+    ++count ;
+  }
+
+  return (i2cRdwr (fd, msgs, count) < 0) ? -1 : 0 ;
+}
+
+
 /*
  * wiringPiI2CRead:
  *	Simple device read
@@ -119,8 +285,16 @@ static inline int i2c_smbus_access (int fd, char rw, uint8_t command, int size,
 
 int wiringPiI2CRead (int fd)
 {
+  struct i2cHandleStruct *handle ;
   union i2c_smbus_data data ;
 
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    if (i2cHandleAccess (handle, fd, NULL, 0, &data.byte, 1))
+      return -1 ;
+    return data.byte & 0xFF ;
+  }
+
   if (i2c_smbus_access (fd, I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, &data))
     return -1 ;
   else
@@ -136,7 +310,16 @@ int wiringPiI2CRead (int fd)
 
 int wiringPiI2CReadReg8 (int fd, int reg)
 {
+  struct i2cHandleStruct *handle ;
   union i2c_smbus_data data;
+  uint8_t regByte = reg ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    if (i2cHandleAccess (handle, fd, &regByte, 1, &data.byte, 1))
+      return -1 ;
+    return data.byte & 0xFF ;
+  }
 
   if (i2c_smbus_access (fd, I2C_SMBUS_READ, reg, I2C_SMBUS_BYTE_DATA, &data))
     return -1 ;
@@ -146,7 +329,16 @@ int wiringPiI2CReadReg8 (int fd, int reg)
 
 int wiringPiI2CReadReg16 (int fd, int reg)
 {
+  struct i2cHandleStruct *handle ;
   union i2c_smbus_data data;
+  uint8_t regByte = reg ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    if (i2cHandleAccess (handle, fd, &regByte, 1, data.block, 2))
+      return -1 ;
+    return data.block [0] | (data.block [1] << 8) ;	// SMBus words are LSB first
+  }
 
   if (i2c_smbus_access (fd, I2C_SMBUS_READ, reg, I2C_SMBUS_WORD_DATA, &data))
     return -1 ;
@@ -163,6 +355,12 @@ int wiringPiI2CReadReg16 (int fd, int reg)
 
 int wiringPiI2CWrite (int fd, int data)
 {
+  struct i2cHandleStruct *handle ;
+  uint8_t byte = data ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+    return i2cHandleAccess (handle, fd, &byte, 1, NULL, 0) ;
+
   return i2c_smbus_access (fd, I2C_SMBUS_WRITE, data, I2C_SMBUS_BYTE, NULL) ;
 }
 
@@ -175,7 +373,16 @@ int wiringPiI2CWrite (int fd, int data)
 
 int wiringPiI2CWriteReg8 (int fd, int reg, int value)
 {
+  struct i2cHandleStruct *handle ;
   union i2c_smbus_data data ;
+  uint8_t buffer [2] ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    buffer [0] = reg ;
+    buffer [1] = value ;
+    return i2cHandleAccess (handle, fd, buffer, 2, NULL, 0) ;
+  }
 
   data.byte = value ;
   return i2c_smbus_access (fd, I2C_SMBUS_WRITE, reg, I2C_SMBUS_BYTE_DATA, &data) ;
@@ -183,17 +390,288 @@ int wiringPiI2CWriteReg8 (int fd, int reg, int value)
 
 int wiringPiI2CWriteReg16 (int fd, int reg, int value)
 {
+  struct i2cHandleStruct *handle ;
   union i2c_smbus_data data ;
+  uint8_t buffer [3] ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    buffer [0] = reg ;
+    buffer [1] = value & 0xFF ;
+    buffer [2] = (value >> 8) & 0xFF ;
+    return i2cHandleAccess (handle, fd, buffer, 3, NULL, 0) ;
+  }
 
   data.word = value ;
   return i2c_smbus_access (fd, I2C_SMBUS_WRITE, reg, I2C_SMBUS_WORD_DATA, &data) ;
 }
 
 
+/*
+ * wiringPiI2CTransfer:
+ *	Run a list of messages as one combined transaction: a single START,
+ *	a repeated START between the messages and one STOP at the end.
+ *	A message with addr < 0 goes to the device of the fd. Returns the
+ *	number of messages transferred, or -1 on error.
+ *********************************************************************************
+ */
+
+int wiringPiI2CTransfer (int fd, const struct wiringPiI2CMessage *messages, int count)
+{
+  struct i2c_msg msgs [WPI_I2C_MAX_MESSAGES] ;
+  struct i2cHandleStruct *handle ;
+  int i, addr, defaultAddr = -1 ;
+
+  if ((count < 1) || (count > WPI_I2C_MAX_MESSAGES))
+  {
+    errno = EINVAL ;
+    return -1 ;
+  }
+
+  if ((handle = i2cHandle (fd)) != NULL)
+    defaultAddr = handle->addr ;
+  else if ((fd >= 0) && (fd < I2C_MAX_FDS))
+    defaultAddr = i2cAddresses [fd] - 1 ;
+
+  for (i = 0 ; i < count ; ++i)
+  {
+    if ((addr = messages [i].addr) < 0)
+    {
+      if (defaultAddr < 0)
+      {
+	errno = EDESTADDRREQ ;
+	return -1 ;
+      }
+      addr = defaultAddr ;
+    }
+
+    if ((messages [i].len < 0) || (messages [i].len > 0xFFFF))
+    {
+      errno = EINVAL ;
+      return -1 ;
+    }
+
+    msgs [i].addr  = addr ;
+    msgs [i].flags = messages [i].flags & (WPI_I2C_READ | WPI_I2C_NOSTART) ;
+    msgs [i].len   = messages [i].len ;
+    msgs [i].buf   = messages [i].buf ;
+  }
+
+  return i2cRdwr (fd, msgs, count) ;
+}
+
+
+/*
+ * wiringPiI2CReadBlock:
+ *	Read len bytes starting at register reg: the register number is
+ *	written and the data read back after a repeated START, in one
+ *	transaction. Relies on the device auto-incrementing the register.
+ *	Returns len, or -1 on error.
+ *********************************************************************************
+ */
+
+int wiringPiI2CReadBlock (int fd, int reg, unsigned char *data, int len)
+{
+  struct wiringPiI2CMessage msgs [2] ;
+  uint8_t regByte = reg ;
+
+  msgs [0].addr  = -1 ;
+  msgs [0].flags = 0 ;
+  msgs [0].buf   = &regByte ;
+  msgs [0].len   = 1 ;
+
+  msgs [1].addr  = -1 ;
+  msgs [1].flags = WPI_I2C_READ ;
+  msgs [1].buf   = data ;
+  msgs [1].len   = len ;
+
+  if (wiringPiI2CTransfer (fd, msgs, 2) < 0)
+    return -1 ;
+
+  return len ;
+}
+
+
+/*
+ * wiringPiI2CWriteBlock:
+ *	Write len bytes starting at register reg in one message.
+ *	Returns len, or -1 on error.
+ *********************************************************************************
+ */
+
+int wiringPiI2CWriteBlock (int fd, int reg, const unsigned char *data, int len)
+{
+  struct wiringPiI2CMessage msg ;
+  uint8_t buffer [WPI_I2C_BLOCK_MAX + 1] ;
+
+  if ((len < 0) || (len > WPI_I2C_BLOCK_MAX))
+  {
+    errno = EINVAL ;
+    return -1 ;
+  }
+
+  buffer [0] = reg ;
+  memcpy (buffer + 1, data, len) ;
+
+  msg.addr  = -1 ;
+  msg.flags = 0 ;
+  msg.buf   = buffer ;
+  msg.len   = len + 1 ;
+
+  if (wiringPiI2CTransfer (fd, &msg, 1) < 0)
+    return -1 ;
+
+  return len ;
+}
+
+
+/*
+ * wiringPiI2COpen:
+ *	Get a handle for the device at devId on /dev/i2c-<bus>, bus -1
+ *	picks the default bus of the Pi like wiringPiI2CSetup does.
+ *	The bus is opened on the first handle and shared by the rest.
+ *	The handle can be used with all the wiringPiI2C functions.
+ *********************************************************************************
+ */
+
+int wiringPiI2COpen (int bus, int devId)
+{
+  struct i2cBusStruct *b = NULL ;
+  char device [32] ;
+  int i, h ;
+
+  if ((devId < 0) || (devId > 0x7F))
+    return wiringPiFailure (WPI_ALMOST, "wiringPiI2COpen: Invalid device address: 0x%02X\n", devId) ;
+
+  if (bus < 0)
+    bus = (piGpioLayout () == 1) ? 0 : 1 ;
+
+  pthread_mutex_lock (&i2cMutex) ;
+
+    for (h = 0 ; h < WPI_I2C_MAX_HANDLES ; ++h)
+      if (i2cHandles [h].bus == NULL)
+	break ;
+
+    if (h == WPI_I2C_MAX_HANDLES)
+    {
+      pthread_mutex_unlock (&i2cMutex) ;
+      return wiringPiFailure (WPI_ALMOST, "wiringPiI2COpen: No free handles\n") ;
+    }
+
+    for (i = 0 ; i < I2C_MAX_BUSES ; ++i)
+      if ((i2cBuses [i].refs > 0) && (i2cBuses [i].bus == bus))
+      {
+	b = &i2cBuses [i] ;
+	break ;
+      }
+
+    if (b == NULL)
+    {
+      for (i = 0 ; i < I2C_MAX_BUSES ; ++i)
+	if (i2cBuses [i].refs == 0)
+	  break ;
+
+      if (i == I2C_MAX_BUSES)
+      {
+	pthread_mutex_unlock (&i2cMutex) ;
+	return wiringPiFailure (WPI_ALMOST, "wiringPiI2COpen: Too many I2C buses open\n") ;
+      }
+
+      sprintf (device, "/dev/i2c-%d", bus) ;
+      b = &i2cBuses [i] ;
+      if ((b->fd = open (device, O_RDWR | O_CLOEXEC)) < 0)
+      {
+	pthread_mutex_unlock (&i2cMutex) ;
+	return wiringPiFailure (WPI_ALMOST, "wiringPiI2COpen: Unable to open %s: %s\n", device, strerror (errno)) ;
+      }
+
+      if (!b->lockValid)
+      {
+	pthread_mutex_init (&b->lock, NULL) ;
+	b->lockValid = TRUE ;
+      }
+      b->bus = bus ;
+    }
+
+    ++b->refs ;
+    i2cHandles [h].addr = devId ;
+    i2cHandles [h].bus  = b ;
+
+  pthread_mutex_unlock (&i2cMutex) ;
+
+  return WPI_I2C_HANDLE_BASE + h ;
+}
+
+
+/*
+ * wiringPiI2CClose:
+ *	Release a handle, closing the bus with its last handle, or close
+ *	a file descriptor from wiringPiI2CSetup.
+ *********************************************************************************
+ */
+
+int wiringPiI2CClose (int fd)
+{
+  struct i2cHandleStruct *handle ;
+  struct i2cBusStruct *bus ;
+
+  if ((handle = i2cHandle (fd)) == NULL)
+  {
+    if ((fd >= 0) && (fd < I2C_MAX_FDS))
+      i2cAddresses [fd] = 0 ;
+    return close (fd) ;
+  }
+
+  pthread_mutex_lock (&i2cMutex) ;
+
+    if ((bus = handle->bus) == NULL)
+    {
+      pthread_mutex_unlock (&i2cMutex) ;
+      errno = EBADF ;
+      return -1 ;
+    }
+
+    handle->bus = NULL ;
+    i2cBusRelease (bus) ;		// Closed now, or by the last transfer in flight
+
+  pthread_mutex_unlock (&i2cMutex) ;
+
+  return 0 ;
+}
+
+
+/*
+ * wiringPiI2CBus:
+ *	Return the bus number of a handle from wiringPiI2COpen
+ *********************************************************************************
+ */
+
+int wiringPiI2CBus (int fd)
+{
+  struct i2cHandleStruct *handle ;
+  int result = -1 ;
+
+  if ((handle = i2cHandle (fd)) != NULL)
+  {
+    pthread_mutex_lock (&i2cMutex) ;
+      if (handle->bus != NULL)
+	result = handle->bus->bus ;
+    pthread_mutex_unlock (&i2cMutex) ;
+  }
+
+  if (result < 0)
+    errno = EBADF ;
+
+  return result ;
+}
+
+
 /*
  * wiringPiI2CSetupInterface:
  *	Undocumented access to set the interface explicitly - might be used
  *	for the Pi's 2nd I2C interface...
+ *	An fd as high as WPI_I2C_HANDLE_BASE would be taken for a handle
+ *	from wiringPiI2COpen, so is refused.
  *********************************************************************************
  */
 
@@ -204,8 +682,21 @@ int wiringPiI2CSetupInterface (const char *device, int devId)
   if ((fd = open (device, O_RDWR)) < 0)
     return wiringPiFailure (WPI_ALMOST, "Unable to open I2C device: %s\n", strerror (errno)) ;
 
+  if (fd >= WPI_I2C_HANDLE_BASE)
+  {
+    close (fd) ;
+    errno = EMFILE ;
+    return wiringPiFailure (WPI_ALMOST, "Unable to open I2C device: Too many open files\n") ;
+  }
+
   if (ioctl (fd, I2C_SLAVE, devId) < 0)
+  {
+    close (fd) ;
     return wiringPiFailure (WPI_ALMOST, "Unable to select I2C device: %s\n", strerror (errno)) ;
+  }
+
+  if (fd < I2C_MAX_FDS)
+    i2cAddresses [fd] = (devId & 0x7F) + 1 ;
 
   return fd ;
 }
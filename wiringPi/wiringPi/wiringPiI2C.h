@@ -26,6 +26,27 @@
 extern "C" {
 #endif
 
+// Combined transactions (I2C_RDWR)
+//	addr < 0 addresses the device the fd was set up for.
+
+#define	WPI_I2C_READ		0x0001
+#define	WPI_I2C_NOSTART		0x4000	// Continue the previous message, no repeated START
+#define	WPI_I2C_MAX_MESSAGES	42
+#define	WPI_I2C_BLOCK_MAX	256
+
+// Shared bus handles from wiringPiI2COpen
+
+#define	WPI_I2C_HANDLE_BASE	0x10000
+#define	WPI_I2C_MAX_HANDLES	128
+
+struct wiringPiI2CMessage
+{
+  int            addr ;
+  int            flags ;
+  unsigned char *buf ;
+  int            len ;
+} ;
+
 extern int wiringPiI2CRead           (int fd) ;
 extern int wiringPiI2CReadReg8       (int fd, int reg) ;
 extern int wiringPiI2CReadReg16      (int fd, int reg) ;
@@ -34,9 +55,17 @@ extern int wiringPiI2CWrite          (int fd, int data) ;
 extern int wiringPiI2CWriteReg8      (int fd, int reg, int data) ;
 extern int wiringPiI2CWriteReg16     (int fd, int reg, int data) ;
 
+extern int wiringPiI2CReadBlock      (int fd, int reg, unsigned char *data, int len) ;
+extern int wiringPiI2CWriteBlock     (int fd, int reg, const unsigned char *data, int len) ;
+extern int wiringPiI2CTransfer       (int fd, const struct wiringPiI2CMessage *messages, int count) ;
+
 extern int wiringPiI2CSetupInterface (const char *device, int devId) ;
 extern int wiringPiI2CSetup          (const int devId) ;
 
+extern int wiringPiI2COpen           (int bus, int devId) ;
+extern int wiringPiI2CClose          (int fd) ;
+extern int wiringPiI2CBus            (int fd) ;
+
 #ifdef __cplusplus
 }
 #endif
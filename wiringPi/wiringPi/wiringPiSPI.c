@@ -23,7 +23,10 @@
  */
 
 
+#include <stdio.h>
 #include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <string.h>
@@ -45,7 +48,247 @@ static const uint8_t     spiBPW   = 8 ;
 static const uint16_t    spiDelay = 0 ;
 
 static uint32_t    spiSpeeds [2] ;
-static int         spiFds [2] ;
+static int         spiFds [2] = { -1, -1 } ;
+
+static uint8_t     spiModes [2] ;
+
+// Per-bus locks
+//	The kernel serialises single messages, but a transfer split into
+//	several ioctls, or a mode switch followed by a transfer, must not be
+//	interleaved with another device on the same bus.
+
+static pthread_mutex_t spiBusLocks [WPI_SPI_MAX_BUSES] ;
+static pthread_once_t  spiBusOnce = PTHREAD_ONCE_INIT ;
+
+// Devices: one entry per /dev/spidevB.C in use
+//	Handles to the same device share its file-descriptor. The mode
+//	(held by the kernel per device, not per file) is cached, so it is only
+//	written again when the next user wants a different one.
+
+struct spiDevStruct
+{
+  int bus ;
+  int cs ;
+  int fd ;		// Shared by the handles, -1 if none open
+  int refs ;
+  int mode ;		// As last written, -1 if not known
+} ;
+
+static struct spiDevStruct spiDevs [WPI_SPI_MAX_HANDLES + 2] ;
+static int                 spiDevCount = 0 ;
+static struct spiDevStruct *spiChannelDevs [2] ;	// Devices of channel 0 and 1
+
+// Handles
+//	Each handle keeps its own settings, so several drivers can share one
+//	device or bus from different threads.
+
+struct spiHandleStruct
+{
+  struct spiDevStruct *dev ;	// NULL when the slot is free
+  uint32_t        speed ;
+  uint8_t         mode ;
+  uint8_t         bpw ;
+  uint16_t        delay ;
+  pthread_mutex_t lock ;
+} ;
+
+static struct spiHandleStruct spiHandles [WPI_SPI_MAX_HANDLES] ;
+static pthread_mutex_t        spiHandlesMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+
+/*
+ * spiInit:
+ *	One-time set-up of the locks and tables.
+ *********************************************************************************
+ */
+
+static void spiInit (void)
+{
+  int i ;
+
+  for (i = 0 ; i < WPI_SPI_MAX_BUSES ; ++i)
+    pthread_mutex_init (&spiBusLocks [i], NULL) ;
+
+  for (i = 0 ; i < WPI_SPI_MAX_HANDLES ; ++i)
+  {
+    spiHandles [i].dev = NULL ;
+    pthread_mutex_init (&spiHandles [i].lock, NULL) ;
+  }
+}
+
+
+/*
+ * spiDevice:
+ *	Find or create the entry for /dev/spidev<bus>.<cs>.
+ *	Must be called with spiHandlesMutex held.
+ *********************************************************************************
+ */
+
+static struct spiDevStruct *spiDevice (int bus, int cs)
+{
+  struct spiDevStruct *dev ;
+  int i ;
+
+  for (i = 0 ; i < spiDevCount ; ++i)
+    if ((spiDevs [i].bus == bus) && (spiDevs [i].cs == cs))
+      return &spiDevs [i] ;
+
+  for (i = 0 ; i < spiDevCount ; ++i)	// Re-use an entry nobody holds
+    if ((spiDevs [i].refs == 0) && (&spiDevs [i] != spiChannelDevs [0]) && (&spiDevs [i] != spiChannelDevs [1]))
+      break ;
+
+  if (i == spiDevCount)
+  {
+    if (spiDevCount == WPI_SPI_MAX_HANDLES + 2)
+      return NULL ;
+    ++spiDevCount ;
+  }
+
+  dev = &spiDevs [i] ;
+  dev->bus  = bus ;
+  dev->cs   = cs ;
+  dev->fd   = -1 ;
+  dev->refs = 0 ;
+  dev->mode = -1 ;
+
+  return dev ;
+}
+
+
+/*
+ * spiSetMode:
+ *	Write the mode to a device if it is not already set.
+ *	Called with the bus lock held.
+ *********************************************************************************
+ */
+
+static int spiSetMode (struct spiDevStruct *dev, int fd, uint8_t mode)
+{
+  if (dev->mode == mode)
+    return 0 ;
+
+  if (ioctl (fd, SPI_IOC_WR_MODE, &mode) < 0)
+  {
+    dev->mode = -1 ;
+    return wiringPiFailure (WPI_ALMOST, "SPI Mode Change failure: %s\n", strerror (errno)) ;
+  }
+
+  dev->mode = mode ;
+  return 0 ;
+}
+
+
+/*
+ * spiBufsiz:
+ *	Return the largest message the spidev driver accepts, as set with
+ *	its bufsiz module parameter (4096 unless changed).
+ *********************************************************************************
+ */
+
+static unsigned int spiBufsiz (void)
+{
+  static unsigned int bufsiz = 0 ;
+  unsigned int size ;
+  FILE *fp ;
+
+  if ((size = __atomic_load_n (&bufsiz, __ATOMIC_RELAXED)) != 0)
+    return size ;
+
+  size = 4096 ;
+  if ((fp = fopen ("/sys/module/spidev/parameters/bufsiz", "r")) != NULL)
+  {
+    if ((fscanf (fp, "%u", &size) != 1) || (size < 4))
+      size = 4096 ;
+    fclose (fp) ;
+  }
+
+  __atomic_store_n (&bufsiz, size, __ATOMIC_RELAXED) ;
+  return size ;
+}
+
+
+/*
+ * spiMessage:
+ *	Submit a list of segments to an open spidev. Segment settings left
+ *	at 0 fall back to the given defaults.
+ *	spidev refuses messages larger than its bufsiz, so segments are
+ *	split into whole words and packed into as few ioctls as the limit
+ *	allows. Chip-select is held across the ioctl boundaries, so the
+ *	device sees the same transaction as without splitting.
+ *********************************************************************************
+ */
+
+static int spiMessage (int fd, uint32_t speed, uint8_t bpw, uint16_t delay,
+	const struct wiringPiSPISegment *segments, int count)
+{
+  struct spi_ioc_transfer spi [WPI_SPI_MAX_SEGMENTS] ;
+  unsigned int bufsiz, room, done, piece, word ;
+  uint8_t bits ;
+  int i, n, result, total ;
+
+  if ((count < 1) || (count > WPI_SPI_MAX_SEGMENTS))
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "SPI: Invalid segment count: %d\n", count) ;
+  }
+
+  bufsiz = spiBufsiz () ;
+  room   = bufsiz ;
+  total  = 0 ;
+  n      = 0 ;
+
+  for (i = 0 ; i < count ; ++i)
+  {
+    bits = segments [i].bits != 0 ? segments [i].bits : bpw ;
+    word = bits <= 8 ? 1 : (bits <= 16 ? 2 : 4) ;
+
+    for (done = 0 ;;)
+    {
+      piece = segments [i].len - done ;
+      if (piece > room)
+        piece = room - (room % word) ;
+
+// Message full: send it. Flipping cs_change of its last transfer keeps
+//	chip-select asserted past the end of the ioctl, unless the caller
+//	asked for a deselect at exactly this point.
+
+      if ((n == WPI_SPI_MAX_SEGMENTS) || ((piece == 0) && (done < segments [i].len)))
+      {
+	spi [n - 1].cs_change = !spi [n - 1].cs_change ;
+	if ((result = ioctl (fd, SPI_IOC_MESSAGE(n), spi)) < 0)
+	  return result ;
+	total += result ;
+	room   = bufsiz ;
+	n      = 0 ;
+	continue ;
+      }
+
+      memset (&spi [n], 0, sizeof (struct spi_ioc_transfer)) ;
+      spi [n].tx_buf        = segments [i].tx == NULL ? 0 : (unsigned long)(segments [i].tx + done) ;
+      spi [n].rx_buf        = segments [i].rx == NULL ? 0 : (unsigned long)(segments [i].rx + done) ;
+      spi [n].len           = piece ;
+      spi [n].speed_hz      = segments [i].speed != 0 ? segments [i].speed : speed ;
+      spi [n].bits_per_word = bits ;
+
+      done += piece ;
+      room -= piece ;
+
+      if (done == segments [i].len)
+      {
+	spi [n].delay_usecs = segments [i].delayUs != 0 ? segments [i].delayUs : delay ;
+	spi [n].cs_change   = segments [i].csChange ;
+	++n ;
+	break ;
+      }
+      ++n ;
+    }
+  }
+
+  if ((result = ioctl (fd, SPI_IOC_MESSAGE(n), spi)) < 0)
+    return result ;
+
+  return total + result ;
+}
 
 
 /*
@@ -71,55 +314,140 @@ int wiringPiSPIGetFd (int channel)
 
 int wiringPiSPIDataRW (int channel, unsigned char *data, int len)
 {
-  struct spi_ioc_transfer spi ;
+  struct wiringPiSPISegment segment ;
+
+  memset (&segment, 0, sizeof (segment)) ;
+  segment.tx  = data ;
+  segment.rx  = data ;
+  segment.len = len ;
+
+  return wiringPiSPITransfer (channel, &segment, 1) ;
+}
+
+
+/*
+ * wiringPiSPITransfer:
+ *	Run a list of segments as one SPI transaction, handed to the kernel
+ *	with a single ioctl. Chip-select stays asserted between the segments
+ *	unless a segment sets csChange. Returns the number of bytes
+ *	transferred, or -1 on error.
+ *********************************************************************************
+ */
+
+int wiringPiSPITransfer (int channel, const struct wiringPiSPISegment *segments, int count)
+{
+  struct spiDevStruct *dev ;
+  int result ;
 
   channel &= 1 ;
 
-// Mentioned in spidev.h but not used in the original kernel documentation
-//	test program )-:
+  if ((dev = spiChannelDevs [channel]) == NULL)
+  {
+    errno = EBADF ;
+    return -1 ;
+  }
 
-  memset (&spi, 0, sizeof (spi)) ;
+  pthread_mutex_lock (&spiBusLocks [0]) ;
+  if ((result = spiSetMode (dev, spiFds [channel], spiModes [channel])) == 0)
+    result = spiMessage (spiFds [channel], spiSpeeds [channel], spiBPW, spiDelay, segments, count) ;
+  pthread_mutex_unlock (&spiBusLocks [0]) ;
 
-  spi.tx_buf        = (unsigned long)data ;
-  spi.rx_buf        = (unsigned long)data ;
-  spi.len           = len ;
-  spi.delay_usecs   = spiDelay ;
-  spi.speed_hz      = spiSpeeds [channel] ;
-  spi.bits_per_word = spiBPW ;
+  return result ;
+}
+
+
+/*
+ * wiringPiSPIBufferSize:
+ *	Return the spidev message size limit. Larger transfers are split
+ *	into several ioctls.
+ *********************************************************************************
+ */
 
-  return ioctl (spiFds [channel], SPI_IOC_MESSAGE(1), &spi) ;
+int wiringPiSPIBufferSize (void)
+{
+  return spiBufsiz () ;
 }
 
 
 /*
  * wiringPiSPISetupMode:
  *	Open the SPI device, and set it up, with the mode, etc.
+ *	Setting up a channel that is already open the same way hands back
+ *	the file-descriptor it has. A different mode or speed re-opens it,
+ *	closing the old one once the new one is ready.
  *********************************************************************************
  */
 
 int wiringPiSPISetupMode (int channel, int speed, int mode)
 {
-  int fd ;
+  struct spiDevStruct *dev ;
+  int fd, oldFd, result ;
 
   mode    &= 3 ;	// Mode is 0, 1, 2 or 3
   channel &= 1 ;	// Channel is 0 or 1
 
+  pthread_once (&spiBusOnce, spiInit) ;
+
+  pthread_mutex_lock (&spiBusLocks [0]) ;
+  if ((spiFds [channel] >= 0) && (spiModes [channel] == mode) && (spiSpeeds [channel] == (uint32_t)speed))
+  {
+    fd = spiFds [channel] ;
+    pthread_mutex_unlock (&spiBusLocks [0]) ;
+    return fd ;
+  }
+  pthread_mutex_unlock (&spiBusLocks [0]) ;
+
   if ((fd = open (channel == 0 ? spiDev0 : spiDev1, O_RDWR)) < 0)
     return wiringPiFailure (WPI_ALMOST, "Unable to open SPI device: %s\n", strerror (errno)) ;
 
-  spiSpeeds [channel] = speed ;
-  spiFds    [channel] = fd ;
-
 // Set SPI parameters.
 
-  if (ioctl (fd, SPI_IOC_WR_MODE, &mode)            < 0)
-    return wiringPiFailure (WPI_ALMOST, "SPI Mode Change failure: %s\n", strerror (errno)) ;
-  
+  pthread_mutex_lock (&spiHandlesMutex) ;
+  if ((dev = spiDevice (0, channel)) != NULL)
+    spiChannelDevs [channel] = dev ;
+  pthread_mutex_unlock (&spiHandlesMutex) ;
+
+  if (dev == NULL)
+  {
+    close (fd) ;
+    return wiringPiFailure (WPI_ALMOST, "SPI: Too many devices in use\n") ;
+  }
+
+  pthread_mutex_lock (&spiBusLocks [0]) ;
+  dev->mode = -1 ;
+  result = spiSetMode (dev, fd, mode) ;
+  pthread_mutex_unlock (&spiBusLocks [0]) ;
+
+  if (result < 0)
+  {
+    close (fd) ;
+    return result ;
+  }
+
   if (ioctl (fd, SPI_IOC_WR_BITS_PER_WORD, &spiBPW) < 0)
+  {
+    close (fd) ;
     return wiringPiFailure (WPI_ALMOST, "SPI BPW Change failure: %s\n", strerror (errno)) ;
+  }
 
   if (ioctl (fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed)   < 0)
+  {
+    close (fd) ;
     return wiringPiFailure (WPI_ALMOST, "SPI Speed Change failure: %s\n", strerror (errno)) ;
+  }
+
+// Swap it in under the bus lock so no transfer is part way through
+//	on the old one
+
+  pthread_mutex_lock (&spiBusLocks [0]) ;
+  oldFd = spiFds [channel] ;
+  spiSpeeds [channel] = speed ;
+  spiModes  [channel] = mode ;
+  spiFds    [channel] = fd ;
+  pthread_mutex_unlock (&spiBusLocks [0]) ;
+
+  if (oldFd >= 0)
+    close (oldFd) ;
 
   return fd ;
 }
@@ -135,3 +463,266 @@ int wiringPiSPISetup (int channel, int speed)
 {
   return wiringPiSPISetupMode (channel, speed, 0) ;
 }
+
+
+/*
+ * spiHandle:
+ *	Return the locked handle slot, or NULL if it is not open.
+ *********************************************************************************
+ */
+
+static struct spiHandleStruct *spiHandle (int handle)
+{
+  struct spiHandleStruct *h ;
+
+  if ((handle < 0) || (handle >= WPI_SPI_MAX_HANDLES))
+    return NULL ;
+
+  pthread_once (&spiBusOnce, spiInit) ;
+
+  h = &spiHandles [handle] ;
+  pthread_mutex_lock (&h->lock) ;
+  if (h->dev == NULL)
+  {
+    pthread_mutex_unlock (&h->lock) ;
+    return NULL ;
+  }
+
+  return h ;
+}
+
+
+/*
+ * spiRelease:
+ *	Drop a reference to a device, closing it with the last one.
+ *********************************************************************************
+ */
+
+static void spiRelease (struct spiDevStruct *dev)
+{
+  pthread_mutex_lock (&spiHandlesMutex) ;
+  if (--dev->refs == 0)
+  {
+    close (dev->fd) ;
+    dev->fd = -1 ;
+  }
+  pthread_mutex_unlock (&spiHandlesMutex) ;
+}
+
+
+/*
+ * wiringPiSPIOpen:
+ *	Open /dev/spidev<bus>.<cs> with the given speed and mode, 8 bits
+ *	per word and no delay. Returns a handle for the other
+ *	wiringPiSPIHandle functions, or -1 on error.
+ *	Handles to the same device share one file-descriptor.
+ *********************************************************************************
+ */
+
+int wiringPiSPIOpen (int bus, int cs, int speed, int mode)
+{
+  struct spiHandleStruct *h ;
+  struct spiDevStruct *dev ;
+  char device [32] ;
+  int  handle, result ;
+  uint8_t  bpw = spiBPW ;
+  uint32_t hz  = speed ;
+
+  if ((bus < 0) || (bus >= WPI_SPI_MAX_BUSES) || (cs < 0) || (speed <= 0))
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIOpen: Invalid bus %d, chip-select %d or speed %d\n", bus, cs, speed) ;
+  }
+
+  pthread_once (&spiBusOnce, spiInit) ;
+  pthread_mutex_lock (&spiHandlesMutex) ;
+
+  for (handle = 0 ; handle < WPI_SPI_MAX_HANDLES ; ++handle)
+    if (spiHandles [handle].dev == NULL)
+      break ;
+
+  if ((handle == WPI_SPI_MAX_HANDLES) || ((dev = spiDevice (bus, cs)) == NULL))
+  {
+    pthread_mutex_unlock (&spiHandlesMutex) ;
+    errno = EMFILE ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIOpen: All %d SPI handles in use\n", WPI_SPI_MAX_HANDLES) ;
+  }
+
+  if (dev->fd < 0)
+  {
+    snprintf (device, sizeof (device), "/dev/spidev%d.%d", bus, cs) ;
+    if ((dev->fd = open (device, O_RDWR)) < 0)
+    {
+      pthread_mutex_unlock (&spiHandlesMutex) ;
+      return wiringPiFailure (WPI_ALMOST, "Unable to open SPI device %s: %s\n", device, strerror (errno)) ;
+    }
+    dev->mode = -1 ;
+
+// Bits per word and speed are given with every transfer, these are only
+//	the defaults of the device.
+
+    if ((ioctl (dev->fd, SPI_IOC_WR_BITS_PER_WORD, &bpw) < 0) || (ioctl (dev->fd, SPI_IOC_WR_MAX_SPEED_HZ, &hz) < 0))
+    {
+      close (dev->fd) ;
+      dev->fd = -1 ;
+      pthread_mutex_unlock (&spiHandlesMutex) ;
+      return wiringPiFailure (WPI_ALMOST, "SPI BPW/Speed Change failure: %s\n", strerror (errno)) ;
+    }
+  }
+  ++dev->refs ;
+
+  h = &spiHandles [handle] ;
+  pthread_mutex_lock (&h->lock) ;
+  h->dev   = dev ;
+  h->speed = speed ;
+  h->mode  = mode & 3 ;
+  h->bpw   = spiBPW ;
+  h->delay = spiDelay ;
+  pthread_mutex_unlock (&spiHandlesMutex) ;
+
+  pthread_mutex_lock (&spiBusLocks [bus]) ;
+  result = spiSetMode (dev, dev->fd, h->mode) ;
+  pthread_mutex_unlock (&spiBusLocks [bus]) ;
+
+  if (result < 0)
+  {
+    h->dev = NULL ;
+    pthread_mutex_unlock (&h->lock) ;
+    spiRelease (dev) ;
+    return -1 ;
+  }
+
+  pthread_mutex_unlock (&h->lock) ;
+  return handle ;
+}
+
+
+/*
+ * wiringPiSPIConfig:
+ *	Change the mode, speed, bits-per-word and inter-transfer delay of
+ *	an open handle. The mode is written to the device when the handle
+ *	next uses it.
+ *********************************************************************************
+ */
+
+int wiringPiSPIConfig (int handle, int speed, int mode, int bpw, int delayUs)
+{
+  struct spiHandleStruct *h ;
+
+  if ((speed <= 0) || (bpw < 1) || (bpw > 32) || (delayUs < 0) || (delayUs > 65535))
+  {
+    errno = EINVAL ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIConfig: Invalid speed %d, bits %d or delay %d\n", speed, bpw, delayUs) ;
+  }
+
+  if ((h = spiHandle (handle)) == NULL)
+  {
+    errno = EBADF ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIConfig: Invalid handle: %d\n", handle) ;
+  }
+
+  h->speed = speed ;
+  h->mode  = mode & 3 ;
+  h->bpw   = bpw ;
+  h->delay = delayUs ;
+
+  pthread_mutex_unlock (&h->lock) ;
+  return 0 ;
+}
+
+
+/*
+ * wiringPiSPIHandleFd:
+ *	Return the file-descriptor of a handle
+ *********************************************************************************
+ */
+
+int wiringPiSPIHandleFd (int handle)
+{
+  struct spiHandleStruct *h ;
+  int fd ;
+
+  if ((h = spiHandle (handle)) == NULL)
+    return -1 ;
+
+  fd = h->dev->fd ;
+  pthread_mutex_unlock (&h->lock) ;
+  return fd ;
+}
+
+
+/*
+ * wiringPiSPIHandleTransfer:
+ *	Run a list of segments as one transaction on a handle, with the bus
+ *	locked and the device switched to the mode of the handle.
+ *********************************************************************************
+ */
+
+int wiringPiSPIHandleTransfer (int handle, const struct wiringPiSPISegment *segments, int count)
+{
+  struct spiHandleStruct *h ;
+  struct spiDevStruct *dev ;
+  int result ;
+
+  if ((h = spiHandle (handle)) == NULL)
+  {
+    errno = EBADF ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIHandleTransfer: Invalid handle: %d\n", handle) ;
+  }
+
+  dev = h->dev ;
+
+  pthread_mutex_lock (&spiBusLocks [dev->bus]) ;
+  if ((result = spiSetMode (dev, dev->fd, h->mode)) == 0)
+    result = spiMessage (dev->fd, h->speed, h->bpw, h->delay, segments, count) ;
+  pthread_mutex_unlock (&spiBusLocks [dev->bus]) ;
+
+  pthread_mutex_unlock (&h->lock) ;
+  return result ;
+}
+
+
+/*
+ * wiringPiSPIHandleRW:
+ *	Write and Read a block of data on a handle, full-duplex and in
+ *	place, like wiringPiSPIDataRW.
+ *********************************************************************************
+ */
+
+int wiringPiSPIHandleRW (int handle, unsigned char *data, int len)
+{
+  struct wiringPiSPISegment segment ;
+
+  memset (&segment, 0, sizeof (segment)) ;
+  segment.tx  = data ;
+  segment.rx  = data ;
+  segment.len = len ;
+
+  return wiringPiSPIHandleTransfer (handle, &segment, 1) ;
+}
+
+
+/*
+ * wiringPiSPIHandleClose:
+ *	Release a handle, the device is closed with its last handle.
+ *********************************************************************************
+ */
+
+int wiringPiSPIHandleClose (int handle)
+{
+  struct spiHandleStruct *h ;
+  struct spiDevStruct *dev ;
+
+  if ((h = spiHandle (handle)) == NULL)
+  {
+    errno = EBADF ;
+    return wiringPiFailure (WPI_ALMOST, "wiringPiSPIHandleClose: Invalid handle: %d\n", handle) ;
+  }
+
+  dev    = h->dev ;
+  h->dev = NULL ;
+  pthread_mutex_unlock (&h->lock) ;
+
+  spiRelease (dev) ;
+  return 0 ;
+}
@@ -26,10 +26,40 @@
 extern "C" {
 #endif
 
+// One segment of a multi-segment SPI transaction.
+//	Any of speed, delayUs and bits left at 0 uses the channel default.
+//	tx == NULL clocks out zeros, rx == NULL discards the received data.
+
+#define	WPI_SPI_MAX_SEGMENTS	64
+#define	WPI_SPI_MAX_HANDLES	16
+#define	WPI_SPI_MAX_BUSES	8
+
+struct wiringPiSPISegment
+{
+  unsigned char *tx ;
+  unsigned char *rx ;
+  unsigned int   len ;
+  unsigned int   speed ;
+  unsigned short delayUs ;
+  unsigned char  bits ;
+  unsigned char  csChange ;
+} ;
+
 int wiringPiSPIGetFd     (int channel) ;
 int wiringPiSPIDataRW    (int channel, unsigned char *data, int len) ;
 int wiringPiSPISetupMode (int channel, int speed, int mode) ;
 int wiringPiSPISetup     (int channel, int speed) ;
+int wiringPiSPITransfer  (int channel, const struct wiringPiSPISegment *segments, int count) ;
+int wiringPiSPIBufferSize (void) ;
+
+// Handle based access to any /dev/spidevB.C
+
+int wiringPiSPIOpen           (int bus, int cs, int speed, int mode) ;
+int wiringPiSPIConfig         (int handle, int speed, int mode, int bpw, int delayUs) ;
+int wiringPiSPIHandleFd       (int handle) ;
+int wiringPiSPIHandleRW       (int handle, unsigned char *data, int len) ;
+int wiringPiSPIHandleTransfer (int handle, const struct wiringPiSPISegment *segments, int count) ;
+int wiringPiSPIHandleClose    (int handle) ;
 
 #ifdef __cplusplus
 }
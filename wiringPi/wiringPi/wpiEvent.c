@@ -0,0 +1,399 @@
+/*
+ * wpiEvent.c:
+ *	Queued interrupt events.
+ *	Instead of calling a void (*)(void) function for every edge, the
+ *	interrupt handler thread of a pin pushes a record into a single-
+ *	producer/single-consumer ring for every queue subscribed to the pin.
+ *	The handler never blocks on a slow consumer, and edges arriving
+ *	while the consumer is busy are kept (up to the ring size) instead
+ *	of being lost. A full ring drops the new edge and counts it.
+ *
+ *	A queue has one ring per pin, so every ring has exactly one producer
+ *	(the pin's handler thread) and one consumer (whoever calls
+ *	wpiEventRead on the queue - only one thread may do so).
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+
+#include "wiringPi.h"
+#include "wpiEvent.h"
+
+// Queues per pin
+
+#define	MAX_QUEUES	4
+
+struct wpiEventRingStruct
+{
+  unsigned int head ;		// Written by the producer only
+  unsigned int tail ;		// Written by the consumer only
+  unsigned int overflows ;
+  int          pin ;
+  void        *userdata ;
+  struct wpiEventQueueStruct *queue ;
+  struct wpiEventStruct      *events ;
+} ;
+
+struct wpiEventQueueStruct
+{
+  unsigned int mask ;		// size - 1, size is a power of 2
+  int          fd ;		// eventfd to wake a blocked reader
+  int          waiting ;	// Reader is (about to be) blocked
+  int          numRings ;
+  struct wpiEventRingStruct *rings [64] ;
+} ;
+
+static struct wpiEventRingStruct *pinRings [64][MAX_QUEUES] ;
+static pthread_mutex_t eventMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+// Non-zero while the handler thread of the pin is in wpiEventPost, so
+//	a ring taken out of pinRings isn't freed under it
+
+static int posting [64] ;
+
+
+/*
+ * wpiEventQueueNew:
+ *	Create a queue. size is the number of events buffered per pin and
+ *	gets rounded up to a power of 2.
+ *********************************************************************************
+ */
+
+struct wpiEventQueueStruct *wpiEventQueueNew (int size)
+{
+  struct wpiEventQueueStruct *queue ;
+  unsigned int ringSize = 2 ;
+
+  if ((size <= 0) || (size > 65536))
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "wpiEventQueueNew: size must be 1-65536 (%d)\n", size) ;
+    return NULL ;
+  }
+
+  while (ringSize < (unsigned int)size)
+    ringSize <<= 1 ;
+
+  queue = (struct wpiEventQueueStruct *)calloc (1, sizeof (*queue)) ;
+  if (queue == NULL)
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "wpiEventQueueNew: Unable to allocate memory: %s\n", strerror (errno)) ;
+    return NULL ;
+  }
+
+  if ((queue->fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "wpiEventQueueNew: eventfd failed: %s\n", strerror (errno)) ;
+    free (queue) ;
+    return NULL ;
+  }
+
+  queue->mask = ringSize - 1 ;
+
+  return queue ;
+}
+
+
+/*
+ * wpiEventISR:
+ *	Subscribe the queue to the edges of a pin. Sets up the pin for
+ *	interrupts like wiringPiISR, but leaves any callback on it alone.
+ *	Call it from the thread reading the queue.
+ *********************************************************************************
+ */
+
+int wpiEventISR (struct wpiEventQueueStruct *queue, int pin, int mode, void *userdata)
+{
+  struct wpiEventRingStruct *ring ;
+  int i ;
+
+  if ((pin < 0) || (pin > 63))
+    return wiringPiFailure (WPI_FATAL, "wpiEventISR: pin must be 0-63 (%d)\n", pin) ;
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+    if (queue->rings [i]->pin == pin)
+      return wiringPiFailure (WPI_FATAL, "wpiEventISR: queue already subscribed to pin %d\n", pin) ;
+
+  ring = (struct wpiEventRingStruct *)calloc (1, sizeof (*ring)) ;
+  if (ring != NULL)
+    ring->events = (struct wpiEventStruct *)calloc (queue->mask + 1, sizeof (struct wpiEventStruct)) ;
+  if ((ring == NULL) || (ring->events == NULL))
+  {
+    free (ring) ;
+    return wiringPiFailure (WPI_FATAL, "wpiEventISR: Unable to allocate memory: %s\n", strerror (errno)) ;
+  }
+
+  ring->queue    = queue ;
+  ring->pin      = pin ;
+  ring->userdata = userdata ;
+
+  pthread_mutex_lock (&eventMutex) ;
+    for (i = 0 ; i < MAX_QUEUES ; ++i)
+      if (pinRings [pin][i] == NULL)
+	break ;
+    if (i < MAX_QUEUES)
+    {
+      queue->rings [queue->numRings++] = ring ;
+      __atomic_store_n (&pinRings [pin][i], ring, __ATOMIC_RELEASE) ;
+    }
+  pthread_mutex_unlock (&eventMutex) ;
+
+  if (i == MAX_QUEUES)
+  {
+    free (ring->events) ;
+    free (ring) ;
+    return wiringPiFailure (WPI_FATAL, "wpiEventISR: too many queues on pin %d\n", pin) ;
+  }
+
+  return wiringPiISRMode (pin, mode) ;
+}
+
+
+/*
+ * ringFree:
+ *	Take a ring out of pinRings, wait for the pin's handler thread to
+ *	be done with it and free it
+ *********************************************************************************
+ */
+
+static void ringFree (struct wpiEventRingStruct *ring)
+{
+  int i ;
+
+  pthread_mutex_lock (&eventMutex) ;
+    for (i = 0 ; i < MAX_QUEUES ; ++i)
+      if (pinRings [ring->pin][i] == ring)
+	__atomic_store_n (&pinRings [ring->pin][i], NULL, __ATOMIC_SEQ_CST) ;
+  pthread_mutex_unlock (&eventMutex) ;
+
+  while (__atomic_load_n (&posting [ring->pin], __ATOMIC_SEQ_CST) != 0)
+    sched_yield () ;
+
+  free (ring->events) ;
+  free (ring) ;
+}
+
+
+/*
+ * wpiEventUnsubscribe:
+ *	Stop queueing the edges of a pin. Events of the pin not yet read
+ *	are dropped. The pin stays set up for interrupts. Call it from
+ *	the thread reading the queue.
+ *********************************************************************************
+ */
+
+int wpiEventUnsubscribe (struct wpiEventQueueStruct *queue, int pin)
+{
+  int i ;
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+    if (queue->rings [i]->pin == pin)
+      break ;
+
+  if (i == queue->numRings)
+    return wiringPiFailure (WPI_FATAL, "wpiEventUnsubscribe: queue not subscribed to pin %d\n", pin) ;
+
+  ringFree (queue->rings [i]) ;
+  queue->rings [i] = queue->rings [--queue->numRings] ;
+
+  return 0 ;
+}
+
+
+/*
+ * wpiEventQueueFree:
+ *	Unsubscribe the queue from all its pins and free it. Nothing may
+ *	be reading the queue.
+ *********************************************************************************
+ */
+
+void wpiEventQueueFree (struct wpiEventQueueStruct *queue)
+{
+  int i ;
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+    ringFree (queue->rings [i]) ;
+
+  close (queue->fd) ;
+  free  (queue) ;
+}
+
+
+/*
+ * wpiEventPost:
+ *	Push an edge into every ring subscribed to the pin, waking the
+ *	reader if it is blocked. Only ever called from the pin's handler thread.
+ *********************************************************************************
+ */
+
+void wpiEventPost (int pin, int level, unsigned long long timestamp)
+{
+  struct wpiEventRingStruct *ring ;
+  struct wpiEventStruct *event ;
+  unsigned int head, tail ;
+  uint64_t one = 1 ;
+  int i ;
+
+  __atomic_add_fetch (&posting [pin], 1, __ATOMIC_SEQ_CST) ;
+
+  for (i = 0 ; i < MAX_QUEUES ; ++i)
+  {
+    if ((ring = __atomic_load_n (&pinRings [pin][i], __ATOMIC_SEQ_CST)) == NULL)
+      continue ;
+
+    head = ring->head ;
+    tail = __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE) ;
+
+    if ((head - tail) > ring->queue->mask)	// Full
+    {
+      __atomic_add_fetch (&ring->overflows, 1, __ATOMIC_RELAXED) ;
+      continue ;
+    }
+
+    event = &ring->events [head & ring->queue->mask] ;
+    event->pin       = pin ;
+    event->level     = level ;
+    event->timestamp = timestamp ;
+    event->userdata  = ring->userdata ;
+
+    __atomic_store_n (&ring->head, head + 1, __ATOMIC_SEQ_CST) ;
+
+    if (__atomic_load_n (&ring->queue->waiting, __ATOMIC_SEQ_CST))
+      (void)write (ring->queue->fd, &one, sizeof (one)) ;
+  }
+
+  __atomic_sub_fetch (&posting [pin], 1, __ATOMIC_SEQ_CST) ;
+}
+
+
+/*
+ * eventDrain:
+ *	Move up to n events out of the rings of a queue, oldest first.
+ *********************************************************************************
+ */
+
+static int eventDrain (struct wpiEventQueueStruct *queue, struct wpiEventStruct *events, int n)
+{
+  unsigned int heads [64], tails [64] ;
+  struct wpiEventRingStruct *ring ;
+  int i, oldest, count = 0 ;
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+  {
+    heads [i] = __atomic_load_n (&queue->rings [i]->head, __ATOMIC_ACQUIRE) ;
+    tails [i] = queue->rings [i]->tail ;
+  }
+
+  while (count < n)
+  {
+    oldest = -1 ;
+    for (i = 0 ; i < queue->numRings ; ++i)
+    {
+      if (tails [i] == heads [i])
+	continue ;
+      ring = queue->rings [i] ;
+      if ((oldest == -1) ||
+	  (ring->events [tails [i] & queue->mask].timestamp < queue->rings [oldest]->events [tails [oldest] & queue->mask].timestamp))
+	oldest = i ;
+    }
+    if (oldest == -1)
+      break ;
+
+    events [count++] = queue->rings [oldest]->events [tails [oldest]++ & queue->mask] ;
+  }
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+    __atomic_store_n (&queue->rings [i]->tail, tails [i], __ATOMIC_RELEASE) ;
+
+  return count ;
+}
+
+
+/*
+ * wpiEventRead:
+ *	Read up to n events into the array, oldest first. Returns as soon
+ *	as at least one event is available, or 0 after timeoutMs
+ *	(0 to not block at all, -1 to wait forever).
+ *********************************************************************************
+ */
+
+int wpiEventRead (struct wpiEventQueueStruct *queue, struct wpiEventStruct *events, int n, int timeoutMs)
+{
+  struct pollfd polls ;
+  unsigned int start = millis () ;
+  uint64_t dummy ;
+  int count, wait ;
+
+  if ((count = eventDrain (queue, events, n)) > 0 || (timeoutMs == 0))
+    return count ;
+
+  polls.fd     = queue->fd ;
+  polls.events = POLLIN ;
+
+  for (;;)
+  {
+    __atomic_store_n (&queue->waiting, 1, __ATOMIC_SEQ_CST) ;
+
+    if ((count = eventDrain (queue, events, n)) == 0)
+    {
+      wait = -1 ;
+      if (timeoutMs > 0)
+      {
+	wait = timeoutMs - (int)(millis () - start) ;
+	if (wait < 0)
+	  wait = 0 ;
+      }
+      if (poll (&polls, 1, wait) > 0)
+	(void)read (queue->fd, &dummy, sizeof (dummy)) ;
+      count = eventDrain (queue, events, n) ;
+    }
+
+    __atomic_store_n (&queue->waiting, 0, __ATOMIC_SEQ_CST) ;
+
+    if ((count > 0) || ((timeoutMs > 0) && ((int)(millis () - start) >= timeoutMs)))
+      return count ;
+  }
+}
+
+
+/*
+ * wpiEventOverflows:
+ *	Number of events dropped because a ring of the queue was full
+ *********************************************************************************
+ */
+
+unsigned int wpiEventOverflows (struct wpiEventQueueStruct *queue)
+{
+  unsigned int overflows = 0 ;
+  int i ;
+
+  for (i = 0 ; i < queue->numRings ; ++i)
+    overflows += __atomic_load_n (&queue->rings [i]->overflows, __ATOMIC_RELAXED) ;
+
+  return overflows ;
+}
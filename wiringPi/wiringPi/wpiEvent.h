@@ -0,0 +1,56 @@
+/*
+ * wpiEvent.h:
+ *	Queued interrupt events: edges delivered as (pin, level, timestamp,
+ *	userdata) records into lock-free rings.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+// wpiEventStruct:
+//	One edge as seen by the interrupt handler thread of a pin.
+//	timestamp is in uS on the same time base as micros (), but 64-bit.
+
+struct wpiEventStruct
+{
+  int                pin ;
+  int                level ;
+  unsigned long long timestamp ;
+  void              *userdata ;
+} ;
+
+struct wpiEventQueueStruct ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct wpiEventQueueStruct *wpiEventQueueNew (int size) ;
+extern int          wpiEventISR       (struct wpiEventQueueStruct *queue, int pin, int mode, void *userdata) ;
+extern int          wpiEventRead      (struct wpiEventQueueStruct *queue, struct wpiEventStruct *events, int n, int timeoutMs) ;
+extern unsigned int wpiEventOverflows (struct wpiEventQueueStruct *queue) ;
+extern int          wpiEventUnsubscribe (struct wpiEventQueueStruct *queue, int pin) ;
+extern void         wpiEventQueueFree (struct wpiEventQueueStruct *queue) ;
+
+// Internal - called by the interrupt handler threads
+
+extern void wpiEventPost (int pin, int level, unsigned long long timestamp) ;
+
+#ifdef __cplusplus
+}
+#endif
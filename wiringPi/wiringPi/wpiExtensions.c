@@ -458,16 +458,33 @@ static int doExtensionPcf8591 (char *progName, int pinBase, char *params)
 
 /*
  * doExtensionPseudoPins:
- *	64 Memory resident pseudo pins
- *	pseudoPins:base
+ *	Memory resident pseudo pins, 64 of them unless told otherwise, in
+ *	the default table unless given the name of another
+ *	pseudoPins:base[:pins[:name]]
  *********************************************************************************
  */
 
-static int doExtensionPseudoPins (UNU char *progName, int pinBase, UNU char *params)
+static int doExtensionPseudoPins (char *progName, int pinBase, char *params)
 {
-  pseudoPinsSetup (pinBase) ;
+  int pins = 64 ;
+  char *name = NULL ;
 
-  return TRUE ;
+  if (*params == 0)
+    return pseudoPinsSetup (pinBase) ;
+
+  if ((params = extractInt (progName, params, &pins)) == NULL)
+    return FALSE ;
+
+  if ((pins < 1) || (pins > 65536))
+  {
+    verbError ("%s: pins (%d) out of range (1-65536)", progName, pins) ;
+    return FALSE ;
+  }
+
+  if ((*params != 0) && ((params = extractStr (progName, params, &name)) == NULL))
+    return FALSE ;
+
+  return pseudoPinsSetupShared (pinBase, pins, name) ;
 }
 
 
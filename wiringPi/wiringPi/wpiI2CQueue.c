@@ -0,0 +1,364 @@
+/*
+ * wpiI2CQueue.c:
+ *	Asynchronous I2C transactions.
+ *	Every bus gets a queue and a worker thread the first time a request
+ *	for it is submitted. The worker runs the requests in order, and
+ *	requests that allow it and wait back-to-back for the same device are
+ *	put into a single I2C_RDWR (with a repeated START between them) as
+ *	long as their messages fit, which saves the ioctl and the STOP/START
+ *	pair.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "wiringPi.h"
+#include "wiringPiI2C.h"
+#include "wpiI2CQueue.h"
+
+#define	MAX_QUEUES	8
+
+struct i2cQueueStruct
+{
+  int             bus ;
+  pthread_t       thread ;
+  pthread_mutex_t lock ;
+  pthread_cond_t  cond ;
+  struct wpiI2CRequestStruct *head, *tail ;
+  struct wpiI2CQueueStatsStruct stats ;
+} ;
+
+static struct i2cQueueStruct queues [MAX_QUEUES] ;
+static int numQueues = 0 ;
+static pthread_mutex_t queuesMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+
+/*
+ * queueMicros:
+ *	Monotonic time in microseconds
+ *********************************************************************************
+ */
+
+static unsigned long long queueMicros (void)
+{
+  struct timespec ts ;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts) ;
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000 ;
+}
+
+
+/*
+ * queueComplete:
+ *	Account a finished request and hand it back to its owner, who may
+ *	reuse or free it right away.
+ *********************************************************************************
+ */
+
+static void queueComplete (struct i2cQueueStruct *queue, struct wpiI2CRequestStruct *request)
+{
+  void (*callback)(struct wpiI2CRequestStruct *) = request->callback ;
+  unsigned long long latency ;
+  uint64_t one = 1 ;
+  int eventFd = request->eventFd ;
+  int bucket = 0 ;
+
+  request->completed = queueMicros () ;
+  latency = request->completed - request->submitted ;
+  while ((bucket < WPI_I2C_LATENCY_BUCKETS - 1) && (latency >= (32ULL << bucket)))
+    ++bucket ;
+
+  pthread_mutex_lock (&queue->lock) ;
+    ++queue->stats.completed ;
+    ++queue->stats.latency [bucket] ;
+    if (request->result < 0)
+      ++queue->stats.errors ;
+  pthread_mutex_unlock (&queue->lock) ;
+
+  if (callback != NULL)
+  {
+    callback (request) ;
+    return ;
+  }
+
+  __atomic_store_n (&request->done, 1, __ATOMIC_RELEASE) ;
+
+  if (eventFd >= 0)
+    (void)write (eventFd, &one, sizeof (one)) ;
+}
+
+
+/*
+ * queueRun:
+ *	Run one request on its own.
+ *********************************************************************************
+ */
+
+static void queueRun (struct i2cQueueStruct *queue, struct wpiI2CRequestStruct *request)
+{
+  request->result = wiringPiI2CTransfer (request->fd, request->messages, request->count) ;
+  request->error  = (request->result < 0) ? errno : 0 ;
+
+  pthread_mutex_lock (&queue->lock) ;
+    ++queue->stats.ioctls ;
+  pthread_mutex_unlock (&queue->lock) ;
+
+  queueComplete (queue, request) ;
+}
+
+
+/*
+ * queueCanJoin:
+ *	Can the request go into the same I2C_RDWR as the batch so far?
+ *********************************************************************************
+ */
+
+static int queueCanJoin (struct wpiI2CRequestStruct *first, struct wpiI2CRequestStruct *request, int count)
+{
+  if ((request->fd != first->fd) || !(request->flags & first->flags & WPI_I2C_REQUEST_JOIN))
+    return FALSE ;
+
+  if ((request->messages [0].flags & WPI_I2C_NOSTART) != 0)
+    return FALSE ;
+
+  return (count + request->count) <= WPI_I2C_MAX_MESSAGES ;
+}
+
+
+/*
+ * queueWorker:
+ *	Thread running the requests of one bus.
+ *********************************************************************************
+ */
+
+static void *queueWorker (void *arg)
+{
+  struct i2cQueueStruct *queue = (struct i2cQueueStruct *)arg ;
+  struct wpiI2CRequestStruct *batch, *last, *request, *next ;
+  struct wiringPiI2CMessage messages [WPI_I2C_MAX_MESSAGES] ;
+  int count, n, result, error ;
+
+  for (;;)
+  {
+    pthread_mutex_lock (&queue->lock) ;
+
+      while (queue->head == NULL)
+	pthread_cond_wait (&queue->cond, &queue->lock) ;
+
+// Take the first request and the ones right behind it for the same device
+
+      batch = last = queue->head ;
+      count = batch->count ;
+      n     = 1 ;
+      while ((last->next != NULL) && queueCanJoin (batch, last->next, count))
+      {
+	last   = last->next ;
+	count += last->count ;
+	++n ;
+      }
+
+      queue->head = last->next ;
+      if (queue->head == NULL)
+	queue->tail = NULL ;
+      last->next = NULL ;
+      queue->stats.depth -= n ;
+
+    pthread_mutex_unlock (&queue->lock) ;
+
+    if (n == 1)
+    {
+      queueRun (queue, batch) ;
+      continue ;
+    }
+
+    count = 0 ;
+    for (request = batch ; request != NULL ; request = request->next)
+    {
+      memcpy (&messages [count], request->messages, request->count * sizeof (struct wiringPiI2CMessage)) ;
+      count += request->count ;
+    }
+
+    result = wiringPiI2CTransfer (batch->fd, messages, count) ;
+    error  = (result < 0) ? errno : 0 ;
+
+    pthread_mutex_lock (&queue->lock) ;
+      ++queue->stats.ioctls ;
+      if (result >= 0)
+	queue->stats.coalesced += n - 1 ;
+    pthread_mutex_unlock (&queue->lock) ;
+
+// A failed batch doesn't tell which request failed, and the ones
+//	before it have already gone to the device, so they can't just be
+//	run again - a second register or FIFO write isn't harmless. They
+//	all get the error.
+
+    for (request = batch ; request != NULL ; request = next)
+    {
+      next = request->next ;
+      request->result = (result < 0) ? -1 : request->count ;
+      request->error  = error ;
+      queueComplete (queue, request) ;
+    }
+  }
+
+  return NULL ;
+}
+
+
+/*
+ * queueFind:
+ *	Find the queue of a bus, starting its worker the first time.
+ *********************************************************************************
+ */
+
+static struct i2cQueueStruct *queueFind (int bus, int create)
+{
+  struct i2cQueueStruct *queue ;
+  int i ;
+
+  pthread_mutex_lock (&queuesMutex) ;
+
+    for (i = 0 ; i < numQueues ; ++i)
+      if (queues [i].bus == bus)
+      {
+	pthread_mutex_unlock (&queuesMutex) ;
+	return &queues [i] ;
+      }
+
+    if (!create || (numQueues == MAX_QUEUES))
+    {
+      pthread_mutex_unlock (&queuesMutex) ;
+      return NULL ;
+    }
+
+    queue = &queues [numQueues] ;
+    memset (queue, 0, sizeof (*queue)) ;
+    pthread_mutex_init (&queue->lock, NULL) ;
+    pthread_cond_init  (&queue->cond, NULL) ;
+    queue->bus = bus ;
+
+    if (pthread_create (&queue->thread, NULL, queueWorker, queue) != 0)
+    {
+      pthread_mutex_unlock (&queuesMutex) ;
+      return NULL ;
+    }
+    pthread_detach (queue->thread) ;
+    ++numQueues ;
+
+  pthread_mutex_unlock (&queuesMutex) ;
+
+  return queue ;
+}
+
+
+/*
+ * wpiI2CSubmit:
+ *	Queue a request on the bus of its handle. Returns 0, or -1 with
+ *	errno set if it can't be queued - it is then never completed.
+ *********************************************************************************
+ */
+
+int wpiI2CSubmit (struct wpiI2CRequestStruct *request)
+{
+  struct i2cQueueStruct *queue ;
+  int bus ;
+
+  if ((request->count < 1) || (request->count > WPI_I2C_MAX_MESSAGES))
+  {
+    errno = EINVAL ;
+    return -1 ;
+  }
+
+  if ((bus = wiringPiI2CBus (request->fd)) < 0)
+    return -1 ;
+
+  if ((queue = queueFind (bus, TRUE)) == NULL)
+  {
+    errno = EAGAIN ;
+    return -1 ;
+  }
+
+  request->result    = 0 ;
+  request->error     = 0 ;
+  request->done      = 0 ;
+  request->submitted = queueMicros () ;
+  request->completed = 0 ;
+  request->next      = NULL ;
+
+  pthread_mutex_lock (&queue->lock) ;
+
+    if (queue->tail == NULL)
+      queue->head = request ;
+    else
+      queue->tail->next = request ;
+    queue->tail = request ;
+
+    ++queue->stats.submitted ;
+    if (++queue->stats.depth > queue->stats.maxDepth)
+      queue->stats.maxDepth = queue->stats.depth ;
+
+    pthread_cond_signal (&queue->cond) ;
+
+  pthread_mutex_unlock (&queue->lock) ;
+
+  return 0 ;
+}
+
+
+/*
+ * wpiI2CQueueStats:
+ *	Copy the counters of the queue of a bus, optionally clearing them.
+ *	A bus nothing was ever submitted to has all counters at 0.
+ *********************************************************************************
+ */
+
+int wpiI2CQueueStats (int bus, struct wpiI2CQueueStatsStruct *stats, int reset)
+{
+  struct i2cQueueStruct *queue ;
+  unsigned int depth ;
+
+  if ((queue = queueFind (bus, FALSE)) == NULL)
+  {
+    memset (stats, 0, sizeof (*stats)) ;
+    return 0 ;
+  }
+
+  pthread_mutex_lock (&queue->lock) ;
+
+    *stats = queue->stats ;
+
+    if (reset)
+    {
+      depth = queue->stats.depth ;
+      memset (&queue->stats, 0, sizeof (queue->stats)) ;
+      queue->stats.depth    = depth ;
+      queue->stats.maxDepth = depth ;
+    }
+
+  pthread_mutex_unlock (&queue->lock) ;
+
+  return 0 ;
+}
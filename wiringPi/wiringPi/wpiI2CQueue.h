@@ -0,0 +1,91 @@
+/*
+ * wpiI2CQueue.h:
+ *	Asynchronous I2C transactions, queued per bus and run by a worker
+ *	thread for each bus.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+struct wiringPiI2CMessage ;
+
+// wpiI2CRequestStruct:
+//	One transaction, owned by the caller and untouched by the queue
+//	until it completes. fd must be a handle from wiringPiI2COpen, the
+//	messages must stay valid until then. On completion result and
+//	error hold what wiringPiI2CTransfer returned and errno, and the
+//	request is handed back: callback is called on the worker thread if
+//	set, otherwise done is set and eventFd (if >= 0) gets a count of 1.
+//	Requests with WPI_I2C_REQUEST_JOIN may share an I2C_RDWR with the
+//	ones next to them that set it too, so the STOP between them becomes
+//	a repeated START - only set it where the device doesn't act on the
+//	STOP (not on EEPROM writes or start-conversion commands). Requests
+//	that shared a failed I2C_RDWR all get its error, whichever of them
+//	the device choked on.
+
+#define	WPI_I2C_REQUEST_JOIN	0x0001	// May share an I2C_RDWR with other requests
+
+struct wpiI2CRequestStruct
+{
+  int fd ;
+  int flags ;
+  const struct wiringPiI2CMessage *messages ;
+  int count ;
+  void (*callback)(struct wpiI2CRequestStruct *request) ;
+  int eventFd ;
+  void *userdata ;
+
+// Filled in by the queue
+
+  int result ;
+  int error ;
+  int done ;
+  unsigned long long submitted ;	// uS, CLOCK_MONOTONIC
+  unsigned long long completed ;
+  struct wpiI2CRequestStruct *next ;
+} ;
+
+// wpiI2CQueueStatsStruct:
+//	Counters of the queue of one bus. Latency is from submission to
+//	completion; bucket n counts the requests done in less than
+//	(32 << n) uS, the last bucket all the slower ones.
+
+#define	WPI_I2C_LATENCY_BUCKETS	16
+
+struct wpiI2CQueueStatsStruct
+{
+  unsigned int submitted ;
+  unsigned int completed ;
+  unsigned int errors ;
+  unsigned int ioctls ;		// I2C_RDWR calls made by the worker
+  unsigned int coalesced ;	// Requests that shared an ioctl with the one before
+  unsigned int depth ;		// Requests waiting right now
+  unsigned int maxDepth ;
+  unsigned int latency [WPI_I2C_LATENCY_BUCKETS] ;
+} ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int wpiI2CSubmit     (struct wpiI2CRequestStruct *request) ;
+extern int wpiI2CQueueStats (int bus, struct wpiI2CQueueStatsStruct *stats, int reset) ;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,475 @@
+/*
+ * wpiPoll.c:
+ *	Scheduled polling of analog devices into a snapshot table.
+ *	Every slot reads a run of pins on one device node at a fixed period.
+ *	Slots on the same I2C bus share a thread, which starts the
+ *	conversions of all the devices that are due together, in device
+ *	order, and collects each result when the device says it will be
+ *	ready - so one device converting doesn't hold up the bus for the
+ *	others. Nodes with pollStart/pollFetch hooks get this split, any
+ *	other node is read with its analogRead.
+ *
+ *	The results go into a table of 64-byte slots with a sequence count
+ *	per slot, so readers never take a lock or touch the bus.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "wiringPi.h"
+#include "wiringPiI2C.h"
+#include "wpiPoll.h"
+
+#define	MAX_GROUPS	8
+#define	GROUP_SLACK	1000	// uS - reads due this soon start with the ones due now
+
+struct pollGroupStruct
+{
+  int             bus ;		// I2C bus, -1 for all the other devices
+  pthread_t       thread ;
+  pthread_mutex_t lock ;
+  pthread_cond_t  cond ;
+  int             numSlots ;
+  int             order [WPI_POLL_MAX_SLOTS] ;	// Slots sorted by device
+} ;
+
+struct pollEntryStruct
+{
+  struct pollGroupStruct    *group ;	// NULL when the slot is free
+  struct wiringPiNodeStruct *node ;
+  int pin ;
+  int count ;
+  int step ;				// Value being converted, -1 when idle
+  int values [WPI_POLL_MAX_VALUES] ;
+  unsigned int reads, errors, overruns ;
+  unsigned long long period, due, ready ;
+} ;
+
+static struct wpiPollSnapshotStruct pollTable [WPI_POLL_MAX_SLOTS] __attribute__ ((aligned (64))) ;
+static struct pollEntryStruct       pollEntries [WPI_POLL_MAX_SLOTS] ;
+static struct pollGroupStruct       pollGroups [MAX_GROUPS] ;
+static int numGroups = 0 ;
+static pthread_mutex_t pollMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+
+/*
+ * pollMicros:
+ *	Monotonic time in microseconds
+ *********************************************************************************
+ */
+
+static unsigned long long pollMicros (void)
+{
+  struct timespec ts ;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts) ;
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000 ;
+}
+
+
+/*
+ * pollPublish:
+ *	Update the snapshot of a slot. Only ever called by the thread that
+ *	owns the slot, or with the slot idle.
+ *********************************************************************************
+ */
+
+static void pollPublish (int slot, struct pollEntryStruct *entry, int status, int fresh)
+{
+  struct wpiPollSnapshotStruct *snapshot = &pollTable [slot] ;
+  unsigned int sequence = snapshot->sequence ;
+
+  __atomic_store_n (&snapshot->sequence, sequence + 1, __ATOMIC_RELAXED) ;
+  __atomic_thread_fence (__ATOMIC_RELEASE) ;
+
+    snapshot->reads    = entry->reads ;
+    snapshot->errors   = entry->errors ;
+    snapshot->overruns = entry->overruns ;
+    snapshot->status   = status ;
+    snapshot->count    = entry->count ;
+    if (fresh)
+    {
+      snapshot->timestamp = pollMicros () ;
+      memcpy (snapshot->values, entry->values, sizeof (snapshot->values)) ;
+    }
+
+  __atomic_store_n (&snapshot->sequence, sequence + 2, __ATOMIC_RELEASE) ;
+}
+
+
+/*
+ * pollStart: pollFetch:
+ *	Run the current step of a slot on its node
+ *********************************************************************************
+ */
+
+static int pollStart (struct pollEntryStruct *entry)
+{
+  if (entry->node->pollStart == NULL)
+    return 0 ;
+
+  return entry->node->pollStart (entry->node, entry->pin + entry->step) ;
+}
+
+static int pollFetch (struct pollEntryStruct *entry, int *value)
+{
+  if (entry->node->pollFetch == NULL)
+  {
+    *value = entry->node->analogRead (entry->node, entry->pin + entry->step) ;
+    return 0 ;
+  }
+
+  return entry->node->pollFetch (entry->node, entry->pin + entry->step, value) ;
+}
+
+
+/*
+ * pollDone:
+ *	Finish a round of a slot and work out when the next one is due,
+ *	skipping the periods that have already gone by.
+ *********************************************************************************
+ */
+
+static void pollDone (int slot, struct pollEntryStruct *entry, int status)
+{
+  unsigned long long now = pollMicros () ;
+  unsigned long long skipped ;
+
+  if (status == 0)
+    ++entry->reads ;
+  else
+    ++entry->errors ;
+
+  entry->step = -1 ;
+  entry->due += entry->period ;
+  if (entry->due <= now)
+  {
+    skipped = (now - entry->due) / entry->period + 1 ;
+    entry->due      += skipped * entry->period ;
+    entry->overruns += skipped ;
+  }
+
+  pollPublish (slot, entry, status, status == 0) ;
+}
+
+
+/*
+ * pollBegin:
+ *	Start the conversion of the current step of a slot
+ *********************************************************************************
+ */
+
+static void pollBegin (int slot, struct pollEntryStruct *entry)
+{
+  int wait ;
+
+  if ((wait = pollStart (entry)) < 0)
+    pollDone (slot, entry, (errno != 0) ? -errno : -EIO) ;
+  else
+    entry->ready = pollMicros () + wait ;
+}
+
+
+/*
+ * pollThread:
+ *	Run the slots of one group
+ *********************************************************************************
+ */
+
+static void *pollThread (void *arg)
+{
+  struct pollGroupStruct *group = (struct pollGroupStruct *)arg ;
+  struct pollEntryStruct *entry ;
+  unsigned long long now, wake, when ;
+  struct timespec ts ;
+  int i, slot, wait, value ;
+
+  pthread_mutex_lock (&group->lock) ;
+
+  for (;;)
+  {
+
+// Collect the finished conversions, going straight on to the next
+//	value of the same device
+
+    now = pollMicros () ;
+    for (i = 0 ; i < group->numSlots ; ++i)
+    {
+      slot  = group->order [i] ;
+      entry = &pollEntries [slot] ;
+      if ((entry->step < 0) || (entry->ready > now))
+	continue ;
+
+      errno = 0 ;
+      if ((wait = pollFetch (entry, &value)) > 0)
+	entry->ready = pollMicros () + wait ;
+      else if (wait < 0)
+	pollDone (slot, entry, (errno != 0) ? -errno : -EIO) ;
+      else
+      {
+	entry->values [entry->step] = value ;
+	if (++entry->step < entry->count)
+	  pollBegin (slot, entry) ;
+	else
+	  pollDone (slot, entry, 0) ;
+      }
+    }
+
+// Start the slots that are due
+
+    now = pollMicros () ;
+    for (i = 0 ; i < group->numSlots ; ++i)
+    {
+      slot  = group->order [i] ;
+      entry = &pollEntries [slot] ;
+      if ((entry->step < 0) && (entry->due <= now + GROUP_SLACK))
+      {
+	entry->step = 0 ;
+	errno = 0 ;
+	pollBegin (slot, entry) ;
+      }
+    }
+
+// Sleep until the next conversion is ready or the next slot is due
+
+    wake = ~0ULL ;
+    for (i = 0 ; i < group->numSlots ; ++i)
+    {
+      entry = &pollEntries [group->order [i]] ;
+      when  = (entry->step < 0) ? entry->due : entry->ready ;
+      if (when < wake)
+	wake = when ;
+    }
+
+    if (group->numSlots == 0)
+      pthread_cond_wait (&group->cond, &group->lock) ;
+    else if (wake > pollMicros ())
+    {
+      ts.tv_sec  = wake / 1000000ULL ;
+      ts.tv_nsec = (wake % 1000000ULL) * 1000 ;
+      pthread_cond_timedwait (&group->cond, &group->lock, &ts) ;
+    }
+  }
+
+  return NULL ;
+}
+
+
+/*
+ * pollGroup:
+ *	Find the group of a bus, starting its thread the first time.
+ *	Called with pollMutex held.
+ *********************************************************************************
+ */
+
+static struct pollGroupStruct *pollGroup (int bus)
+{
+  struct pollGroupStruct *group ;
+  pthread_condattr_t attr ;
+  int i ;
+
+  for (i = 0 ; i < numGroups ; ++i)
+    if (pollGroups [i].bus == bus)
+      return &pollGroups [i] ;
+
+  if (numGroups == MAX_GROUPS)
+    return NULL ;
+
+  group = &pollGroups [numGroups] ;
+  memset (group, 0, sizeof (*group)) ;
+  group->bus = bus ;
+
+  pthread_condattr_init (&attr) ;
+  pthread_condattr_setclock (&attr, CLOCK_MONOTONIC) ;
+  pthread_cond_init  (&group->cond, &attr) ;
+  pthread_condattr_destroy (&attr) ;
+  pthread_mutex_init (&group->lock, NULL) ;
+
+  if (pthread_create (&group->thread, NULL, pollThread, group) != 0)
+    return NULL ;
+  pthread_detach (group->thread) ;
+
+  return &pollGroups [numGroups++] ;
+}
+
+
+/*
+ * wpiPollAdd:
+ *	Read count pins from pin on, all on one device node, every
+ *	periodMs into a new slot of the table. Returns the slot.
+ *********************************************************************************
+ */
+
+int wpiPollAdd (int pin, int count, int periodMs)
+{
+  struct wiringPiNodeStruct *node ;
+  struct pollGroupStruct *group ;
+  struct pollEntryStruct *entry ;
+  int slot, i, j ;
+
+  if ((count < 1) || (count > WPI_POLL_MAX_VALUES) || (periodMs < 1))
+    return wiringPiFailure (WPI_ALMOST, "wpiPollAdd: Invalid count (%d) or period (%d)\n", count, periodMs) ;
+
+  if (((node = wiringPiFindNode (pin)) == NULL) || (pin + count - 1 > node->pinMax))
+    return wiringPiFailure (WPI_ALMOST, "wpiPollAdd: Pins %d-%d are not on one device\n", pin, pin + count - 1) ;
+
+  pthread_mutex_lock (&pollMutex) ;
+
+// A device only does one conversion at a time
+
+    for (slot = 0 ; slot < WPI_POLL_MAX_SLOTS ; ++slot)
+      if ((pollEntries [slot].group != NULL) && (pollEntries [slot].node == node))
+      {
+	pthread_mutex_unlock (&pollMutex) ;
+	return wiringPiFailure (WPI_ALMOST, "wpiPollAdd: The device of pin %d is already polled in slot %d\n", pin, slot) ;
+      }
+
+    for (slot = 0 ; slot < WPI_POLL_MAX_SLOTS ; ++slot)
+      if (pollEntries [slot].group == NULL)
+	break ;
+
+    if ((slot == WPI_POLL_MAX_SLOTS) || ((group = pollGroup (wiringPiI2CBus (node->fd))) == NULL))
+    {
+      pthread_mutex_unlock (&pollMutex) ;
+      return wiringPiFailure (WPI_ALMOST, "wpiPollAdd: Too many slots or buses\n") ;
+    }
+
+    entry = &pollEntries [slot] ;
+    memset (entry, 0, sizeof (*entry)) ;
+    entry->node   = node ;
+    entry->pin    = pin ;
+    entry->count  = count ;
+    entry->step   = -1 ;
+    entry->period = periodMs * 1000ULL ;
+    entry->due    = pollMicros () ;
+    pollPublish (slot, entry, -EAGAIN, TRUE) ;	// Nothing read yet
+
+    pthread_mutex_lock (&group->lock) ;
+
+      for (i = 0 ; i < group->numSlots ; ++i)
+	if (pollEntries [group->order [i]].node->fd > node->fd)
+	  break ;
+      for (j = group->numSlots ; j > i ; --j)
+	group->order [j] = group->order [j - 1] ;
+      group->order [i] = slot ;
+      ++group->numSlots ;
+      entry->group = group ;
+
+      pthread_cond_signal (&group->cond) ;
+
+    pthread_mutex_unlock (&group->lock) ;
+
+  pthread_mutex_unlock (&pollMutex) ;
+
+  return slot ;
+}
+
+
+/*
+ * wpiPollRemove:
+ *	Stop polling a slot. Its snapshot stays as it was last updated.
+ *********************************************************************************
+ */
+
+int wpiPollRemove (int slot)
+{
+  struct pollGroupStruct *group ;
+  int i ;
+
+  if ((slot < 0) || (slot >= WPI_POLL_MAX_SLOTS))
+    return wiringPiFailure (WPI_ALMOST, "wpiPollRemove: Invalid slot: %d\n", slot) ;
+
+  pthread_mutex_lock (&pollMutex) ;
+
+    if ((group = pollEntries [slot].group) == NULL)
+    {
+      pthread_mutex_unlock (&pollMutex) ;
+      return wiringPiFailure (WPI_ALMOST, "wpiPollRemove: Slot %d is not in use\n", slot) ;
+    }
+
+    pthread_mutex_lock (&group->lock) ;
+
+      for (i = 0 ; i < group->numSlots ; ++i)
+	if (group->order [i] == slot)
+	  break ;
+      for (--group->numSlots ; i < group->numSlots ; ++i)
+	group->order [i] = group->order [i + 1] ;
+      pollEntries [slot].group = NULL ;
+
+    pthread_mutex_unlock (&group->lock) ;
+
+  pthread_mutex_unlock (&pollMutex) ;
+
+  return 0 ;
+}
+
+
+/*
+ * wpiPollRead:
+ *	Take a consistent copy of the snapshot of a slot, without locking.
+ *********************************************************************************
+ */
+
+int wpiPollRead (int slot, struct wpiPollSnapshotStruct *snapshot)
+{
+  struct wpiPollSnapshotStruct *source ;
+  unsigned int sequence ;
+
+  if ((slot < 0) || (slot >= WPI_POLL_MAX_SLOTS))
+  {
+    errno = EINVAL ;
+    return -1 ;
+  }
+
+  source = &pollTable [slot] ;
+  for (;;)
+  {
+    sequence = __atomic_load_n (&source->sequence, __ATOMIC_ACQUIRE) ;
+    if ((sequence & 1) != 0)
+      continue ;
+
+    memcpy (snapshot, source, sizeof (*snapshot)) ;
+    __atomic_thread_fence (__ATOMIC_ACQUIRE) ;
+
+    if (__atomic_load_n (&source->sequence, __ATOMIC_RELAXED) == sequence)
+      break ;
+  }
+
+  snapshot->sequence = sequence ;
+  return 0 ;
+}
+
+
+/*
+ * wpiPollTable:
+ *	The snapshot table itself (WPI_POLL_MAX_SLOTS entries), to share
+ *	with readers that follow the sequence protocol themselves.
+ *********************************************************************************
+ */
+
+struct wpiPollSnapshotStruct *wpiPollTable (void)
+{
+  return pollTable ;
+}
@@ -0,0 +1,58 @@
+/*
+ * wpiPoll.h:
+ *	Scheduled polling of analog devices into a snapshot table.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#define	WPI_POLL_MAX_SLOTS	64
+#define	WPI_POLL_MAX_VALUES	8
+
+// wpiPollSnapshotStruct:
+//	The latest reading of a slot, exactly 64 bytes so the table can be
+//	shared as is. sequence is odd while the poller updates the slot;
+//	a copy taken between two equal, even reads of it is consistent.
+//	timestamp is in uS (CLOCK_MONOTONIC) when the last value arrived,
+//	status 0 or -errno of the last attempt, which keeps the old values.
+
+struct wpiPollSnapshotStruct
+{
+  unsigned int       sequence ;
+  unsigned int       reads ;
+  unsigned int       errors ;
+  unsigned int       overruns ;		// Periods skipped because a read took too long
+  unsigned long long timestamp ;
+  int                status ;
+  int                count ;
+  int                values [WPI_POLL_MAX_VALUES] ;
+} ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int wpiPollAdd    (int pin, int count, int periodMs) ;
+extern int wpiPollRemove (int slot) ;
+extern int wpiPollRead   (int slot, struct wpiPollSnapshotStruct *snapshot) ;
+
+extern struct wpiPollSnapshotStruct *wpiPollTable (void) ;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,185 @@
+/*
+ * wpiRegCache.c:
+ *	Write-through register cache for the GPIO expander drivers.
+ *	Configuration registers (direction, pull-ups, ...) only change when
+ *	we write them, so after the first read a read-modify-write of one
+ *	bit costs one bus write - or none if the bit is already right.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "wiringPi.h"
+#include "wpiRegCache.h"
+
+
+/*
+ * wpiRegCacheNew:
+ *	Create an empty cache for a node, with the bus access functions of
+ *	its driver. Every register starts unknown and is read from the
+ *	device the first time it's needed. node may be NULL and filled in
+ *	later, so a driver can create the cache before its node.
+ *********************************************************************************
+ */
+
+struct wpiRegCacheStruct *wpiRegCacheNew (struct wiringPiNodeStruct *node,
+				int (*busRead)  (struct wiringPiNodeStruct *node, int reg),
+				int (*busWrite) (struct wiringPiNodeStruct *node, int reg, int value),
+				unsigned int volatileRegs)
+{
+  struct wpiRegCacheStruct *cache ;
+
+  cache = (struct wpiRegCacheStruct *)calloc (1, sizeof (*cache)) ;
+  if (cache == NULL)
+  {
+    (void)wiringPiFailure (WPI_ALMOST, "wpiRegCacheNew: Unable to allocate memory: %s\n", strerror (errno)) ;
+    return NULL ;
+  }
+
+  cache->node         = node ;
+  cache->busRead      = busRead ;
+  cache->busWrite     = busWrite ;
+  cache->volatileRegs = volatileRegs ;
+
+  return cache ;
+}
+
+
+/*
+ * wpiRegCacheRead:
+ *	Return the value of a register, from the cache if it's known.
+ *	Returns -1 if the bus read fails.
+ *********************************************************************************
+ */
+
+int wpiRegCacheRead (struct wpiRegCacheStruct *cache, int reg)
+{
+  unsigned int bit = WPI_REGCACHE_REG (reg) ;
+  int value ;
+
+  if (((cache->valid & bit) != 0) && ((cache->volatileRegs & bit) == 0))
+    return cache->values [reg] ;
+
+  ++cache->busReads ;
+  if ((value = cache->busRead (cache->node, reg)) < 0)
+    return -1 ;
+
+  if ((cache->volatileRegs & bit) == 0)
+  {
+    cache->values [reg] = value ;
+    cache->valid       |= bit ;
+  }
+
+  return value ;
+}
+
+
+/*
+ * wpiRegCacheWrite:
+ *	Write a register through to the device, unless the cache already
+ *	knows it holds that value. If the write fails the value is kept
+ *	and marked dirty for wpiRegCacheFlush or the next write.
+ *********************************************************************************
+ */
+
+int wpiRegCacheWrite (struct wpiRegCacheStruct *cache, int reg, int value)
+{
+  unsigned int bit = WPI_REGCACHE_REG (reg) ;
+
+  value &= 0xFF ;
+
+  if (((cache->valid & bit) != 0) && ((cache->dirty & bit) == 0) &&
+      ((cache->volatileRegs & bit) == 0) && (cache->values [reg] == value))
+    return 0 ;
+
+  ++cache->busWrites ;
+  if (cache->busWrite (cache->node, reg, value) < 0)
+  {
+    if ((cache->volatileRegs & bit) == 0)
+    {
+      cache->values [reg] = value ;
+      cache->valid       |= bit ;
+      cache->dirty       |= bit ;
+    }
+    return -1 ;
+  }
+
+  if ((cache->volatileRegs & bit) == 0)
+  {
+    cache->values [reg] = value ;
+    cache->valid       |= bit ;
+  }
+  cache->dirty &= ~bit ;
+
+  return 0 ;
+}
+
+
+/*
+ * wpiRegCacheUpdate:
+ *	Change the bits in mask of a register to bits.
+ *********************************************************************************
+ */
+
+int wpiRegCacheUpdate (struct wpiRegCacheStruct *cache, int reg, int mask, int bits)
+{
+  int value ;
+
+  if ((value = wpiRegCacheRead (cache, reg)) < 0)
+    return -1 ;
+
+  return wpiRegCacheWrite (cache, reg, (value & ~mask) | (bits & mask)) ;
+}
+
+
+/*
+ * wpiRegCacheFlush:
+ *	Retry the writes that failed. Returns the number of registers
+ *	still dirty.
+ *********************************************************************************
+ */
+
+int wpiRegCacheFlush (struct wpiRegCacheStruct *cache)
+{
+  int reg, left = 0 ;
+
+  for (reg = 0 ; reg < WPI_REGCACHE_MAX ; ++reg)
+    if ((cache->dirty & WPI_REGCACHE_REG (reg)) != 0)
+      if (wpiRegCacheWrite (cache, reg, cache->values [reg]) < 0)
+	++left ;
+
+  return left ;
+}
+
+
+/*
+ * wpiRegCacheInvalidate:
+ *	Forget everything, e.g. after the device has been reset.
+ *********************************************************************************
+ */
+
+void wpiRegCacheInvalidate (struct wpiRegCacheStruct *cache)
+{
+  cache->valid = 0 ;
+  cache->dirty = 0 ;
+}
@@ -0,0 +1,67 @@
+/*
+ * wpiRegCache.h:
+ *	Write-through register cache for the GPIO expander drivers.
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as
+ *    published by the Free Software Foundation, either version 3 of the
+ *    License, or (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with wiringPi.
+ *    If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+// wpiRegCacheStruct:
+//	Shadow copy of the (up to 32) 8-bit registers of a device. valid
+//	marks the registers whose value is known, dirty the ones whose last
+//	write failed and still has to reach the device. Registers in
+//	volatileRegs (inputs, interrupt flags) always go to the bus.
+//	busReads and busWrites count the bus transactions made.
+
+#define	WPI_REGCACHE_MAX	32
+#define	WPI_REGCACHE_REG(r)	(1U << (r))
+
+struct wiringPiNodeStruct ;
+
+struct wpiRegCacheStruct
+{
+  int (*busRead)  (struct wiringPiNodeStruct *node, int reg) ;
+  int (*busWrite) (struct wiringPiNodeStruct *node, int reg, int value) ;
+  struct wiringPiNodeStruct *node ;
+
+  unsigned int  valid ;
+  unsigned int  dirty ;
+  unsigned int  volatileRegs ;
+  unsigned int  busReads ;
+  unsigned int  busWrites ;
+  unsigned char values [WPI_REGCACHE_MAX] ;
+} ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct wpiRegCacheStruct *wpiRegCacheNew (struct wiringPiNodeStruct *node,
+				int (*busRead)  (struct wiringPiNodeStruct *node, int reg),
+				int (*busWrite) (struct wiringPiNodeStruct *node, int reg, int value),
+				unsigned int volatileRegs) ;
+
+extern int  wpiRegCacheRead       (struct wpiRegCacheStruct *cache, int reg) ;
+extern int  wpiRegCacheWrite      (struct wpiRegCacheStruct *cache, int reg, int value) ;
+extern int  wpiRegCacheUpdate     (struct wpiRegCacheStruct *cache, int reg, int mask, int bits) ;
+extern int  wpiRegCacheFlush      (struct wpiRegCacheStruct *cache) ;
+extern void wpiRegCacheInvalidate (struct wpiRegCacheStruct *cache) ;
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,6 +22,7 @@
 
 #define	DEFAULT_SERVER_PORT	6124
 
+#define	DRCN_NOP		0
 #define	DRCN_PIN_MODE		1
 #define	DRCN_PULL_UP_DN		2
 
@@ -34,11 +35,99 @@
 #define	DRCN_DIGITAL_READ8	8
 #define	DRCN_ANALOG_READ	9
 
+#define	DRCN_SUBSCRIBE		10
+#define	DRCN_EVENT		11
+
+#define	DRCN_WRITE_MASKED	12
+#define	DRCN_READ_ALL		13
+#define	DRCN_ANALOG_READ_LIST	14
+
+#define	DRCN_UDP_OPEN		15
+#define	DRCN_UDP_STATE		16
+
+#define	DRCN_SESSION		17
+
+// Protocol 2, announced by the server in its greeting, lets the client
+//	pipeline commands: the top 16 bits of cmd carry a sequence number the
+//	server hands back in the reply, and commands sent with DRCN_NO_REPLY
+//	get no reply at all. DRCN_NOP is just replied to, as a sync point.
+
+#define	DRCN_PROTOCOL		5
+
+#define	DRCN_CMD_MASK		0x000000FF
+#define	DRCN_NO_REPLY		0x00000100
+#define	DRCN_SEQ_SHIFT		16
+
+// DRCN_SUBSCRIBE asks for edges on pin to be pushed to the client, data is
+//	the INT_EDGE_ mode, or 0 to stop. The reply data is 0, or non-zero
+//	if the server can't. Edges then arrive unasked as DRCN_EVENT frames:
+//	DRCN_EVENT_HIGH in cmd is the level, data has bits 0-31 of the
+//	timestamp (uS) and the top of cmd bits 32-47.
+
+#define	DRCN_EVENT_HIGH		0x00000200
+
+// Protocol 3 adds the bulk commands, which have 32-bit words of payload
+//	after the frame, one or both ways:
+//	DRCN_WRITE_MASKED:	Up to 64 pins from pin. Followed by the mask then
+//				the levels, each low then high word. Only pins
+//				with their mask bit set are written.
+//	DRCN_READ_ALL:		data pins (1-64) from pin. The reply is followed
+//				by their levels, low then high word.
+//	DRCN_ANALOG_READ_LIST:	Followed by data (up to DRCN_MAX_LIST) pin
+//				numbers, the reply by the value of each.
+
+#define	DRCN_MAX_LIST		32
+
+#define	DRCN_REQUEST_WORDS(c)	((((c)->cmd & DRCN_CMD_MASK) == DRCN_WRITE_MASKED)     ? 4 :		\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_ANALOG_READ_LIST) ? (int)(c)->data :	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_UDP_STATE)        ? 1 : 0)
+#define	DRCN_REPLY_WORDS(c)	((((c)->cmd & DRCN_CMD_MASK) == DRCN_READ_ALL)         ? 2 :		\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_ANALOG_READ_LIST) ? (int)(c)->data :	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_SESSION)          ? 4 : 0)
+
+// Protocol 4 adds UDP alongside the TCP connection, for writes where the
+//	latest one is all that matters and for state the server broadcasts:
+//	DRCN_UDP_OPEN:		The reply data is a token for the client to put
+//				in its datagrams, or 0 if the server has no UDP.
+//	DRCN_UDP_STATE:		Send the levels of data pins (1-64, 0 to stop)
+//				from pin every payload word mS. The reply data
+//				is non-zero if the server hasn't had a datagram
+//				from the client yet to know where to send them.
+//	Every datagram starts with a drcNetUdpStruct, its sequence number
+//	one up on the last in that direction; one not newer than the last
+//	taken in is stale and dropped. From the client the rest is commands
+//	run as if sent with DRCN_NO_REPLY, only those DRCN_UDP_OK allows.
+//	From the server it is the reply to a DRCN_READ_ALL.
+
+#define	DRCN_UDP_MAX		1400	// Bytes in a datagram, to stay in one packet
+
+#define	DRCN_UDP_OK(c)		((((c)->cmd & DRCN_CMD_MASK) == DRCN_DIGITAL_WRITE)  ||	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_DIGITAL_WRITE8) ||	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_ANALOG_WRITE)   ||	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_PWM_WRITE)      ||	\
+				 (((c)->cmd & DRCN_CMD_MASK) == DRCN_WRITE_MASKED))
+
+// Protocol 5 adds DRCN_SESSION, whose reply is followed by a 4 word token
+//	the client can use to get back in on a later connection without the
+//	(slow) crypt of its password: it answers the challenge with
+//	DRCN_RESUME then the token as 32 hex digits, padded out with
+//	DRCN_RESUME to the 86 characters of a password response. A token is
+//	good for one use, within the hour, and lost if the server restarts.
+
+#define	DRCN_RESUME		'#'
 
 struct drcNetComStruct
 {
   uint32_t pin ;
   uint32_t cmd ;
   uint32_t data ;
-} comDat ;
+} ;
+
+struct drcNetUdpStruct
+{
+  uint32_t token ;
+  uint32_t seq ;
+} ;
+
+#define	DRCN_FRAME_LEN		((int)sizeof (struct drcNetComStruct))
 
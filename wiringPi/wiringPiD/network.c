@@ -26,6 +26,7 @@
 #include <arpa/inet.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <string.h>
 #include <stdarg.h>
@@ -34,6 +35,7 @@
 #include <fcntl.h>
 #include <crypt.h>
 
+#include "drcNetCmd.h"
 #include "network.h"
 
 #define	TRUE	(1==1)
@@ -41,11 +43,8 @@
 
 // Local data
 
-#define	SALT_LEN	16
-
-static char salt [SALT_LEN + 1] ;
-static char *returnedHash = NULL ;
 static int serverFd = -1 ;
+static socklen_t serverSockAddrSize ;
 
 // Union for the server Socket Address
 
@@ -138,7 +137,30 @@ int sendGreeting (int clientFd)
   if (clientPrintf (clientFd, "200 Welcome to wiringPiD - http://wiringpi.com/\n") < 0)
     return -1 ;
 
-  return clientPrintf (clientFd, "200 Connecting from: %s\n", getClientIP ()) ;
+  if (clientPrintf (clientFd, "200 Connecting from: %s\n", getClientIP ()) < 0)
+    return -1 ;
+
+  return clientPrintf (clientFd, "200 Protocol %d\n", DRCN_PROTOCOL) ;
+}
+
+
+/*
+ * getRandom:
+ *	Fill buf with len random bytes
+ *********************************************************************************
+ */
+
+int getRandom (void *buf, int len)
+{
+  int fd, ok ;
+
+  if ((fd = open ("/dev/urandom", O_RDONLY)) < 0)
+    return fd ;
+
+  ok = read (fd, buf, len) == len ;
+  close (fd) ;
+
+  return ok ? 0 : -1 ;
 }
 
 
@@ -155,16 +177,11 @@ static int getSalt (char drySalt [])
 				"0123456789/." ;
 
   unsigned char wetSalt [SALT_LEN] ;
-  int i, fd ;
+  int i ;
 
-  if ((fd = open ("/dev/urandom", O_RDONLY)) < 0)
-    return fd ;
-
-  if (read (fd, wetSalt, SALT_LEN) != SALT_LEN)
+  if (getRandom (wetSalt, SALT_LEN) < 0)
     return -1 ;
 
-  close (fd) ;
-
   for (i = 0 ; i < SALT_LEN ; ++i)
     drySalt [i] = seaDog [wetSalt [i] & 63] ;
     
@@ -176,11 +193,12 @@ static int getSalt (char drySalt [])
 
 /*
  * sendChallenge:
- *	Create and send our salt (aka nonce) to the remote device
+ *	Create and send our salt (aka nonce) to the remote device, keeping
+ *	it in salt [] (SALT_LEN + 1 chars) to check the response against.
  *********************************************************************************
  */
 
-int sendChallenge (int clientFd)
+int sendChallenge (int clientFd, char *salt)
 {
   if (getSalt (salt) < 0)
     return -1 ;
@@ -189,48 +207,14 @@ int sendChallenge (int clientFd)
 }
 
 
-/*
- * getResponse:
- *	Read the encrypted password from the remote device.
- *********************************************************************************
- */
-
-
-int getResponse (int clientFd)
-{
-  char reply [1024] ;
-  int len ;
-
-// Being sort of lazy about this. I'm expecting an SHA-512 hash back and these
-//	are exactly 86 characters long, so no reason not to, I guess...
-
-  len = 86 ;
-
-  if (setsockopt (clientFd, SOL_SOCKET, SO_RCVLOWAT, (void *)&len, sizeof (len)) < 0)
-    return -1 ;
-
-  len = recv (clientFd, reply, 86, 0) ;
-  if (len != 86)
-    return -1 ;
-
-  reply [len] = 0 ;
-
-  if ((returnedHash = malloc (len + 1)) == NULL)
-    return -1 ;
-
-  strcpy (returnedHash, reply) ;
-
-  return 0 ;
-}
-
-
 /*
  * passwordMatch:
  *	See if there's a match. If not, we simply dump them.
+ *	The response is the 86 character hash the client sent back for salt.
  *********************************************************************************
  */
 
-int passwordMatch (const char *password)
+int passwordMatch (const char *password, const char *salt, const char *response)
 {
   char *encrypted ;
   char salted [1024] ;
@@ -242,25 +226,21 @@ int passwordMatch (const char *password)
 // 20: $6$ then 16 characters of salt, then $
 // 86 is the length of an SHA-512 hash
 
-  return strncmp (encrypted + 20, returnedHash, 86) == 0 ;
+  return strncmp (encrypted + 20, response, 86) == 0 ;
 }
 
 
 /* 
  * setupServer:
  *	Do what's needed to create a local server socket instance that can listen
- *	on both IPv4 and IPv6 interfaces.
+ *	on both IPv4 and IPv6 interfaces. Returns the listening socket.
  *********************************************************************************
  */
 
 int setupServer (int serverPort)
 {
-  socklen_t clientSockAddrSize = sizeof (clientSockAddr) ;
-
   int on = 1 ;
   int family ;
-  socklen_t serverSockAddrSize ;
-  int clientFd ;
 
 // Try to create an IPv6 socket
 
@@ -302,18 +282,54 @@ int setupServer (int serverPort)
       serverSockAddr.sin6.sin6_port   = htons (serverPort) ;
   }
 
-// Bind, listen and accept
+// Bind and listen
 
   if (bind (serverFd, (struct sockaddr *)&serverSockAddr, serverSockAddrSize) < 0)
     return -1 ;
 
-  if (listen (serverFd, 4) < 0)	// Really only going to talk to one client at a time...
+  if (listen (serverFd, SOMAXCONN) < 0)
+    return -1 ;
+
+  return serverFd ;
+}
+
+
+/*
+ * acceptClient:
+ *	Take the next connection off the server socket. getClientIP () then
+ *	gives its address until the next one is accepted.
+ *********************************************************************************
+ */
+
+int acceptClient (void)
+{
+  socklen_t clientSockAddrSize = sizeof (clientSockAddr) ;
+
+  return accept (serverFd, (struct sockaddr *)&clientSockAddr, &clientSockAddrSize) ;
+}
+
+
+/*
+ * setupUdp:
+ *	Create a datagram socket on the same address and port as the server
+ *	socket set up by setupServer. Returns the socket.
+ *********************************************************************************
+ */
+
+int setupUdp (void)
+{
+  int fd ;
+
+  if ((fd = socket (serverSockAddr.sin.sin_family, SOCK_DGRAM, 0)) < 0)
     return -1 ;
 
-  if ((clientFd = accept (serverFd, (struct sockaddr *)&clientSockAddr, &clientSockAddrSize)) < 0)
+  if (bind (fd, (struct sockaddr *)&serverSockAddr, serverSockAddrSize) < 0)
+  {
+    close (fd) ;
     return -1 ;
+  }
 
-  return clientFd ;
+  return fd ;
 }
 
 
@@ -322,9 +338,8 @@ int setupServer (int serverPort)
  *********************************************************************************
  */
 
-void closeServer (int clientFd)
+void closeServer (void)
 {
   if (serverFd != -1) close (serverFd) ;
-  if (clientFd != -1) close (clientFd) ;
-  serverFd = clientFd = -1 ;
+  serverFd = -1 ;
 }
@@ -21,11 +21,16 @@
  ***********************************************************************
  */
 
+// Length of the password salt sent in the challenge
+
+#define	SALT_LEN	16
+
 extern char *getClientIP   (void) ;
-extern int   getResponce   (int clientFd) ;
 extern int   setupServer   (int serverPort) ;
+extern int   acceptClient  (void) ;
+extern int   setupUdp      (void) ;
+extern int   getRandom     (void *buf, int len) ;
 extern int   sendGreeting  (int clientFd) ;
-extern int   sendChallenge (int clientFd) ;
-extern int   getResponse   (int clientFd) ;
-extern int   passwordMatch (const char *password) ;
-extern void  closeServer   (int clientFd) ;
+extern int   sendChallenge (int clientFd, char *salt) ;
+extern int   passwordMatch (const char *password, const char *salt, const char *response) ;
+extern void  closeServer   (void) ;
@@ -22,6 +22,8 @@
  ***********************************************************************
  */
 
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,84 +45,167 @@
 int noLocalPins = FALSE ;
 
 
-void runRemoteCommands (int fd)
+/*
+ * localOK:
+ *	We're allowed to touch the pin - not one of ours when running with -z
+ *********************************************************************************
+ */
+
+static int localOK (uint32_t pin)
+{
+  return !(noLocalPins && ((pin & PI_GPIO_MASK) == 0)) ;
+}
+
+
+/*
+ * writeMasked:
+ * readAll:
+ *	The bulk digital commands. Whole bytes of pins go through the port
+ *	calls, so a node driver can do them in one transfer.
+ *********************************************************************************
+ */
+
+static void writeMasked (uint32_t pin, uint64_t mask, uint64_t value)
+{
+  int i, bit ;
+
+  for (i = 0 ; i < 64 ; i += 8)
+  {
+    if (((mask >> i) & 0xFF) == 0xFF && localOK (pin + i) && localOK (pin + i + 7))
+      digitalWrite8 (pin + i, (value >> i) & 0xFF) ;
+    else
+      for (bit = i ; bit < i + 8 ; ++bit)
+	if (((mask >> bit) & 1) && localOK (pin + bit))
+	  digitalWrite (pin + bit, (value >> bit) & 1) ;
+  }
+}
+
+static uint64_t readAll (uint32_t pin, int num)
+{
+  uint64_t bits = 0 ;
+  int i, bit, width ;
+
+  for (i = 0 ; i < num ; i += 32)
+  {
+    width = (num - i > 32) ? 32 : num - i ;
+
+    if (localOK (pin + i) && localOK (pin + i + width - 1))
+      bits |= (uint64_t)(digitalRead32 (pin + i) & (0xFFFFFFFFU >> (32 - width))) << i ;
+    else
+      for (bit = i ; bit < i + width ; ++bit)
+	if (localOK (pin + bit) && (digitalRead (pin + bit) != LOW))
+	  bits |= 1ULL << bit ;
+  }
+
+  return bits ;
+}
+
+
+/*
+ * runCommand:
+ *	Run the command at the start of in [], which has len bytes in it, and
+ *	add its reply, if it wants one, to out []. Everything but commands
+ *	sent with DRCN_NO_REPLY gets one, the frame with any result in its
+ *	data, then any payload. The sequence number in the top of cmd is
+ *	left alone so the reply carries it back.
+ *	Returns the bytes the command took up, 0 if it's not all here yet,
+ *	or -1 if it makes no sense.
+ *********************************************************************************
+ */
+
+int runCommand (const char *in, int len, char *out, int *outLen)
 {
-  register uint32_t pin ;
-  int len ;
   struct drcNetComStruct cmd ;
+  uint32_t payload [DRCN_MAX_LIST] ;
+  uint64_t bits ;
+  int words, replyWords, i ;
+
+  if (len < DRCN_FRAME_LEN)
+    return 0 ;
+
+  memcpy (&cmd, in, DRCN_FRAME_LEN) ;
 
-  len = sizeof (struct drcNetComStruct) ;
+  words = DRCN_REQUEST_WORDS (&cmd) ;
+  if ((words < 0) || (words > DRCN_MAX_LIST))
+    return -1 ;
 
-  if (setsockopt (fd, SOL_SOCKET, SO_RCVLOWAT, (void *)&len, sizeof (len)) < 0)
-    return ;
+  if (len < DRCN_FRAME_LEN + words * 4)
+    return 0 ;
+
+  memcpy (payload, in + DRCN_FRAME_LEN, words * 4) ;
+
+  switch (cmd.cmd & DRCN_CMD_MASK)
+  {
+    case DRCN_PIN_MODE:
+      if (localOK (cmd.pin))
+	pinMode (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_PULL_UP_DN:
+      if (localOK (cmd.pin))
+	pullUpDnControl (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_PWM_WRITE:
+      if (localOK (cmd.pin))
+	pwmWrite (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_DIGITAL_WRITE:
+      if (localOK (cmd.pin))
+	digitalWrite (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_DIGITAL_WRITE8:
+      if (localOK (cmd.pin))
+	digitalWrite8 (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_DIGITAL_READ:
+      if (localOK (cmd.pin))
+	cmd.data = digitalRead (cmd.pin) ;
+      break ;
+
+    case DRCN_DIGITAL_READ8:
+      if (localOK (cmd.pin))
+	cmd.data = digitalRead8 (cmd.pin) ;
+      break ;
+
+    case DRCN_ANALOG_WRITE:
+      if (localOK (cmd.pin))
+	analogWrite (cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_ANALOG_READ:
+      if (localOK (cmd.pin))
+	cmd.data = analogRead (cmd.pin) ;
+      break ;
+
+    case DRCN_WRITE_MASKED:
+      writeMasked (cmd.pin, payload [0] | ((uint64_t)payload [1] << 32), payload [2] | ((uint64_t)payload [3] << 32)) ;
+      break ;
+
+    case DRCN_READ_ALL:
+      if ((cmd.data < 1) || (cmd.data > 64))
+	return -1 ;
+      bits = readAll (cmd.pin, cmd.data) ;
+      payload [0] = (uint32_t)bits ;
+      payload [1] = (uint32_t)(bits >> 32) ;
+      break ;
+
+    case DRCN_ANALOG_READ_LIST:
+      for (i = 0 ; i < words ; ++i)
+	payload [i] = localOK (payload [i]) ? (uint32_t)analogRead (payload [i]) : 0 ;
+      break ;
+  }
 
-  for (;;)
+  if ((cmd.cmd & DRCN_NO_REPLY) == 0)
   {
-    if (recv (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))	// Probably remote hangup
-      return ;
-
-    pin = cmd.pin ;
-    if (noLocalPins && ((pin & PI_GPIO_MASK) == 0))
-    {
-      if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	return ;
-      continue ;
-    }
-
-    switch (cmd.cmd)
-    {
-      case DRCN_PIN_MODE:
-	pinMode (pin, cmd.data) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_PULL_UP_DN:
-	pullUpDnControl (pin, cmd.data) ;
-	break ;
-
-      case DRCN_PWM_WRITE:
-	pwmWrite (pin, cmd.data) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_DIGITAL_WRITE:
-	digitalWrite (pin, cmd.data) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_DIGITAL_WRITE8:
-	//digitalWrite8 (pin, cmd.data) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_DIGITAL_READ:
-	cmd.data = digitalRead (pin) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_DIGITAL_READ8:
-	//cmd.data = digitalRead8 (pin) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_ANALOG_WRITE:
-	analogWrite (pin, cmd.data) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-
-      case DRCN_ANALOG_READ:
-	cmd.data = analogRead (pin) ;
-	if (send (fd, &cmd, sizeof (cmd), 0) != sizeof (cmd))
-	  return ;
-	break ;
-    }
+    replyWords = DRCN_REPLY_WORDS (&cmd) ;
+    memcpy (out + *outLen, &cmd, DRCN_FRAME_LEN) ;
+    memcpy (out + *outLen + DRCN_FRAME_LEN, payload, replyWords * 4) ;
+    *outLen += DRCN_FRAME_LEN + replyWords * 4 ;
   }
 
+  return DRCN_FRAME_LEN + words * 4 ;
 }
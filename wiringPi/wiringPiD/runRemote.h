@@ -26,4 +26,4 @@
 
 extern int noLocalPins ;
 
-extern void runRemoteCommands (int fd) ;
+extern int runCommand (const char *in, int len, char *out, int *outLen) ;
@@ -0,0 +1,1194 @@
+/*
+ * server.c:
+ *	Serve any number of clients from the one epoll loop.
+ *	Every client socket is non-blocking and has its own little state
+ *	machine: waiting for the response to its challenge, waiting for
+ *	that to be checked, then running commands. The check (crypt, which
+ *	takes a good while on the smaller Pis) is done on a thread of its
+ *	own so nobody else waits on it. Each time round the loop a client gets at most one recv
+ *	worth of commands (MAX_BATCH frames) run before the next client,
+ *	so a busy client can't starve the others, and its replies are
+ *	held back rather than blocking the loop if it's slow to read them.
+ *	Datagrams for all the clients come in on the one UDP socket, told
+ *	apart by the token each client was given over its TCP connection.
+ *
+ *	Copyright (c) 2012-2017 Gordon Henderson
+ ***********************************************************************
+ * This file is part of wiringPi:
+ *	https://projects.drogon.net/raspberry-pi/wiringpi/
+ *
+ *    wiringPi is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU Lesser General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    wiringPi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public License
+ *    along with wiringPi.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************
+ */
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <wiringPi.h>
+
+#include "drcNetCmd.h"
+#include "network.h"
+#include "runRemote.h"
+#include "server.h"
+
+// Frames run per client each time round the loop
+
+#define	MAX_BATCH	64
+
+// 86 characters is the length of the SHA-512 hash in the response
+
+#define	RESPONSE_LEN	86
+
+#define	MAX_EVENTS	64
+
+// Datagrams taken in each time round the loop
+
+#define	MAX_DATAGRAMS	64
+
+// mS a client has to answer the challenge in, and the most that can be
+//	waiting for their password to be checked at once
+
+#define	AUTH_TIME	5000
+#define	MAX_CHECKS	16
+
+// Session tokens kept, and the secs each is good for
+
+#define	MAX_SESSIONS	256
+#define	SESSION_TIME	3600
+
+// Pins a client can subscribe to, and pins with edges being watched
+
+#define	MAX_SUBS	64
+
+// Client states
+
+#define	CLIENT_AUTH	0
+#define	CLIENT_CHECK	1
+#define	CLIENT_RUN	2
+
+struct clientStruct
+{
+  int    fd ;
+  int    state ;
+  int    watching ;			// What epoll waits for on it, -1 not yet added
+  char   ipAddress [128] ;
+  socklen_t peerAddrLen ;		// Its TCP end, datagrams have to come from there
+  struct sockaddr_storage peerAddr ;
+  char   salt [SALT_LEN + 1] ;
+  time_t connected ;
+  unsigned long long id ;		// Ties a password check to the client
+  unsigned long long authDue ;		// mS, drop it if still in CLIENT_AUTH
+
+  int    inLen ;			// Bytes in in []
+  int    outLen, outSent ;		// Bytes in out [] and sent so far
+  char   in  [MAX_BATCH * DRCN_FRAME_LEN] ;
+  char   out [MAX_BATCH * DRCN_FRAME_LEN * 3] ;	// Replies + events
+
+  int    numSubs ;
+  struct { int pin, mode ; } subs [MAX_SUBS] ;
+
+// UDP: the token in its datagrams, where the last one came from, and the
+//	state broadcast it has asked for
+
+  uint32_t  udpToken ;
+  uint32_t  udpSeqIn, udpSeqOut ;
+  socklen_t udpAddrLen ;		// 0 until we've had a datagram
+  struct sockaddr_storage udpAddr ;
+  int       statePin, stateCount ;
+  unsigned int statePeriod ;		// mS
+  unsigned long long stateDue ;
+
+  unsigned long long commands, replies, bytesIn, bytesOut, events, eventsLost ;
+  unsigned long long datagramsIn, datagramsStale, datagramsForeign, datagramsOut ;
+
+  struct clientStruct *next ;
+} ;
+
+static struct clientStruct *clients = NULL ;
+static int numClients = 0 ;
+static int epollFd    = -1 ;
+static int udpFd      = -1 ;
+
+static volatile sig_atomic_t statsWanted = FALSE ;
+
+// Edges come from the interrupt threads through a pipe
+
+struct edgeStruct
+{
+  int                pin ;
+  int                level ;
+  unsigned long long timestamp ;
+} ;
+
+static struct
+{
+  uint32_t token [4] ;
+  time_t   expires ;
+} sessions [MAX_SESSIONS] ;
+
+// Password checks go to the checker thread and come back through pipes
+
+struct checkStruct
+{
+  unsigned long long id ;
+  char               salt [SALT_LEN + 1] ;
+  char               response [RESPONSE_LEN] ;
+  int                ok ;
+} ;
+
+static int checkPipe  [2] = { -1, -1 } ;
+static int resultPipe [2] = { -1, -1 } ;
+static int numChecks  = 0 ;
+static unsigned long long lastId = 0 ;
+
+static int edgePipe [2] = { -1, -1 } ;
+static int edgePins [MAX_SUBS] ;
+static int numEdgePins  = 0 ;
+static unsigned int edgesLost = 0 ;
+
+
+/*
+ * serverStatsSignal:
+ *	Ask for the statistics of all connected clients to be logged. Safe to
+ *	call from a signal handler.
+ *********************************************************************************
+ */
+
+void serverStatsSignal (void)
+{
+  statsWanted = TRUE ;
+}
+
+
+/*
+ * nowMs:
+ *	Monotonic mS for the state broadcasts and login timeouts
+ *********************************************************************************
+ */
+
+static unsigned long long nowMs (void)
+{
+  struct timespec ts ;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts) ;
+
+  return (unsigned long long)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000L ;
+}
+
+
+/*
+ * logStats:
+ *********************************************************************************
+ */
+
+static void logStats (struct clientStruct *client, const char *what)
+{
+  logMsg ("%s %s: %d secs, %llu commands, %llu replies, %llu events (%llu lost), %llu bytes in, %llu bytes out, "
+	"%llu datagrams in (%llu stale, %llu foreign), %llu out", what,
+	client->ipAddress, (int)(time (NULL) - client->connected),
+	client->commands, client->replies, client->events, client->eventsLost, client->bytesIn, client->bytesOut,
+	client->datagramsIn, client->datagramsStale, client->datagramsForeign, client->datagramsOut) ;
+}
+
+
+/*
+ * watchClient:
+ *	Set what we wait for on the client: more commands, or room to send
+ *	the replies still held back for it. We don't take in any more
+ *	from a client until it has had all its replies, or while its
+ *	password is being checked.
+ *********************************************************************************
+ */
+
+static int watchClient (struct clientStruct *client)
+{
+  struct epoll_event event ;
+  int op = (client->watching < 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD ;
+
+  /**/ if (client->state == CLIENT_CHECK)	// Nothing more until it's in
+    event.events = 0 ;
+  else if (client->outLen > client->outSent)
+    event.events = EPOLLOUT ;
+  else
+    event.events = EPOLLIN ;
+  event.data.ptr = client ;
+
+  if (event.events == (uint32_t)client->watching)
+    return 0 ;
+
+  client->watching = event.events ;
+
+  return epoll_ctl (epollFd, op, client->fd, &event) ;
+}
+
+
+/*
+ * dropClient:
+ *********************************************************************************
+ */
+
+static void dropClient (struct clientStruct *client, const char *why)
+{
+  struct clientStruct **p ;
+
+  logStats (client, why) ;
+
+  for (p = &clients ; *p != NULL ; p = &(*p)->next)
+    if (*p == client)
+    {
+      *p = client->next ;
+      break ;
+    }
+
+  (void)epoll_ctl (epollFd, EPOLL_CTL_DEL, client->fd, NULL) ;
+  close (client->fd) ;
+  free (client) ;
+  --numClients ;
+}
+
+
+/*
+ * newClient:
+ *	Accept a new connection, greet and challenge it. The socket buffer is
+ *	empty at this point so these go out without blocking.
+ *********************************************************************************
+ */
+
+static void newClient (void)
+{
+  struct clientStruct *client ;
+  int fd, on = 1 ;
+
+  if ((fd = acceptClient ()) < 0)
+    return ;
+
+  if ((client = (struct clientStruct *)calloc (1, sizeof (*client))) == NULL)
+  {
+    logMsg ("Out of memory - dropping new connection from %s", getClientIP ()) ;
+    close (fd) ;
+    return ;
+  }
+
+  client->fd        = fd ;
+  client->state     = CLIENT_AUTH ;
+  client->watching  = -1 ;
+  client->connected = time (NULL) ;
+  client->id        = ++lastId ;
+  client->authDue   = nowMs () + AUTH_TIME ;
+  strncpy (client->ipAddress, getClientIP (), sizeof (client->ipAddress) - 1) ;
+
+  client->peerAddrLen = sizeof (client->peerAddr) ;
+  if (getpeername (fd, (struct sockaddr *)&client->peerAddr, &client->peerAddrLen) < 0)
+    client->peerAddrLen = 0 ;
+
+  if ((sendGreeting (fd) < 0) || (sendChallenge (fd, client->salt) < 0))
+  {
+    logMsg ("Unable to send greeting to %s: %s", client->ipAddress, strerror (errno)) ;
+    close (fd) ;
+    free (client) ;
+    return ;
+  }
+
+  (void)setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof (on)) ;
+  (void)fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK) ;
+
+  if (watchClient (client) < 0)
+  {
+    logMsg ("Unable to watch %s: %s", client->ipAddress, strerror (errno)) ;
+    close (fd) ;
+    free (client) ;
+    return ;
+  }
+
+  client->next = clients ;
+  clients      = client ;
+  ++numClients ;
+
+  logMsg ("New connection from: %s (%d clients)", client->ipAddress, numClients) ;
+}
+
+
+/*
+ * sendReplies:
+ *	Send as much of the held back replies as the client will take.
+ *	Returns FALSE if it has gone away.
+ *********************************************************************************
+ */
+
+static int sendReplies (struct clientStruct *client)
+{
+  int len ;
+
+  while (client->outSent < client->outLen)
+  {
+    len = send (client->fd, client->out + client->outSent, client->outLen - client->outSent, MSG_NOSIGNAL) ;
+    if (len < 0)
+      return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) ;
+    client->outSent  += len ;
+    client->bytesOut += len ;
+  }
+
+  client->outLen = client->outSent = 0 ;
+  return TRUE ;
+}
+
+
+/*
+ * edgeISR:
+ *	Interrupt callback for every pin anyone has subscribed to. Runs in the
+ *	pin's interrupt thread and just hands the edge over to the loop.
+ *********************************************************************************
+ */
+
+static void edgeISR (int pin, int level, unsigned long long timestamp, UNU void *userdata)
+{
+  struct edgeStruct edge ;
+
+  edge.pin       = pin ;
+  edge.level     = level ;
+  edge.timestamp = timestamp ;
+
+  if (write (edgePipe [1], &edge, sizeof (edge)) != sizeof (edge))
+    __atomic_add_fetch (&edgesLost, 1, __ATOMIC_RELAXED) ;
+}
+
+
+/*
+ * subscribe:
+ *	Start (or stop, with mode 0) pushing the edges of a pin to the client.
+ *	The pin's interrupt is set up on the first subscription to it and
+ *	left running, catching both edges; the mode is applied per client.
+ *	Returns 0, or -1 if the pin can't do it.
+ *********************************************************************************
+ */
+
+static int subscribe (struct clientStruct *client, int pin, int mode)
+{
+  struct wiringPiNodeStruct *node ;
+  int i ;
+
+  for (i = 0 ; i < client->numSubs ; ++i)
+    if (client->subs [i].pin == pin)
+      break ;
+
+  if (mode == 0)
+  {
+    if (i < client->numSubs)
+      client->subs [i] = client->subs [--client->numSubs] ;
+    return 0 ;
+  }
+
+  if ((mode < INT_EDGE_FALLING) || (mode > INT_EDGE_BOTH))
+    return -1 ;
+
+  if (i == client->numSubs)
+  {
+    if (client->numSubs == MAX_SUBS)
+      return -1 ;
+
+    if (pin < 64)
+    {
+      if (noLocalPins || (pin < 0))
+	return -1 ;
+    }
+    else if (((node = wiringPiFindNode (pin)) == NULL) || (node->isrMode == NULL))
+      return -1 ;
+
+    for (i = 0 ; i < numEdgePins ; ++i)
+      if (edgePins [i] == pin)
+	break ;
+
+    if (i == numEdgePins)
+    {
+      if ((numEdgePins == MAX_SUBS) || (wiringPiISRArg (pin, INT_EDGE_BOTH, edgeISR, NULL) < 0))
+	return -1 ;
+      edgePins [numEdgePins++] = pin ;
+    }
+
+    i = client->numSubs++ ;
+    client->subs [i].pin = pin ;
+  }
+
+  client->subs [i].mode = mode ;
+  return 0 ;
+}
+
+
+/*
+ * pushEdges:
+ *	Send the edges waiting in the pipe to the clients subscribed to them.
+ *	A client with no room left for them, because it's not reading what
+ *	we send, loses them. One that has gone away is left for epoll to
+ *	tell us about.
+ *********************************************************************************
+ */
+
+static void pushEdges (void)
+{
+  struct edgeStruct edges [MAX_BATCH] ;
+  struct drcNetComStruct event ;
+  struct clientStruct *client ;
+  int len, num, i, j, mode ;
+
+  if ((len = read (edgePipe [0], edges, sizeof (edges))) <= 0)
+    return ;
+
+  num = len / sizeof (struct edgeStruct) ;
+
+  for (client = clients ; client != NULL ; client = client->next)
+  {
+    if ((client->state != CLIENT_RUN) || (client->numSubs == 0))
+      continue ;
+
+    for (i = 0 ; i < num ; ++i)
+      for (j = 0 ; j < client->numSubs ; ++j)
+      {
+	if (client->subs [j].pin != edges [i].pin)
+	  continue ;
+
+	mode = client->subs [j].mode ;
+	if ((mode == INT_EDGE_RISING) && (edges [i].level != HIGH))
+	  break ;
+	if ((mode == INT_EDGE_FALLING) && (edges [i].level != LOW))
+	  break ;
+
+	if (client->outLen + DRCN_FRAME_LEN > (int)sizeof (client->out))
+	{
+	  ++client->eventsLost ;
+	  break ;
+	}
+
+	event.pin  = edges [i].pin ;
+	event.cmd  = DRCN_EVENT | ((edges [i].timestamp >> 32) << DRCN_SEQ_SHIFT) | ((edges [i].level != LOW) ? DRCN_EVENT_HIGH : 0) ;
+	event.data = (uint32_t)edges [i].timestamp ;
+
+	memcpy (client->out + client->outLen, &event, DRCN_FRAME_LEN) ;
+	client->outLen += DRCN_FRAME_LEN ;
+	++client->events ;
+	break ;
+      }
+
+    if (sendReplies (client))
+      (void)watchClient (client) ;
+  }
+}
+
+
+/*
+ * udpOpen:
+ *	Give the client a token for its datagrams. Returns 0 if we have no
+ *	UDP socket.
+ *********************************************************************************
+ */
+
+static uint32_t udpOpen (struct clientStruct *client)
+{
+  if (udpFd < 0)
+    return 0 ;
+
+  while (client->udpToken == 0)
+    if (getRandom (&client->udpToken, sizeof (client->udpToken)) < 0)
+      return 0 ;
+
+  return client->udpToken ;
+}
+
+
+/*
+ * udpState:
+ *	Start (or stop, with count 0) broadcasting the levels of count pins
+ *	from pin to the client every period mS. Returns 0, or -1 if we don't
+ *	know where to send them yet or it makes no sense.
+ *********************************************************************************
+ */
+
+static int udpState (struct clientStruct *client, int pin, int count, unsigned int period)
+{
+  if (count == 0)
+  {
+    client->stateCount = 0 ;
+    return 0 ;
+  }
+
+  if ((client->udpAddrLen == 0) || (count < 0) || (count > 64) || (period == 0))
+    return -1 ;
+
+  client->statePin    = pin ;
+  client->stateCount  = count ;
+  client->statePeriod = period ;
+  client->stateDue    = nowMs () ;
+
+  return 0 ;
+}
+
+
+/*
+ * sendStates:
+ *	Send the state broadcasts that are due - each the reply to a
+ *	DRCN_READ_ALL for the pins. Returns the mS to wait until the next
+ *	is due, or -1 if there are none.
+ *********************************************************************************
+ */
+
+static int sendStates (void)
+{
+  struct clientStruct *client ;
+  struct drcNetUdpStruct header ;
+  struct drcNetComStruct cmd ;
+  char buf [sizeof (header) + DRCN_FRAME_LEN + 8] ;
+  unsigned long long now = nowMs () ;
+  int len, wait = -1 ;
+
+  for (client = clients ; client != NULL ; client = client->next)
+  {
+    if (client->stateCount == 0)
+      continue ;
+
+    if (client->stateDue <= now)
+    {
+      header.token = client->udpToken ;
+      header.seq   = ++client->udpSeqOut ;
+      memcpy (buf, &header, sizeof (header)) ;
+
+      cmd.pin  = client->statePin ;
+      cmd.cmd  = DRCN_READ_ALL ;
+      cmd.data = client->stateCount ;
+      len      = sizeof (header) ;
+      (void)runCommand ((char *)&cmd, DRCN_FRAME_LEN, buf, &len) ;
+
+      if (sendto (udpFd, buf, len, 0, (struct sockaddr *)&client->udpAddr, client->udpAddrLen) == len)
+	++client->datagramsOut ;
+
+      client->stateDue += client->statePeriod ;
+      if (client->stateDue <= now)		// Fallen behind, don't try to catch up
+	client->stateDue = now + client->statePeriod ;
+    }
+
+    if ((wait < 0) || ((int)(client->stateDue - now) < wait))
+      wait = (int)(client->stateDue - now) ;
+  }
+
+  return wait ;
+}
+
+
+/*
+ * sameHost:
+ *	See if a datagram came from the host at the client's end of its TCP
+ *	connection. Both sockets are bound the same way so the addresses are
+ *	in the same form. Any port will do, NAT may give UDP its own.
+ *********************************************************************************
+ */
+
+static int sameHost (struct clientStruct *client, struct sockaddr_storage *addr)
+{
+  if ((client->peerAddrLen == 0) || (addr->ss_family != client->peerAddr.ss_family))
+    return FALSE ;
+
+  if (addr->ss_family == AF_INET)
+    return memcmp (&((struct sockaddr_in *)addr)->sin_addr,
+		   &((struct sockaddr_in *)&client->peerAddr)->sin_addr, sizeof (struct in_addr)) == 0 ;
+
+  if (addr->ss_family == AF_INET6)
+    return memcmp (&((struct sockaddr_in6 *)addr)->sin6_addr,
+		   &((struct sockaddr_in6 *)&client->peerAddr)->sin6_addr, sizeof (struct in6_addr)) == 0 ;
+
+  return FALSE ;
+}
+
+
+/*
+ * readDatagrams:
+ *	Take in the datagrams waiting on the UDP socket and run the commands
+ *	in them. One from no client we know of, from a host other than the
+ *	client's, or not newer than the last from its client, is dropped, as
+ *	is anything after a command that isn't allowed over UDP. Replies and
+ *	state go back to where the newest one came from.
+ *********************************************************************************
+ */
+
+static void readDatagrams (void)
+{
+  struct clientStruct *client ;
+  struct drcNetUdpStruct header ;
+  struct drcNetComStruct cmd ;
+  struct sockaddr_storage addr ;
+  socklen_t addrLen ;
+  char buf [DRCN_UDP_MAX], out [DRCN_UDP_MAX * 2] ;
+  int len, used, n, outLen, i ;
+
+  for (i = 0 ; i < MAX_DATAGRAMS ; ++i)
+  {
+    addrLen = sizeof (addr) ;
+    if ((len = recvfrom (udpFd, buf, sizeof (buf), 0, (struct sockaddr *)&addr, &addrLen)) < 0)
+      return ;
+
+    if (len < (int)sizeof (header))
+      continue ;
+
+    memcpy (&header, buf, sizeof (header)) ;
+
+    for (client = clients ; client != NULL ; client = client->next)
+      if ((client->udpToken != 0) && (client->udpToken == header.token))
+	break ;
+
+    if (client == NULL)
+      continue ;
+
+    ++client->datagramsIn ;
+
+    if (!sameHost (client, &addr))
+    {
+      ++client->datagramsForeign ;
+      continue ;
+    }
+
+    if ((int32_t)(header.seq - client->udpSeqIn) <= 0)
+    {
+      ++client->datagramsStale ;
+      continue ;
+    }
+
+    client->udpSeqIn   = header.seq ;
+    client->udpAddrLen = addrLen ;
+    memcpy (&client->udpAddr, &addr, addrLen) ;
+
+    for (used = sizeof (header) ; len - used >= DRCN_FRAME_LEN ; used += n)
+    {
+      memcpy (&cmd, buf + used, DRCN_FRAME_LEN) ;
+      if (!DRCN_UDP_OK (&cmd))
+	break ;
+
+      outLen = 0 ;
+      if ((n = runCommand (buf + used, len - used, out, &outLen)) <= 0)
+	break ;
+      ++client->commands ;
+    }
+  }
+}
+
+
+/*
+ * newSession:
+ *	Make a session token for the client to get back in with, in the
+ *	slot of an expired one, or the oldest.
+ *	Returns 0, or -1 if it can't.
+ *********************************************************************************
+ */
+
+static int newSession (uint32_t token [4])
+{
+  time_t now = time (NULL) ;
+  int i, slot = 0 ;
+
+  for (i = 0 ; i < MAX_SESSIONS ; ++i)
+  {
+    if (sessions [i].expires < now)
+    {
+      slot = i ;
+      break ;
+    }
+    if (sessions [i].expires < sessions [slot].expires)
+      slot = i ;
+  }
+
+  do
+    if (getRandom (token, 16) < 0)
+      return -1 ;
+  while ((token [0] | token [1] | token [2] | token [3]) == 0) ;
+
+  memcpy (sessions [slot].token, token, 16) ;
+  sessions [slot].expires = now + SESSION_TIME ;
+
+  return 0 ;
+}
+
+
+/*
+ * resumeSession:
+ *	See if the response to the challenge (starting DRCN_RESUME) is a
+ *	session token we gave out, using it up if so.
+ *********************************************************************************
+ */
+
+static int resumeSession (const char *response)
+{
+  uint32_t token [4] ;
+  char hex [33] ;
+  time_t now = time (NULL) ;
+  int i ;
+
+  memcpy (hex, response + 1, 32) ;
+  hex [32] = 0 ;
+
+  if (sscanf (hex, "%8x%8x%8x%8x", &token [0], &token [1], &token [2], &token [3]) != 4)
+    return FALSE ;
+
+  for (i = 0 ; i < MAX_SESSIONS ; ++i)
+    if ((sessions [i].expires >= now) && (memcmp (sessions [i].token, token, 16) == 0))
+    {
+      sessions [i].expires = 0 ;
+      return TRUE ;
+    }
+
+  return FALSE ;
+}
+
+
+/*
+ * serverCommand:
+ *	Run one of the commands that are about the client rather than the
+ *	pins, adding its reply to out []. Returns as runCommand.
+ *********************************************************************************
+ */
+
+static int serverCommand (struct clientStruct *client, const char *in, int len)
+{
+  struct drcNetComStruct cmd ;
+  uint32_t period, token [4] ;
+  int words ;
+
+  memcpy (&cmd, in, DRCN_FRAME_LEN) ;
+  memset (token, 0, sizeof (token)) ;
+
+  words = DRCN_REQUEST_WORDS (&cmd) ;
+  if (len < DRCN_FRAME_LEN + words * 4)
+    return 0 ;
+
+  switch (cmd.cmd & DRCN_CMD_MASK)
+  {
+    case DRCN_SUBSCRIBE:
+      cmd.data = subscribe (client, cmd.pin, cmd.data) ;
+      break ;
+
+    case DRCN_UDP_OPEN:
+      cmd.data = udpOpen (client) ;
+      break ;
+
+    case DRCN_UDP_STATE:
+      memcpy (&period, in + DRCN_FRAME_LEN, 4) ;
+      cmd.data = udpState (client, cmd.pin, cmd.data, period) ;
+      break ;
+
+    case DRCN_SESSION:
+      cmd.data = newSession (token) ;
+      break ;
+  }
+
+  if ((cmd.cmd & DRCN_NO_REPLY) == 0)
+  {
+    memcpy (client->out + client->outLen, &cmd, DRCN_FRAME_LEN) ;
+    client->outLen += DRCN_FRAME_LEN ;
+    if ((cmd.cmd & DRCN_CMD_MASK) == DRCN_SESSION)
+    {
+      memcpy (client->out + client->outLen, token, sizeof (token)) ;
+      client->outLen += sizeof (token) ;
+    }
+  }
+
+  return DRCN_FRAME_LEN + words * 4 ;
+}
+
+
+/*
+ * checker:
+ *	Thread checking passwords, one at a time, so the crypt in it holds
+ *	up nobody but the clients queued behind.
+ *********************************************************************************
+ */
+
+static void *checker (void *arg)
+{
+  const char *password = (const char *)arg ;
+  struct checkStruct check ;
+
+  while (read (checkPipe [0], &check, sizeof (check)) == sizeof (check))
+  {
+    check.ok = passwordMatch (password, check.salt, check.response) ;
+    if (write (resultPipe [1], &check, sizeof (check)) != sizeof (check))
+      break ;
+  }
+
+  return NULL ;
+}
+
+
+/*
+ * startCheck:
+ *	Hand the client's response to the checker. Returns FALSE if there
+ *	are too many waiting already.
+ *********************************************************************************
+ */
+
+static int startCheck (struct clientStruct *client)
+{
+  struct checkStruct check ;
+
+  if (numChecks == MAX_CHECKS)
+    return FALSE ;
+
+  memset (&check, 0, sizeof (check)) ;
+  check.id = client->id ;
+  memcpy (check.salt,     client->salt, sizeof (check.salt)) ;
+  memcpy (check.response, client->in,   RESPONSE_LEN) ;
+
+// Smaller than PIPE_BUF, so it goes in whole, and there's room for
+//	MAX_CHECKS of them
+
+  if (write (checkPipe [1], &check, sizeof (check)) != sizeof (check))
+    return FALSE ;
+
+  ++numChecks ;
+  client->state = CLIENT_CHECK ;
+
+  return TRUE ;
+}
+
+
+/*
+ * dropSlowClients:
+ *	Drop the clients that haven't answered the challenge in time.
+ *	Returns the mS until the next one is due to, or -1 if none are
+ *	waiting.
+ *********************************************************************************
+ */
+
+static int dropSlowClients (void)
+{
+  struct clientStruct *client, *next ;
+  unsigned long long now = nowMs () ;
+  int wait = -1 ;
+
+  for (client = clients ; client != NULL ; client = next)
+  {
+    next = client->next ;
+
+    if (client->state != CLIENT_AUTH)
+      continue ;
+
+    if (client->authDue <= now)
+      dropClient (client, "No login from") ;
+    else if ((wait < 0) || ((int)(client->authDue - now) < wait))
+      wait = (int)(client->authDue - now) ;
+  }
+
+  return wait ;
+}
+
+
+/*
+ * runCommands:
+ *	Run the whole commands the client has sent, keeping any partial one
+ *	for next time, and send what replies it will take.
+ *	Returns FALSE if the client is to be dropped.
+ *********************************************************************************
+ */
+
+static int runCommands (struct clientStruct *client)
+{
+  struct drcNetComStruct cmd ;
+  int len, used, outLen ;
+
+// A reply is never more than 7/3 the size of its command, so they all
+//	fit in out [], which is empty when we get here.
+
+  for (used = 0 ; client->inLen - used >= DRCN_FRAME_LEN ; used += len)
+  {
+    memcpy (&cmd, client->in + used, DRCN_FRAME_LEN) ;
+    outLen = client->outLen ;
+
+    switch (cmd.cmd & DRCN_CMD_MASK)
+    {
+      case DRCN_SUBSCRIBE:
+      case DRCN_UDP_OPEN:
+      case DRCN_UDP_STATE:
+      case DRCN_SESSION:
+	len = serverCommand (client, client->in + used, client->inLen - used) ;
+	break ;
+
+      default:
+	len = runCommand (client->in + used, client->inLen - used, client->out, &client->outLen) ;
+	break ;
+    }
+
+    if (len == 0)
+      break ;
+    else if (len < 0)
+    {
+      logMsg ("Bad command %d from %s", cmd.cmd & DRCN_CMD_MASK, client->ipAddress) ;
+      return FALSE ;
+    }
+
+    ++client->commands ;
+    if (client->outLen != outLen)
+      ++client->replies ;
+  }
+
+  client->inLen -= used ;
+  memmove (client->in, client->in + used, client->inLen) ;
+
+  return sendReplies (client) ;
+}
+
+
+/*
+ * readClient:
+ *	Take in one recv worth from the client and act on it.
+ *	Returns FALSE if the client is to be dropped.
+ *********************************************************************************
+ */
+
+static int readClient (struct clientStruct *client)
+{
+  int len ;
+
+// Not until the client has taken everything we've sent it
+
+  if (client->outSent < client->outLen)
+    return TRUE ;
+
+  len = recv (client->fd, client->in + client->inLen, sizeof (client->in) - client->inLen, 0) ;
+  if (len == 0)
+    return FALSE ;
+  if (len < 0)
+    return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) ;
+
+  client->inLen   += len ;
+  client->bytesIn += len ;
+
+  if (client->state == CLIENT_AUTH)
+  {
+    if (client->inLen < RESPONSE_LEN)
+      return TRUE ;
+
+// A session token is quick to check, no need to pass it on. One we
+//	don't know is turned away here, the client comes back with its
+//	password.
+
+    if (client->in [0] != DRCN_RESUME)
+    {
+      if (!startCheck (client))
+      {
+	logMsg ("Too many logins waiting - dropping %s", client->ipAddress) ;
+	return FALSE ;
+      }
+      return TRUE ;
+    }
+
+    if (!resumeSession (client->in))
+    {
+      logMsg ("Unknown or used session from %s - it has to use the password", client->ipAddress) ;
+      return FALSE ;
+    }
+
+    logMsg ("Session resumed from %s - Starting", client->ipAddress) ;
+    client->state  = CLIENT_RUN ;
+    client->inLen -= RESPONSE_LEN ;
+    memmove (client->in, client->in + RESPONSE_LEN, client->inLen) ;
+  }
+
+  return runCommands (client) ;
+}
+
+
+/*
+ * checkDone:
+ *	Take in the results from the checker: start the clients that got
+ *	their password right and drop the rest. The client may have gone
+ *	away in the meantime.
+ *********************************************************************************
+ */
+
+static void checkDone (void)
+{
+  struct checkStruct check ;
+  struct clientStruct *client ;
+
+  while (read (resultPipe [0], &check, sizeof (check)) == sizeof (check))
+  {
+    --numChecks ;
+
+    for (client = clients ; client != NULL ; client = client->next)
+      if (client->id == check.id)
+	break ;
+
+    if ((client == NULL) || (client->state != CLIENT_CHECK))
+      continue ;
+
+    if (!check.ok)
+    {
+      logMsg ("Password failure from %s", client->ipAddress) ;
+      dropClient (client, "Closed") ;
+      continue ;
+    }
+
+    logMsg ("Password OK from %s - Starting", client->ipAddress) ;
+    client->state  = CLIENT_RUN ;
+    client->inLen -= RESPONSE_LEN ;
+    memmove (client->in, client->in + RESPONSE_LEN, client->inLen) ;
+
+    if (!runCommands (client) || (watchClient (client) < 0))
+      dropClient (client, "Closed") ;
+  }
+}
+
+
+/*
+ * runServer:
+ *	Listen on the port and serve clients until something goes badly wrong.
+ *********************************************************************************
+ */
+
+int runServer (int port, const char *password)
+{
+  struct epoll_event events [MAX_EVENTS], event ;
+  struct clientStruct *client ;
+  pthread_t thread ;
+  int serverFd, num, i, ok, wait, authWait, checked ;
+
+  if ((serverFd = setupServer (port)) < 0)
+    return -1 ;
+
+  if ((epollFd = epoll_create1 (EPOLL_CLOEXEC)) < 0)
+    return -1 ;
+
+  event.events   = EPOLLIN ;
+  event.data.ptr = NULL ;		// The server socket
+
+  if (epoll_ctl (epollFd, EPOLL_CTL_ADD, serverFd, &event) < 0)
+    return -1 ;
+
+  if (pipe (edgePipe) < 0)
+    return -1 ;
+
+  for (i = 0 ; i < 2 ; ++i)
+    (void)fcntl (edgePipe [i], F_SETFL, fcntl (edgePipe [i], F_GETFL) | O_NONBLOCK) ;
+
+  event.events   = EPOLLIN ;
+  event.data.ptr = edgePipe ;
+
+  if (epoll_ctl (epollFd, EPOLL_CTL_ADD, edgePipe [0], &event) < 0)
+    return -1 ;
+
+  if ((pipe (checkPipe) < 0) || (pipe (resultPipe) < 0))
+    return -1 ;
+
+  (void)fcntl (resultPipe [0], F_SETFL, fcntl (resultPipe [0], F_GETFL) | O_NONBLOCK) ;
+
+  event.events   = EPOLLIN ;
+  event.data.ptr = resultPipe ;
+
+  if (epoll_ctl (epollFd, EPOLL_CTL_ADD, resultPipe [0], &event) < 0)
+    return -1 ;
+
+  if (pthread_create (&thread, NULL, checker, (void *)password) != 0)
+    return -1 ;
+  pthread_detach (thread) ;
+
+// UDP is an extra, carry on without it if need be
+
+  if ((udpFd = setupUdp ()) < 0)
+    logMsg ("Unable to set up UDP on port %d: %s", port, strerror (errno)) ;
+  else
+  {
+    (void)fcntl (udpFd, F_SETFL, fcntl (udpFd, F_GETFL) | O_NONBLOCK) ;
+
+    event.events   = EPOLLIN ;
+    event.data.ptr = &udpFd ;
+
+    if (epoll_ctl (epollFd, EPOLL_CTL_ADD, udpFd, &event) < 0)
+      return -1 ;
+  }
+
+  for (;;)
+  {
+    if (statsWanted)
+    {
+      statsWanted = FALSE ;
+      logMsg ("%d clients, %u edges lost", numClients, __atomic_load_n (&edgesLost, __ATOMIC_RELAXED)) ;
+      for (client = clients ; client != NULL ; client = client->next)
+	logStats (client, "Client") ;
+    }
+
+    wait     = sendStates () ;
+    authWait = dropSlowClients () ;
+    if ((wait < 0) || ((authWait >= 0) && (authWait < wait)))
+      wait = authWait ;
+
+    if ((num = epoll_wait (epollFd, events, MAX_EVENTS, wait)) < 0)
+    {
+      if (errno == EINTR)
+	continue ;
+      return -1 ;
+    }
+
+    checked = FALSE ;
+    for (i = 0 ; i < num ; ++i)
+    {
+      if (events [i].data.ptr == NULL)
+      {
+	newClient () ;
+	continue ;
+      }
+
+      if (events [i].data.ptr == edgePipe)
+      {
+	pushEdges () ;
+	continue ;
+      }
+
+      if (events [i].data.ptr == &udpFd)
+      {
+	readDatagrams () ;
+	continue ;
+      }
+
+      if (events [i].data.ptr == resultPipe)	// After the rest, it can drop clients they're for
+      {
+	checked = TRUE ;
+	continue ;
+      }
+
+      client = (struct clientStruct *)events [i].data.ptr ;
+
+      if ((events [i].events & (EPOLLHUP | EPOLLERR)) != 0)
+	ok = FALSE ;
+      else if ((events [i].events & EPOLLOUT) != 0)
+	ok = sendReplies (client) ;
+      else
+	ok = readClient (client) ;
+
+      if (ok)
+	ok = watchClient (client) == 0 ;
+
+      if (!ok)
+	dropClient (client, "Closed") ;
+    }
+
+    if (checked)
+      checkDone () ;
+  }
+}
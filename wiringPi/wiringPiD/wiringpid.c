@@ -38,6 +38,7 @@
 #include "network.h"
 #include "runRemote.h"
 #include "daemonise.h"
+#include "server.h"
 
 
 #define	PIDFILE	"/var/run/wiringPiD.pid"
@@ -50,7 +51,7 @@ static int doDaemon = FALSE ;
 
 //
 
-static void logMsg (const char *message, ...)
+void logMsg (const char *message, ...)
 {
   va_list argp ;
   char buffer [1024] ;
@@ -68,9 +69,11 @@ static void logMsg (const char *message, ...)
 
 /*
  * sigHandler:
+ * statsHandler:
  * setupSigHandler:
  *      Somehing has happened that would normally terminate the program so try
  *	to close down nicely.
+ *	SIGUSR1 logs the statistics of every connected client.
  *********************************************************************************
  */
 
@@ -81,6 +84,11 @@ void sigHandler (int sig)
   exit (EXIT_FAILURE) ;
 }
 
+static void statsHandler (UNU int sig)
+{
+  serverStatsSignal () ;
+}
+
 void setupSigHandler (void)
 {
   struct sigaction action ;
@@ -95,6 +103,11 @@ void setupSigHandler (void)
   sigaction (SIGHUP,  &action, NULL) ;
   sigaction (SIGTTIN, &action, NULL) ;
   sigaction (SIGTTOU, &action, NULL) ;
+  sigaction (SIGPIPE, &action, NULL) ;	// A client went away
+
+  action.sa_handler = statsHandler ;
+
+  sigaction (SIGUSR1, &action, NULL) ;
 
 // Trap what we can to exit gracefully
 
@@ -106,10 +119,8 @@ void setupSigHandler (void)
   sigaction (SIGABRT, &action, NULL) ;
   sigaction (SIGFPE,  &action, NULL) ;
   sigaction (SIGSEGV, &action, NULL) ;
-  sigaction (SIGPIPE, &action, NULL) ;
   sigaction (SIGALRM, &action, NULL) ;
   sigaction (SIGTERM, &action, NULL) ;
-  sigaction (SIGUSR1, &action, NULL) ;
   sigaction (SIGUSR2, &action, NULL) ;
   sigaction (SIGCHLD, &action, NULL) ;
   sigaction (SIGTSTP, &action, NULL) ;
@@ -124,7 +135,6 @@ void setupSigHandler (void)
 
 int main (int argc, char *argv [])
 {
-  int clientFd ;
   char *p, *password ;
   int i ;
   int port = DEFAULT_SERVER_PORT ;
@@ -319,63 +329,14 @@ int main (int argc, char *argv [])
 
   setupSigHandler () ;
  
-// Enter our big loop
-
-  for (;;)
-  {
-
-    if (!doDaemon)
-      printf ("-=-\nWaiting for a new connection...\n") ;
-
-    if ((clientFd = setupServer (port)) < 0)
-    {
-      logMsg ("Unable to setup server: %s", strerror (errno)) ;
-      exit (EXIT_FAILURE) ;
-    }
-
-    logMsg ("New connection from: %s.", getClientIP ()) ;
-
-    if (!doDaemon)
-      printf ("Sending Greeting.\n") ;
-
-    if (sendGreeting (clientFd) < 0)
-    {
-      logMsg ("Unable to send greeting message: %s", strerror (errno)) ;
-      closeServer (clientFd) ;
-      continue ;
-    }
-
-    if (!doDaemon)
-      printf ("Sending Challenge.\n") ;
-
-    if (sendChallenge (clientFd) < 0)
-    {
-      logMsg ("Unable to send challenge message: %s", strerror (errno)) ;
-      closeServer (clientFd) ;
-      continue ;
-    }
-
-    if (!doDaemon)
-      printf ("Waiting for response.\n") ;
-
-    if (getResponse (clientFd) < 0)
-    {
-      logMsg ("Connection closed waiting for response: %s", strerror (errno)) ;
-      closeServer (clientFd) ;
-      continue ;
-    }
+// Serve clients until something goes badly wrong
 
-    if (!passwordMatch (password))
-    {
-      logMsg ("Password failure") ;
-      closeServer (clientFd) ;
-      continue ;
-    }
-
-    logMsg ("Password OK - Starting") ;
+  logMsg ("Listening on port %d", port) ;
 
-    runRemoteCommands (clientFd) ;
-    closeServer       (clientFd) ;
+  if (runServer (port, password) < 0)
+  {
+    logMsg ("Server failed: %s", strerror (errno)) ;
+    exit (EXIT_FAILURE) ;
   }
 
   return 0 ;